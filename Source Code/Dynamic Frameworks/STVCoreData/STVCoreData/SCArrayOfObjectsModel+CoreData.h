@@ -71,4 +71,28 @@
  */
 - (instancetype)initWithTableView:(UITableView *)tableView entityDefinition:(SCEntityDefinition *)definition filterPredicate:(NSPredicate *)predicate;
 
+/** Allocates and returns an initialized 'SCArrayOfObjectsModel' whose objects are fetched using an NSFetchedResultsController. The model is then updated row by row as the managed object context changes.
+ *
+ *	@param tableView The UITableView to be bound to the model.
+ *	@param definition The entity definition of the objects.
+ *	@param perdicate The predicate that will be used to filter the fetched objects.
+ *	@param sectionNameKeyPath The key path used to group the objects into sections. Set to nil to generate a single section.
+ *	@param fetchBatchSize The number of objects Core Data loads at a time as rows get displayed. Set to 0 to load all objects at once.
+ *
+ *  @see [SCCoreDataFetchOptions usesFetchedResultsController]
+ */
++ (instancetype)modelWithTableView:(UITableView *)tableView entityDefinition:(SCEntityDefinition *)definition filterPredicate:(NSPredicate *)predicate sectionNameKeyPath:(NSString *)sectionNameKeyPath fetchBatchSize:(NSUInteger)fetchBatchSize;
+
+/** Returns an initialized 'SCArrayOfObjectsModel' whose objects are fetched using an NSFetchedResultsController. The model is then updated row by row as the managed object context changes.
+ *
+ *	@param tableView The UITableView to be bound to the model.
+ *	@param definition The entity definition of the objects.
+ *	@param perdicate The predicate that will be used to filter the fetched objects.
+ *	@param sectionNameKeyPath The key path used to group the objects into sections. Set to nil to generate a single section.
+ *	@param fetchBatchSize The number of objects Core Data loads at a time as rows get displayed. Set to 0 to load all objects at once.
+ *
+ *  @see [SCCoreDataFetchOptions usesFetchedResultsController]
+ */
+- (instancetype)initWithTableView:(UITableView *)tableView entityDefinition:(SCEntityDefinition *)definition filterPredicate:(NSPredicate *)predicate sectionNameKeyPath:(NSString *)sectionNameKeyPath fetchBatchSize:(NSUInteger)fetchBatchSize;
+
 @end
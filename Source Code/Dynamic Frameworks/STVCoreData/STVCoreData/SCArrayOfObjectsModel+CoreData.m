@@ -24,6 +24,7 @@
 #import "SCArrayOfObjectsModel+CoreData.h"
 
 #import "SCCoreDataStore.h"
+#import "SCCoreDataFetchOptions.h"
 
 
 @implementation SCArrayOfObjectsModel (STVCoreData)
@@ -38,6 +39,11 @@
     return [[[self class] alloc] initWithTableView:tableView entityDefinition:definition filterPredicate:predicate];
 }
 
++ (instancetype)modelWithTableView:(UITableView *)tableView entityDefinition:(SCEntityDefinition *)definition filterPredicate:(NSPredicate *)predicate sectionNameKeyPath:(NSString *)sectionNameKeyPath fetchBatchSize:(NSUInteger)fetchBatchSize
+{
+    return [[[self class] alloc] initWithTableView:tableView entityDefinition:definition filterPredicate:predicate sectionNameKeyPath:sectionNameKeyPath fetchBatchSize:fetchBatchSize];
+}
+
 
 - (instancetype)initWithTableView:(UITableView *)tableView entityDefinition:(SCEntityDefinition *)definition
 {
@@ -61,4 +67,51 @@
     return self;
 }
 
+- (instancetype)initWithTableView:(UITableView *)tableView entityDefinition:(SCEntityDefinition *)definition filterPredicate:(NSPredicate *)predicate sectionNameKeyPath:(NSString *)sectionNameKeyPath fetchBatchSize:(NSUInteger)fetchBatchSize
+{
+    self = [self initWithTableView:tableView entityDefinition:definition filterPredicate:predicate];
+    if(self)
+    {
+        if([self.dataFetchOptions isKindOfClass:[SCCoreDataFetchOptions class]])
+        {
+            SCCoreDataFetchOptions *coreDataFetchOptions = (SCCoreDataFetchOptions *)self.dataFetchOptions;
+            coreDataFetchOptions.usesFetchedResultsController = TRUE;
+            coreDataFetchOptions.sectionNameKeyPath = sectionNameKeyPath;
+            coreDataFetchOptions.fetchBatchSize = fetchBatchSize;
+            coreDataFetchOptions.batchSize = 0;
+        }
+        
+        if(sectionNameKeyPath && !self.modelActions.sectionHeaderTitleForItem)
+        {
+            // map the fetched results sections to the model's sections
+            self.modelActions.sectionHeaderTitleForItem = ^NSString*(SCArrayOfItemsModel *itemsModel, NSObject *item, NSUInteger itemIndex)
+            {
+                NSFetchedResultsController *controller = nil;
+                if([itemsModel.dataStore isKindOfClass:[SCCoreDataStore class]] && [itemsModel.dataFetchOptions isKindOfClass:[SCCoreDataFetchOptions class]])
+                    controller = [(SCCoreDataStore *)itemsModel.dataStore fetchedResultsControllerForFetchOptions:(SCCoreDataFetchOptions *)itemsModel.dataFetchOptions];
+                
+                // use the controller's section names, rather than reading the key path of every item
+                NSUInteger sectionStartIndex = 0;
+                for(id<NSFetchedResultsSectionInfo> sectionInfo in controller.sections)
+                {
+                    if(itemIndex < sectionStartIndex+sectionInfo.numberOfObjects)
+                    {
+                        // items being searched aren't at their fetched index
+                        if([controller.fetchedObjects objectAtIndex:itemIndex] == item)
+                            return sectionInfo.name ? sectionInfo.name : @"";
+                        break;
+                    }
+                    sectionStartIndex += sectionInfo.numberOfObjects;
+                }
+                
+                id sectionName = [item valueForKeyPath:sectionNameKeyPath];
+                
+                return sectionName ? [sectionName description] : @"";
+            };
+        }
+    }
+    
+    return self;
+}
+
 @end
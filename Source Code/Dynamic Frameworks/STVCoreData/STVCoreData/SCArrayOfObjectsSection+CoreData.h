@@ -70,4 +70,26 @@
  */
 - (instancetype)initWithHeaderTitle:(NSString *)sectionHeaderTitle entityDefinition:(SCEntityDefinition *)definition filterPredicate:(NSPredicate *)predicate;
 
+/** Allocates and returns an initialized 'SCArrayOfObjectsSection' whose objects are fetched using an NSFetchedResultsController. The section is then updated row by row as the managed object context changes.
+ *
+ *	@param sectionHeaderTitle A header title for the section.
+ *	@param definition The entity definition of the objects to fetch.
+ *	@param perdicate The predicate that will be used to filter the fetched objects.
+ *	@param fetchBatchSize The number of objects Core Data loads at a time as rows get displayed. Set to 0 to load all objects at once.
+ *
+ *  @see [SCCoreDataFetchOptions usesFetchedResultsController]
+ */
++ (instancetype)sectionWithHeaderTitle:(NSString *)sectionHeaderTitle entityDefinition:(SCEntityDefinition *)definition filterPredicate:(NSPredicate *)predicate fetchBatchSize:(NSUInteger)fetchBatchSize;
+
+/** Returns an initialized 'SCArrayOfObjectsSection' whose objects are fetched using an NSFetchedResultsController. The section is then updated row by row as the managed object context changes.
+ *
+ *	@param sectionHeaderTitle A header title for the section.
+ *	@param definition The entity definition of the objects to fetch.
+ *	@param perdicate The predicate that will be used to filter the fetched objects.
+ *	@param fetchBatchSize The number of objects Core Data loads at a time as rows get displayed. Set to 0 to load all objects at once.
+ *
+ *  @see [SCCoreDataFetchOptions usesFetchedResultsController]
+ */
+- (instancetype)initWithHeaderTitle:(NSString *)sectionHeaderTitle entityDefinition:(SCEntityDefinition *)definition filterPredicate:(NSPredicate *)predicate fetchBatchSize:(NSUInteger)fetchBatchSize;
+
 @end
@@ -24,6 +24,7 @@
 #import "SCArrayOfObjectsSection+CoreData.h"
 
 #import "SCCoreDataStore.h"
+#import "SCCoreDataFetchOptions.h"
 
 
 @implementation SCArrayOfObjectsSection (STVCoreData)
@@ -38,6 +39,11 @@
     return [[[self class] alloc] initWithHeaderTitle:sectionHeaderTitle entityDefinition:definition filterPredicate:predicate];
 }
 
++ (instancetype)sectionWithHeaderTitle:(NSString *)sectionHeaderTitle entityDefinition:(SCEntityDefinition *)definition filterPredicate:(NSPredicate *)predicate fetchBatchSize:(NSUInteger)fetchBatchSize
+{
+    return [[[self class] alloc] initWithHeaderTitle:sectionHeaderTitle entityDefinition:definition filterPredicate:predicate fetchBatchSize:fetchBatchSize];
+}
+
 
 - (instancetype)initWithHeaderTitle:(NSString *)sectionHeaderTitle entityDefinition:(SCEntityDefinition *)definition
 {
@@ -59,4 +65,19 @@
     return self;
 }
 
+- (instancetype)initWithHeaderTitle:(NSString *)sectionHeaderTitle entityDefinition:(SCEntityDefinition *)definition filterPredicate:(NSPredicate *)predicate fetchBatchSize:(NSUInteger)fetchBatchSize
+{
+    if( (self = [self initWithHeaderTitle:sectionHeaderTitle entityDefinition:definition filterPredicate:predicate]) )
+    {
+        if([self.dataFetchOptions isKindOfClass:[SCCoreDataFetchOptions class]])
+        {
+            SCCoreDataFetchOptions *coreDataFetchOptions = (SCCoreDataFetchOptions *)self.dataFetchOptions;
+            coreDataFetchOptions.usesFetchedResultsController = TRUE;
+            coreDataFetchOptions.fetchBatchSize = fetchBatchSize;
+            coreDataFetchOptions.batchSize = 0;
+        }
+    }
+    return self;
+}
+
 @end
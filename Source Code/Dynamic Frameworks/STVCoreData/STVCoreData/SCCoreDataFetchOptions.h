@@ -43,4 +43,16 @@
  */
 @property (nonatomic, copy) NSString *orderAttributeName;
 
+/** The fetch batch size of the underlying NSFetchRequest. When set, Core Data only loads the data of fetchBatchSize objects at a time, as they get accessed. Unlike batchSize, this does not page the fetched results. Default: 0 (no batching). */
+@property (nonatomic, readwrite) NSUInteger fetchBatchSize;
+
+/** When TRUE, objects are fetched using an NSFetchedResultsController owned by SCCoreDataStore. Sections and models using these fetch options are then kept up to date with row level inserts, deletes, moves and reloads every time the managed object context changes, instead of refetching all their objects. Default: FALSE.
+ 
+ @note Live results are not paged using batchSize, set fetchBatchSize instead to keep memory usage bounded for large result sets. Live fetching is not available for stores bound to a relationship set, in which case objects are fetched as usual.
+ */
+@property (nonatomic, readwrite) BOOL usesFetchedResultsController;
+
+/** The key path on the fetched objects used to group them into sections. The objects are first sorted by this key path. Only applicable when usesFetchedResultsController is TRUE. Default: nil. */
+@property (nonatomic, copy) NSString *sectionNameKeyPath;
+
 @end
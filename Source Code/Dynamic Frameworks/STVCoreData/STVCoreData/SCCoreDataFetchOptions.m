@@ -32,10 +32,25 @@
 	if( (self = [super init]) )
 	{
         _orderAttributeName = nil;
+        _fetchBatchSize = 0;
+        _usesFetchedResultsController = FALSE;
+        _sectionNameKeyPath = nil;
 	}
 	return self;
 }
 
+// overrides superclass
+- (id)copyWithZone:(NSZone *)zone
+{
+    SCCoreDataFetchOptions *copy = [super copyWithZone:zone];
+    copy.orderAttributeName = self.orderAttributeName;
+    copy.fetchBatchSize = self.fetchBatchSize;
+    copy.usesFetchedResultsController = self.usesFetchedResultsController;
+    copy.sectionNameKeyPath = self.sectionNameKeyPath;
+    
+    return copy;
+}
+
 
 
 - (NSArray *)sortDescriptors
@@ -51,6 +66,18 @@
         descriptors = [super sortDescriptors];
     }
     
+    // sections must be contiguous in the sorted objects
+    if(self.usesFetchedResultsController && self.sectionNameKeyPath)
+    {
+        NSSortDescriptor *firstDescriptor = [descriptors firstObject];
+        if(![firstDescriptor.key isEqualToString:self.sectionNameKeyPath])
+        {
+            NSMutableArray *sectionDescriptors = [NSMutableArray arrayWithObject:[NSSortDescriptor sortDescriptorWithKey:self.sectionNameKeyPath ascending:YES]];
+            [sectionDescriptors addObjectsFromArray:descriptors];
+            descriptors = sectionDescriptors;
+        }
+    }
+    
     return descriptors;
 }
 
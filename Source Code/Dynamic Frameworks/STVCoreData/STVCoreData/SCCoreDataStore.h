@@ -22,6 +22,7 @@
 
 
 #import "SCEntityDefinition.h"
+#import "SCCoreDataFetchOptions.h"
 #import <SensibleTableView/SCDataStore.h> 
 
 
@@ -87,4 +88,53 @@
 @property (nonatomic, readonly) BOOL boundSetOwnsStoreObjects;
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Committing Data
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** Returns a new main queue managed object context whose parent is a private queue "writer" context connected to the given coordinator. When the store's managedObjectContext is created this way, commitData writes to disk in the background. */
++ (NSManagedObjectContext *)mainQueueContextWithWriterContextForPersistentStoreCoordinator:(NSPersistentStoreCoordinator *)coordinator;
+
+/** The time interval during which successive commitData calls (e.g. resulting from rapid edits) are coalesced into a single save. Default: 0 (commitData saves immediately). */
+@property (nonatomic, readwrite) NSTimeInterval commitCoalescingInterval;
+
+/** Immediately saves managedObjectContext and all its parent contexts, and only returns once the changes have been written. The store calls this method when the application enters the background or terminates.
+ @return Returns TRUE if successful.
+ */
+- (BOOL)commitDataAndWait;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Relationship Prefetching
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** When TRUE, the relationships displayed by the store's entity definitions are loaded together with the fetched objects, instead of being faulted in one object at a time as their cells get displayed. Relationships are prefetched using the key paths returned by relationshipKeyPathsForPrefetchingWithEntityDefinition:. Default: TRUE. */
+@property (nonatomic, readwrite) BOOL prefetchesRelationships;
+
+/** Returns the relationship key paths that should be prefetched for the objects of the given entity definition. The default implementation derives them from the definition's titlePropertyName and descriptionPropertyName key paths (e.g. "department.name" yields "department"), as well as from the key paths and object selection relationships of its property definitions that exist in normal mode. Override to customize. */
+- (NSArray *)relationshipKeyPathsForPrefetchingWithEntityDefinition:(SCEntityDefinition *)entityDefinition;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Live Fetching
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** Returns the NSFetchedResultsController used to fetch the objects of the given fetch options, creating it if needed. The store acts as the controller's delegate and posts its changes in SCDataStoreDidChangeObjectsNotification, along with the controller's updated fetchedObjects. Returns nil if the store is bound to a relationship set.
+ 
+ @note Only applicable to fetch options with usesFetchedResultsController set to TRUE. The controller is released when the fetch options are deallocated.
+ */
+- (NSFetchedResultsController *)fetchedResultsControllerForFetchOptions:(SCCoreDataFetchOptions *)fetchOptions;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Background Fetching
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** Returns the progress of the asynchronous fetch currently running for the given fetch options, or nil if there is none. Its completedUnitCount is incremented every time the objects of one of the store's entities have been fetched. Cancelling the progress cancels the fetch.
+ 
+ When storeMode is set to SCStoreModeAsynchronous, asynchronousFetchObjectsWithOptions:success:failure:noConnection: executes its fetch requests on a private queue context, so that big fetches don't block the main thread. Only the ids of the fetched objects are handed back to the main thread, where they are turned into objects of managedObjectContext. The private context is connected directly to the persistent store coordinator, so the fetch never waits on the main queue. Since such a context only sees saved objects, the objects are fetched synchronously instead whenever managedObjectContext (or any of its parent contexts) has unsaved changes.
+ */
+- (NSProgress *)progressForAsynchronousFetchWithOptions:(SCDataFetchOptions *)fetchOptions;
+
+
 @end
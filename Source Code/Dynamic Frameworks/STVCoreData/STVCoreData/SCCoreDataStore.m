@@ -26,13 +26,148 @@
 #import "SCCoreDataFetchOptions.h"
 
 
+
+// Collects the changes reported by a fetched results controller (used internally by SCCoreDataStore)
+@interface SCFetchedResultsObserver : NSObject <NSFetchedResultsControllerDelegate>
+
+@property (nonatomic, weak) SCCoreDataStore *store;
+@property (nonatomic, weak) SCCoreDataFetchOptions *fetchOptions;
+@property (nonatomic, strong) NSFetchedResultsController *fetchedResultsController;
+@property (nonatomic, strong) NSMutableArray *insertedObjects;
+@property (nonatomic, strong) NSMutableArray *updatedObjects;
+@property (nonatomic, strong) NSMutableArray *deletedObjects;
+@property (nonatomic, strong) NSMutableArray *movedObjects;
+// The index paths of the removed (deleted or moved) objects before the change, and of the added (inserted or moved) objects after it
+@property (nonatomic, strong) NSMutableArray *removedIndexPaths;
+@property (nonatomic, strong) NSMutableArray *addedIndexPaths;
+@property (nonatomic, strong) NSArray *previousSectionCounts;
+
+// Returns the number of objects in each of the fetched results controller's sections
+- (NSArray *)sectionCounts;
+// Returns the indexes of the given index paths in the flat fetched objects array
+- (NSIndexSet *)indexesForIndexPaths:(NSArray *)indexPaths sectionCounts:(NSArray *)sectionCounts;
+
+@end
+
+
+
+// Keeps track of where the next page of a multiple entity fetch starts (used internally by SCCoreDataStore)
+@interface SCMultiEntityFetchCursor : NSObject
+
+// The number of objects returned by all the pages fetched so far
+@property (nonatomic, readwrite) NSUInteger fetchedCount;
+// Maps entity names to the number of their objects returned so far
+@property (nonatomic, strong) NSDictionary *entityOffsets;
+
+@end
+
+@implementation SCMultiEntityFetchCursor
+@end
+
+
+
 @interface SCCoreDataStore ()
 
 @property (nonatomic, strong, readwrite) NSMutableSet *boundSet;
 @property (nonatomic, strong, readwrite) NSMutableOrderedSet *boundOrderedSet;
 @property (nonatomic, readwrite) BOOL boundSetOwnsStoreObjects;
 
+// Maps fetch options to their SCFetchedResultsObserver
+@property (nonatomic, strong) NSMapTable *fetchedResultsObservers;
+
+// Maps fetch options to the NSProgress of their asynchronous fetch
+@property (nonatomic, strong) NSMapTable *asynchronousFetchProgresses;
+
+// Maps fetch options to the SCMultiEntityFetchCursor of their next page
+@property (nonatomic, strong) NSMapTable *multiEntityFetchCursors;
+
+// Maps entity names to the order value to assign to their next new object
+@property (nonatomic, strong) NSMutableDictionary *nextOrderValues;
+
+// TRUE when a coalesced commit has been scheduled
+@property (nonatomic, readwrite) BOOL commitScheduled;
+
 - (void)willSaveContext;
+- (void)contextObjectsDidChange:(NSNotification *)notification;
+- (void)fetchedResultsObserverDidChangeContent:(SCFetchedResultsObserver *)observer;
+
+@end
+
+
+
+@implementation SCFetchedResultsObserver
+
+- (void)controllerWillChangeContent:(NSFetchedResultsController *)controller
+{
+    self.insertedObjects = [NSMutableArray array];
+    self.updatedObjects = [NSMutableArray array];
+    self.deletedObjects = [NSMutableArray array];
+    self.movedObjects = [NSMutableArray array];
+    self.removedIndexPaths = [NSMutableArray array];
+    self.addedIndexPaths = [NSMutableArray array];
+    self.previousSectionCounts = [self sectionCounts];
+}
+
+- (void)controller:(NSFetchedResultsController *)controller didChangeObject:(id)anObject atIndexPath:(NSIndexPath *)indexPath forChangeType:(NSFetchedResultsChangeType)type newIndexPath:(NSIndexPath *)newIndexPath
+{
+    switch (type)
+    {
+        case NSFetchedResultsChangeInsert:
+            [self.insertedObjects addObject:anObject];
+            [self.addedIndexPaths addObject:newIndexPath];
+            break;
+        case NSFetchedResultsChangeDelete:
+            [self.deletedObjects addObject:anObject];
+            [self.removedIndexPaths addObject:indexPath];
+            break;
+        case NSFetchedResultsChangeMove:
+            // moves are also reported for updated objects that kept their position
+            if(![indexPath isEqual:newIndexPath])
+            {
+                [self.movedObjects addObject:anObject];
+                [self.removedIndexPaths addObject:indexPath];
+                [self.addedIndexPaths addObject:newIndexPath];
+            }
+            [self.updatedObjects addObject:anObject];
+            break;
+        case NSFetchedResultsChangeUpdate:
+            [self.updatedObjects addObject:anObject];
+            break;
+    }
+}
+
+- (void)controllerDidChangeContent:(NSFetchedResultsController *)controller
+{
+    [self.store fetchedResultsObserverDidChangeContent:self];
+}
+
+- (NSArray *)sectionCounts
+{
+    NSArray *sections = self.fetchedResultsController.sections;
+    NSMutableArray *sectionCounts = [NSMutableArray arrayWithCapacity:sections.count];
+    for(id<NSFetchedResultsSectionInfo> sectionInfo in sections)
+        [sectionCounts addObject:[NSNumber numberWithUnsignedInteger:sectionInfo.numberOfObjects]];
+    
+    return sectionCounts;
+}
+
+- (NSIndexSet *)indexesForIndexPaths:(NSArray *)indexPaths sectionCounts:(NSArray *)sectionCounts
+{
+    NSUInteger sectionStartIndexes[sectionCounts.count+1];
+    sectionStartIndexes[0] = 0;
+    for(NSUInteger i=0; i<sectionCounts.count; i++)
+        sectionStartIndexes[i+1] = sectionStartIndexes[i] + [[sectionCounts objectAtIndex:i] unsignedIntegerValue];
+    
+    NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
+    for(NSIndexPath *indexPath in indexPaths)
+    {
+        if(indexPath.section >= sectionCounts.count)
+            return nil;
+        [indexes addIndex:sectionStartIndexes[indexPath.section]+indexPath.row];
+    }
+    
+    return indexes;
+}
 
 @end
 
@@ -59,9 +194,21 @@
         _boundSet = nil;
         _boundOrderedSet = nil;
         _boundSetOwnsStoreObjects = FALSE;
+        _fetchedResultsObservers = [NSMapTable weakToStrongObjectsMapTable];
+        _asynchronousFetchProgresses = [NSMapTable weakToStrongObjectsMapTable];
+        _multiEntityFetchCursors = [NSMapTable weakToStrongObjectsMapTable];
+        _nextOrderValues = [NSMutableDictionary dictionary];
+        _prefetchesRelationships = TRUE;
         
         // Register with managed object notifications
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(willSaveContext) name:NSManagedObjectContextWillSaveNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(contextObjectsDidChange:) name:NSManagedObjectContextObjectsDidChangeNotification object:nil];
+        
+        // Make sure changes are on disk before the application gets suspended, instead of the asynchronous commitData registered by the superclass
+        [[NSNotificationCenter defaultCenter] removeObserver:self name:UIApplicationDidEnterBackgroundNotification object:nil];
+        [[NSNotificationCenter defaultCenter] removeObserver:self name:UIApplicationWillTerminateNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(commitDataAndWait) name:UIApplicationDidEnterBackgroundNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(commitDataAndWait) name:UIApplicationWillTerminateNotification object:nil];
 	}
 	return self;
 }
@@ -98,6 +245,99 @@
     [self forceDiscardAllUnaddedObjects];
 }
 
+// The difference between the orders of consecutive new objects
+- (NSInteger)orderIncrement
+{
+    if(self.orderingStrategy == SCOrderingStrategySparse)
+        return MAX(self.orderingGap, 2);
+    //else
+    return 1;
+}
+
+- (void)contextObjectsDidChange:(NSNotification *)notification
+{
+    if(notification.object!=self.managedObjectContext)
+        return;
+    
+    // covers changes made to the context outside the store, including merged saves of other contexts
+    [self invalidateSharedFetchResults];
+    
+    if(!self.nextOrderValues.count)
+        return;
+    
+    // keep the cached next order values above the order of any object inserted elsewhere
+    NSSet *insertedObjects = [notification.userInfo valueForKey:NSInsertedObjectsKey];
+    NSSet *updatedObjects = [notification.userInfo valueForKey:NSUpdatedObjectsKey];
+    for(NSSet *objects in [NSArray arrayWithObjects:(insertedObjects ? insertedObjects : [NSSet set]), (updatedObjects ? updatedObjects : [NSSet set]), nil])
+    {
+        for(NSManagedObject *object in objects)
+        {
+            NSNumber *nextOrder = [self.nextOrderValues valueForKey:object.entity.name];
+            if(!nextOrder)
+                continue;
+            
+            SCEntityDefinition *entityDefinition = (SCEntityDefinition *)[self definitionForObject:object];
+            if(![entityDefinition isKindOfClass:[SCEntityDefinition class]] || !entityDefinition.orderAttributeName)
+                continue;
+            NSNumber *order = [object valueForKey:entityDefinition.orderAttributeName];
+            if([order isKindOfClass:[NSNumber class]] && [order integerValue] >= [nextOrder integerValue])
+                [self.nextOrderValues setValue:[NSNumber numberWithInteger:[order integerValue]+[self orderIncrement]] forKey:object.entity.name];
+        }
+    }
+    
+    // deleting the last object lowers the next order value, which gets reseeded on the next insert
+    NSSet *deletedObjects = [notification.userInfo valueForKey:NSDeletedObjectsKey];
+    for(NSManagedObject *object in deletedObjects)
+    {
+        NSNumber *nextOrder = [self.nextOrderValues valueForKey:object.entity.name];
+        if(!nextOrder)
+            continue;
+        
+        SCEntityDefinition *entityDefinition = (SCEntityDefinition *)[self definitionForObject:object];
+        if(![entityDefinition isKindOfClass:[SCEntityDefinition class]] || !entityDefinition.orderAttributeName)
+            continue;
+        NSNumber *order = [object valueForKey:entityDefinition.orderAttributeName];
+        if([order isKindOfClass:[NSNumber class]] && [order integerValue]+[self orderIncrement] == [nextOrder integerValue])
+            [self.nextOrderValues removeObjectForKey:object.entity.name];
+    }
+}
+
+// Returns the order value of the entity's next new object. Only the first call per entity hits the persistent store.
+- (NSInteger)nextOrderForEntityDefinition:(SCEntityDefinition *)entityDefinition
+{
+    NSString *entityName = entityDefinition.entity.name;
+    NSNumber *nextOrder = [self.nextOrderValues valueForKey:entityName];
+    if(nextOrder)
+        return [nextOrder integerValue];
+    
+    NSString *orderAttributeName = entityDefinition.orderAttributeName;
+    NSInteger order = 0;
+    if(self.boundSet || self.boundOrderedSet)
+    {
+        // the bound relationship is already in memory
+        NSArray *objects = self.boundSet ? [self.boundSet allObjects] : [self.boundOrderedSet array];
+        NSNumber *maxOrder = [objects valueForKeyPath:[NSString stringWithFormat:@"@max.%@", orderAttributeName]];
+        if(maxOrder)
+            order = [maxOrder integerValue] + [self orderIncrement];
+    }
+    else
+    {
+        // a single row sorted fetch (unlike an @max expression fetch, it includes unsaved objects)
+        NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
+        [fetchRequest setEntity:entityDefinition.entity];
+        [fetchRequest setSortDescriptors:[NSArray arrayWithObject:[NSSortDescriptor sortDescriptorWithKey:orderAttributeName ascending:NO]]];
+        [fetchRequest setFetchLimit:1];
+        NSError *error = nil;
+        NSArray *lastObjects = [self.managedObjectContext executeFetchRequest:fetchRequest error:&error];
+        if(!lastObjects)
+            SCDebugLog(@"Warning: Unable to fetch the last order value of entity '%@': %@", entityName, error);
+        if(lastObjects.count)
+            order = [[[lastObjects objectAtIndex:0] valueForKey:orderAttributeName] integerValue] + [self orderIncrement];
+    }
+    
+    return order;
+}
+
 // overrides superclass
 - (NSObject *)createNewObjectWithDefinition:(SCDataDefinition *)definition
 {
@@ -111,17 +351,8 @@
         NSInteger order = NSNotFound;
         if(entityDefinition.orderAttributeName && [entityDefinition isValidPropertyName:entityDefinition.orderAttributeName])
         {
-            NSArray *objectsArray = [self fetchObjectsWithOptions:[self.defaultDataDefinition generateCompatibleDataFetchOptions]];
-            
-            if(objectsArray.count == 0) 
-            {
-                order = 0;
-            }
-            else
-            {
-                NSObject *lastObject = [objectsArray objectAtIndex:objectsArray.count-1];
-                order = [(NSNumber *)[lastObject valueForKey:entityDefinition.orderAttributeName] intValue] + 1;
-            }
+            order = [self nextOrderForEntityDefinition:entityDefinition];
+            [self.nextOrderValues setValue:[NSNumber numberWithInteger:order+[self orderIncrement]] forKey:entityDefinition.entity.name];
         }
         
         object = [NSEntityDescription insertNewObjectForEntityForName:entityDefinition.entity.name inManagedObjectContext:self.managedObjectContext];
@@ -179,11 +410,51 @@
     
     [_uninsertedObjects removeObjectIdenticalTo:object];
     
+    // the context only reports the insert once it processes its pending changes
+    [self invalidateSharedFetchResults];
+    
+    return TRUE;
+}
+
+// Moves the object between its new neighbors in subsetArray, only falling back to renumbering all objects when there's no gap left between them
+- (BOOL)changeSparseOrderForObject:(NSObject *)object toOrder:(NSUInteger)toOrder subsetArray:(NSArray *)subsetArray entityDefinition:(SCEntityDefinition *)entityDefinition
+{
+    NSMutableArray *orderedObjects = [NSMutableArray arrayWithArray:subsetArray];
+    NSUInteger fromOrder = [orderedObjects indexOfObjectIdenticalTo:object];
+    if(fromOrder == NSNotFound)
+        return FALSE;
+    [orderedObjects removeObjectAtIndex:fromOrder];
+    [orderedObjects insertObject:object atIndex:toOrder];
+    
+    if([self assignSparseOrderToObject:object inOrderedObjects:orderedObjects orderPropertyName:entityDefinition.orderAttributeName])
+        return TRUE;
+    
+    // No gap left: place the object after its new previous neighbor among all the store's objects (subsetArray could be filtered), then rebalance them
+    NSMutableArray *objectsArray = [NSMutableArray arrayWithArray:[self fetchObjectsWithOptions:[self.defaultDataDefinition generateCompatibleDataFetchOptions]]];
+    [objectsArray removeObjectIdenticalTo:object];
+    NSUInteger absoluteToOrder = 0;
+    if(toOrder > 0)
+    {
+        NSUInteger previousIndex = [objectsArray indexOfObjectIdenticalTo:[orderedObjects objectAtIndex:toOrder-1]];
+        absoluteToOrder = (previousIndex==NSNotFound) ? objectsArray.count : previousIndex+1;
+    }
+    else if(orderedObjects.count > 1)
+    {
+        NSUInteger nextIndex = [objectsArray indexOfObjectIdenticalTo:[orderedObjects objectAtIndex:1]];
+        absoluteToOrder = (nextIndex==NSNotFound) ? 0 : nextIndex;
+    }
+    [objectsArray insertObject:object atIndex:absoluteToOrder];
+    
+    [self rebalanceOrderOfObjects:objectsArray orderPropertyName:entityDefinition.orderAttributeName];
+    [self.nextOrderValues setValue:[NSNumber numberWithInteger:objectsArray.count*[self orderIncrement]] forKey:entityDefinition.entity.name];
+    
     return TRUE;
 }
 
 - (BOOL)changeOrderForObject:(NSObject *)object toOrder:(NSUInteger)toOrder subsetArray:(NSArray *)subsetArray
 {
+    [self invalidateSharedFetchResults];
+    
     if(self.boundOrderedSet)
     {
         NSInteger objectIndex = [self.boundOrderedSet indexOfObject:object];
@@ -210,6 +481,9 @@
     if(toObject == object)
         return TRUE;  // no need to change order
     
+    if(self.orderingStrategy == SCOrderingStrategySparse)
+        return [self changeSparseOrderForObject:object toOrder:toOrder subsetArray:subsetArray entityDefinition:entityDefinition];
+    
     NSInteger fromObjectOrderAttributeValue = [[object valueForKey:entityDefinition.orderAttributeName] integerValue];
     NSInteger toObjectOrderAttributeValue = [[toObject valueForKey:entityDefinition.orderAttributeName] integerValue];
     
@@ -296,138 +570,1168 @@
         [self.managedObjectContext deleteObject:(NSManagedObject *)object];
     }
     
+    [self invalidateSharedFetchResults];
+    
     return TRUE;
 }
 
-// overrides superclass
-- (NSArray *)fetchObjectsWithOptions:(SCDataFetchOptions *)fetchOptions
+// Returns the context at the root of the store context's parent chain, which is the one connected to the persistent store coordinator
+- (NSManagedObjectContext *)rootManagedObjectContext
 {
-    SCCoreDataFetchOptions *defaultFetchOptions = (SCCoreDataFetchOptions *)[self.defaultDataDefinition generateCompatibleDataFetchOptions];
+    NSManagedObjectContext *context = self.managedObjectContext;
+    while(context.parentContext)
+        context = context.parentContext;
     
-    SCCoreDataFetchOptions *coreDataFetchOptions;
-    if([fetchOptions isKindOfClass:[SCCoreDataFetchOptions class]])
+    return context;
+}
+
+// Returns TRUE if batch requests can be executed against all of the store's persistent stores
+- (BOOL)supportsBatchRequests
+{
+    NSPersistentStoreCoordinator *coordinator = [self rootManagedObjectContext].persistentStoreCoordinator;
+    if(!coordinator.persistentStores.count)
+        return FALSE;
+    
+    for(NSPersistentStore *persistentStore in coordinator.persistentStores)
     {
-        coreDataFetchOptions = (SCCoreDataFetchOptions *)fetchOptions;
-        
-        if(coreDataFetchOptions.sort && !coreDataFetchOptions.sortKey)
-            coreDataFetchOptions.sortKey = defaultFetchOptions.sortKey;
+        if(![persistentStore.type isEqualToString:NSSQLiteStoreType])
+            return FALSE;
     }
-    else
+    
+    return TRUE;
+}
+
+- (NSPersistentStoreResult *)executeBatchRequest:(NSPersistentStoreRequest *)request error:(NSError **)error
+{
+    NSManagedObjectContext *rootContext = [self rootManagedObjectContext];
+    
+    __block NSPersistentStoreResult *result = nil;
+    __block NSError *requestError = nil;
+    void (^executeBlock)(void) = ^
     {
-        coreDataFetchOptions = defaultFetchOptions;
-        if(fetchOptions.filterPredicate)
-            coreDataFetchOptions.filterPredicate = fetchOptions.filterPredicate;
-    }
+        result = [rootContext executeRequest:request error:&requestError];
+    };
     
-    NSPredicate *filterPredicate = nil;
-    if(coreDataFetchOptions.filter)
-        filterPredicate = coreDataFetchOptions.filterPredicate;
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+    if(rootContext.concurrencyType == NSConfinementConcurrencyType)
+        executeBlock();
+    else
+        [rootContext performBlockAndWait:executeBlock];
+#pragma clang diagnostic pop
     
-    NSArray *sortDescriptors = nil;
-    if(!self.boundOrderedSet)
-        sortDescriptors = [coreDataFetchOptions sortDescriptors];
+    if(error)
+        *error = requestError;
     
-    NSMutableArray *array = [NSMutableArray array];
-    if(self.boundSet || self.boundOrderedSet)
+    return result;
+}
+
+// Merges the changes that batch requests made directly in the persistent store into the store's context and its parents
+- (void)mergeBatchChanges:(NSDictionary *)changes
+{
+    NSMutableArray *contexts = [NSMutableArray array];
+    for(NSManagedObjectContext *context = self.managedObjectContext; context; context = context.parentContext)
+        [contexts addObject:context];
+    
+    [NSManagedObjectContext mergeChangesFromRemoteContextSave:changes intoContexts:contexts];
+    
+    // batch changes bypass the order cache bookkeeping
+    [self.nextOrderValues removeAllObjects];
+}
+
+// Returns TRUE if the store's context or any of its parents has changes to objects of the given objects' entities that haven't been saved to the persistent store yet
+- (BOOL)hasUnsavedChangesToEntitiesOfObjects:(NSArray *)objects
+{
+    NSMutableSet *entityNames = [NSMutableSet set];
+    for(NSManagedObject *object in objects)
     {
-        if(self.boundSet)
-            [array addObjectsFromArray:[self.boundSet allObjects]];
-        else
-            [array addObjectsFromArray:[self.boundOrderedSet array]];
-        if(filterPredicate)
-        {
-            @try 
-            {
-                [array filterUsingPredicate:filterPredicate];
-            }
-            @catch (NSException * e) 
-            {
-                SCDebugLog(@"Warning: Invalid filter predicate: %@.", filterPredicate);
-            }
-        }
-        if(sortDescriptors)
+        if([object isKindOfClass:[NSManagedObject class]])
+            [entityNames addObject:object.entity.name];
+    }
+    
+    for(NSManagedObjectContext *context = self.managedObjectContext; context; context = context.parentContext)
+    {
+        __block BOOL hasChanges = FALSE;
+        void (^checkBlock)(void) = ^
         {
-            @try 
-            {
-                [array sortUsingDescriptors:sortDescriptors];
-            }
-            @catch (NSException * e) 
+            if(![context hasChanges])
+                return;
+            
+            for(NSSet *changedObjects in [NSArray arrayWithObjects:context.insertedObjects, context.updatedObjects, context.deletedObjects, nil])
             {
-                SCDebugLog(@"Warning: Invalid sort key: %@ or orderAttribute:%@.", coreDataFetchOptions.sortKey, coreDataFetchOptions.orderAttributeName);
+                for(NSManagedObject *changedObject in changedObjects)
+                {
+                    if([entityNames containsObject:changedObject.entity.name])
+                    {
+                        hasChanges = TRUE;
+                        return;
+                    }
+                }
             }
-        }
+        };
+        
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+        if(context==self.managedObjectContext || context.concurrencyType==NSConfinementConcurrencyType)
+            checkBlock();
+        else
+            [context performBlockAndWait:checkBlock];
+#pragma clang diagnostic pop
+        
+        if(hasChanges)
+            return TRUE;
     }
-    else 
+    
+    return FALSE;
+}
+
+// Groups the object ids of the given objects by entity name. Objects that don't exist in the persistent store yet are added to unsavedObjects instead.
+- (NSDictionary *)persistedObjectIDsByEntityNameForObjects:(NSArray *)objects unsavedObjects:(NSMutableArray *)unsavedObjects
+{
+    NSMutableDictionary *objectIDsByEntityName = [NSMutableDictionary dictionary];
+    for(NSManagedObject *object in objects)
     {
-        NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
-        if(fetchOptions.batchSize)
+        if(![object isKindOfClass:[NSManagedObject class]] || [object.objectID isTemporaryID])
         {
-            [fetchRequest setFetchLimit:coreDataFetchOptions.batchSize];
-            [fetchRequest setFetchOffset:coreDataFetchOptions.batchCurrentOffset*coreDataFetchOptions.batchSize];
+            [unsavedObjects addObject:object];
+            continue;
         }
-        if(sortDescriptors)
-            [fetchRequest setSortDescriptors: sortDescriptors];
-        if(filterPredicate)
-            [fetchRequest setPredicate:filterPredicate];
-		
-        // fetch all entities in dataDefinitions
-        NSArray *allEntities = [_dataDefinitions allValues];
-        for(SCEntityDefinition *entityDefinition in allEntities)
+        
+        NSMutableArray *objectIDs = [objectIDsByEntityName objectForKey:object.entity.name];
+        if(!objectIDs)
         {
-            if(![entityDefinition isKindOfClass:[SCEntityDefinition class]])
-                continue;
-            
-            [fetchRequest setEntity:entityDefinition.entity];
-            [array addObjectsFromArray:[entityDefinition.managedObjectContext executeFetchRequest:fetchRequest error:NULL]];
+            objectIDs = [NSMutableArray array];
+            [objectIDsByEntityName setObject:objectIDs forKey:object.entity.name];
         }
-		
-		if(coreDataFetchOptions.batchSize)
-            [coreDataFetchOptions incrementBatchOffset];
+        [objectIDs addObject:object.objectID];
     }
     
-    return array;
+    return objectIDsByEntityName;
 }
 
 // overrides superclass
-- (NSObject *)valueForPropertyName:(NSString *)propertyName inObject:(NSObject *)object
+- (BOOL)updateObjects:(NSArray *)objects withPropertyValues:(NSDictionary *)propertyValues
 {
-    SCDataType dataType = [[self definitionForObject:object] propertyDataTypeForPropertyWithName:propertyName];
+    if(!propertyValues.count || ![self supportsBatchRequests])
+        return [super updateObjects:objects withPropertyValues:propertyValues];
     
-    NSObject *value = nil;
-    switch (dataType)
+    // batch requests work directly on the persistent store, so they would miss or overwrite the entities' pending changes
+    if([self hasUnsavedChangesToEntitiesOfObjects:objects])
+        return [super updateObjects:objects withPropertyValues:propertyValues];
+    
+    NSMutableArray *unsavedObjects = [NSMutableArray array];
+    NSDictionary *objectIDsByEntityName = [self persistedObjectIDsByEntityNameForObjects:objects unsavedObjects:unsavedObjects];
+    NSDictionary *entitiesByName = [[self rootManagedObjectContext].persistentStoreCoordinator.managedObjectModel entitiesByName];
+    
+    NSMutableArray *updatedObjectIDs = [NSMutableArray array];
+    for(NSString *entityName in objectIDsByEntityName)
     {
-        case SCDataTypeNSMutableSet:
-            value = [(NSManagedObject *)object mutableSetValueForKey:propertyName];
-            break;
+        NSArray *objectIDs = [objectIDsByEntityName objectForKey:entityName];
+        NSEntityDescription *entity = [entitiesByName objectForKey:entityName];
+        
+        // batch updates can only set attributes
+        BOOL attributesOnly = (entity != nil);
+        for(NSString *propertyName in propertyValues)
+        {
+            if(![entity.attributesByName objectForKey:propertyName])
+            {
+                attributesOnly = FALSE;
+                break;
+            }
+        }
+        
+        NSBatchUpdateResult *result = nil;
+        if(attributesOnly)
+        {
+            NSBatchUpdateRequest *updateRequest = [[NSBatchUpdateRequest alloc] initWithEntity:entity];
+            updateRequest.predicate = [NSPredicate predicateWithFormat:@"SELF IN %@", objectIDs];
+            updateRequest.propertiesToUpdate = propertyValues;
+            updateRequest.resultType = NSUpdatedObjectIDsResultType;
             
-        default:
-            value = [super valueForPropertyName:propertyName inObject:object];
-            break;
+            NSError *error = nil;
+            result = (NSBatchUpdateResult *)[self executeBatchRequest:updateRequest error:&error];
+            if(!result)
+                SCDebugLog(@"Error batch updating objects of entity '%@': %@, %@", entityName, error, [error userInfo]);
+        }
+        
+        if(!result)
+        {
+            // fall back to updating the entity's objects one by one
+            for(NSManagedObjectID *objectID in objectIDs)
+                [unsavedObjects addObject:[self.managedObjectContext objectWithID:objectID]];
+            
+            continue;
+        }
+        
+        [updatedObjectIDs addObjectsFromArray:result.result];
     }
     
-    return value;
+    if(updatedObjectIDs.count)
+        [self mergeBatchChanges:[NSDictionary dictionaryWithObject:updatedObjectIDs forKey:NSUpdatedObjectsKey]];
+    
+    if(unsavedObjects.count)
+        [super updateObjects:unsavedObjects withPropertyValues:propertyValues];
+    
+    return TRUE;
 }
 
 // overrides superclass
-- (void)setValue:(NSObject *)value forPropertyName:(NSString *)propertyName inObject:(NSObject *)object
+- (BOOL)deleteObjects:(NSArray *)objects
 {
-    if(![SCUtilities propertyName:propertyName existsInObject:object])
-        return;
+    // bound sets have to be updated object by object
+    if(self.boundSet || self.boundOrderedSet || ![self supportsBatchRequests])
+        return [super deleteObjects:objects];
     
-    NSArray *keyPathArray = [propertyName componentsSeparatedByString:@"."];
-    if(keyPathArray.count == 1)
-    {
-        [object setValue:value forKey:propertyName];
-    }
-    else
+    // batch requests work directly on the persistent store, so they would miss or overwrite the entities' pending changes
+    if([self hasUnsavedChangesToEntitiesOfObjects:objects])
+        return [super deleteObjects:objects];
+    
+    NSMutableArray *unsavedObjects = [NSMutableArray array];
+    NSDictionary *objectIDsByEntityName = [self persistedObjectIDsByEntityNameForObjects:objects unsavedObjects:unsavedObjects];
+    NSDictionary *entitiesByName = [[self rootManagedObjectContext].persistentStoreCoordinator.managedObjectModel entitiesByName];
+    
+    NSMutableArray *deletedObjectIDs = [NSMutableArray array];
+    for(NSString *entityName in objectIDsByEntityName)
     {
-        if([object isKindOfClass:[NSManagedObject class]])
+        NSArray *objectIDs = [objectIDsByEntityName objectForKey:entityName];
+        
+        // deny rules require validating each object in the context
+        BOOL deniesDeletion = FALSE;
+        for(NSRelationshipDescription *relationship in [[[entitiesByName objectForKey:entityName] relationshipsByName] allValues])
         {
-            // Make sure all entity objects on the path exist, otherwise create them
-            NSManagedObject *mObject = (NSManagedObject *)object;
-            for(int i=0; i<keyPathArray.count-1; i++)
+            if(relationship.deleteRule == NSDenyDeleteRule)
             {
-                NSString *key = [keyPathArray objectAtIndex:i];
+                deniesDeletion = TRUE;
+                break;
+            }
+        }
+        
+        NSBatchDeleteResult *result = nil;
+        if(!deniesDeletion)
+        {
+            NSBatchDeleteRequest *deleteRequest = [[NSBatchDeleteRequest alloc] initWithObjectIDs:objectIDs];
+            deleteRequest.resultType = NSBatchDeleteResultTypeObjectIDs;
+            
+            NSError *error = nil;
+            result = (NSBatchDeleteResult *)[self executeBatchRequest:deleteRequest error:&error];
+            if(!result)
+                SCDebugLog(@"Error batch deleting objects of entity '%@': %@, %@", entityName, error, [error userInfo]);
+        }
+        
+        if(!result)
+        {
+            // fall back to deleting the entity's objects one by one
+            for(NSManagedObjectID *objectID in objectIDs)
+                [unsavedObjects addObject:[self.managedObjectContext objectWithID:objectID]];
+            
+            continue;
+        }
+        
+        [deletedObjectIDs addObjectsFromArray:result.result];
+    }
+    
+    if(deletedObjectIDs.count)
+        [self mergeBatchChanges:[NSDictionary dictionaryWithObject:deletedObjectIDs forKey:NSDeletedObjectsKey]];
+    
+    for(NSObject *object in unsavedObjects)
+        [self deleteObject:object];
+    
+    return TRUE;
+}
+
+- (NSFetchedResultsController *)fetchedResultsControllerForFetchOptions:(SCCoreDataFetchOptions *)fetchOptions
+{
+    SCEntityDefinition *entityDefinition = (SCEntityDefinition *)self.defaultDataDefinition;
+    if(self.boundSet || self.boundOrderedSet || !fetchOptions || ![entityDefinition isKindOfClass:[SCEntityDefinition class]])
+        return nil;
+    
+    NSPredicate *filterPredicate = nil;
+    if(fetchOptions.filter)
+        filterPredicate = fetchOptions.filterPredicate;
+    NSArray *sortDescriptors = [fetchOptions sortDescriptors];
+    if(!sortDescriptors.count)
+    {
+        // fetched results controllers require at least one sort descriptor
+        NSString *sortKey = fetchOptions.sortKey ? fetchOptions.sortKey : entityDefinition.keyPropertyName;
+        sortDescriptors = [NSArray arrayWithObject:[NSSortDescriptor sortDescriptorWithKey:sortKey ascending:fetchOptions.sortAscending]];
+    }
+    
+    SCFetchedResultsObserver *observer = [self.fetchedResultsObservers objectForKey:fetchOptions];
+    NSFetchRequest *fetchRequest = observer.fetchedResultsController.fetchRequest;
+    NSString *sectionNameKeyPath = observer.fetchedResultsController.sectionNameKeyPath;
+    BOOL sectionNameKeyPathChanged = (sectionNameKeyPath != fetchOptions.sectionNameKeyPath) && ![sectionNameKeyPath isEqualToString:fetchOptions.sectionNameKeyPath];
+    BOOL needsFetch = FALSE;
+    if(!observer || observer.fetchedResultsController.managedObjectContext != self.managedObjectContext || sectionNameKeyPathChanged)
+    {
+        fetchRequest = [[NSFetchRequest alloc] init];
+        [fetchRequest setEntity:entityDefinition.entity];
+        [fetchRequest setRelationshipKeyPathsForPrefetching:[self prefetchKeyPathsForEntity:entityDefinition.entity]];
+        
+        observer = [[SCFetchedResultsObserver alloc] init];
+        observer.store = self;
+        observer.fetchOptions = fetchOptions;
+        observer.fetchedResultsController = [[NSFetchedResultsController alloc] initWithFetchRequest:fetchRequest managedObjectContext:self.managedObjectContext sectionNameKeyPath:fetchOptions.sectionNameKeyPath cacheName:nil];
+        observer.fetchedResultsController.delegate = observer;
+        [self.fetchedResultsObservers setObject:observer forKey:fetchOptions];
+        
+        needsFetch = TRUE;
+    }
+    
+    // the fetch options might have changed since the last fetch
+    if(![fetchRequest.sortDescriptors isEqualToArray:sortDescriptors])
+    {
+        [fetchRequest setSortDescriptors:sortDescriptors];
+        needsFetch = TRUE;
+    }
+    if(fetchRequest.predicate!=filterPredicate && ![fetchRequest.predicate isEqual:filterPredicate])
+    {
+        [fetchRequest setPredicate:filterPredicate];
+        needsFetch = TRUE;
+    }
+    if(fetchRequest.fetchBatchSize != fetchOptions.fetchBatchSize)
+    {
+        [fetchRequest setFetchBatchSize:fetchOptions.fetchBatchSize];
+        needsFetch = TRUE;
+    }
+    
+    if(needsFetch)
+    {
+        NSError *error = nil;
+        if(![observer.fetchedResultsController performFetch:&error])
+            SCDebugLog(@"Warning: Fetched results controller failed to fetch with error: %@", error);
+    }
+    
+    return observer.fetchedResultsController;
+}
+
+- (void)fetchedResultsObserverDidChangeContent:(SCFetchedResultsObserver *)observer
+{
+    if(!observer.fetchOptions)
+        return;
+    
+    NSArray *fetchedObjects = observer.fetchedResultsController.fetchedObjects;
+    if(!fetchedObjects)
+        fetchedObjects = [NSArray array];
+    
+    NSMutableDictionary *userInfo = [NSMutableDictionary dictionaryWithObjectsAndKeys:
+                                     observer.insertedObjects, SCDataStoreInsertedObjectsKey,
+                                     observer.updatedObjects, SCDataStoreUpdatedObjectsKey,
+                                     observer.deletedObjects, SCDataStoreDeletedObjectsKey,
+                                     observer.movedObjects, SCDataStoreMovedObjectsKey,
+                                     fetchedObjects, SCDataStoreFetchedObjectsKey,
+                                     observer.fetchOptions, SCDataStoreFetchOptionsKey, nil];
+    
+    // lets sections apply the changes to their items without copying (and faulting in) all the fetched objects
+    NSIndexSet *removedIndexes = [observer indexesForIndexPaths:observer.removedIndexPaths sectionCounts:observer.previousSectionCounts];
+    NSIndexSet *addedIndexes = [observer indexesForIndexPaths:observer.addedIndexPaths sectionCounts:[observer sectionCounts]];
+    if(removedIndexes && addedIndexes)
+    {
+        [userInfo setObject:removedIndexes forKey:SCDataStoreRemovedIndexesKey];
+        [userInfo setObject:addedIndexes forKey:SCDataStoreAddedIndexesKey];
+    }
+    [[NSNotificationCenter defaultCenter] postNotificationName:SCDataStoreDidChangeObjectsNotification object:self userInfo:userInfo];
+}
+
+// Returns the relationship part of the given key path, e.g. "department" for "department.name"
+- (NSString *)relationshipKeyPathForKeyPath:(NSString *)keyPath inEntity:(NSEntityDescription *)entity
+{
+    NSMutableArray *relationshipNames = [NSMutableArray array];
+    for(NSString *key in [keyPath componentsSeparatedByString:@"."])
+    {
+        NSRelationshipDescription *relationship = [[entity relationshipsByName] valueForKey:key];
+        if(!relationship)
+            break;
+        
+        [relationshipNames addObject:key];
+        entity = relationship.destinationEntity;
+    }
+    
+    if(!relationshipNames.count)
+        return nil;
+    //else
+    return [relationshipNames componentsJoinedByString:@"."];
+}
+
+- (NSArray *)relationshipKeyPathsForPrefetchingWithEntityDefinition:(SCEntityDefinition *)entityDefinition
+{
+    NSEntityDescription *entity = entityDefinition.entity;
+    if(!entity)
+        return nil;
+    
+    NSMutableArray *keyPaths = [NSMutableArray array];
+    if(entityDefinition.titlePropertyName)
+        [keyPaths addObjectsFromArray:[entityDefinition.titlePropertyName componentsSeparatedByString:@";"]];
+    if(entityDefinition.descriptionPropertyName)
+        [keyPaths addObjectsFromArray:[entityDefinition.descriptionPropertyName componentsSeparatedByString:@";"]];
+    for(NSUInteger i=0; i<entityDefinition.propertyDefinitionCount; i++)
+    {
+        SCPropertyDefinition *propertyDefinition = [entityDefinition propertyDefinitionAtIndex:i];
+        if(!propertyDefinition.existsInNormalMode)
+            continue;
+        
+        // object selection cells display the title of their selected objects
+        if(propertyDefinition.type==SCPropertyTypeObjectSelection || [propertyDefinition.name rangeOfString:@"."].location!=NSNotFound)
+            [keyPaths addObject:propertyDefinition.name];
+    }
+    
+    NSMutableOrderedSet *relationshipKeyPaths = [NSMutableOrderedSet orderedSet];
+    NSCharacterSet *spaceTrimSet = [NSCharacterSet whitespaceAndNewlineCharacterSet];
+    for(NSString *keyPath in keyPaths)
+    {
+        NSString *relationshipKeyPath = [self relationshipKeyPathForKeyPath:[keyPath stringByTrimmingCharactersInSet:spaceTrimSet] inEntity:entity];
+        if(relationshipKeyPath)
+            [relationshipKeyPaths addObject:relationshipKeyPath];
+    }
+    
+    return [relationshipKeyPaths array];
+}
+
+// Returns the relationship key paths to prefetch for the given entity, or nil if prefetching is off
+- (NSArray *)prefetchKeyPathsForEntity:(NSEntityDescription *)entity
+{
+    if(!self.prefetchesRelationships)
+        return nil;
+    
+    SCEntityDefinition *entityDefinition = [_dataDefinitions valueForKey:entity.name];
+    if(![entityDefinition isKindOfClass:[SCEntityDefinition class]])
+        return nil;
+    
+    NSArray *keyPaths = [self relationshipKeyPathsForPrefetchingWithEntityDefinition:entityDefinition];
+    return keyPaths.count ? keyPaths : nil;
+}
+
+// Returns the relationship key paths to prefetch for each of the store's entities, keyed by entity name
+- (NSDictionary *)prefetchKeyPathsByEntityName
+{
+    NSMutableDictionary *keyPathsByEntityName = [NSMutableDictionary dictionary];
+    if(!self.prefetchesRelationships)
+        return keyPathsByEntityName;
+    
+    for(NSString *entityName in _dataDefinitions)
+    {
+        SCEntityDefinition *entityDefinition = [_dataDefinitions valueForKey:entityName];
+        if(![entityDefinition isKindOfClass:[SCEntityDefinition class]])
+            continue;
+        
+        NSArray *keyPaths = [self prefetchKeyPathsForEntity:entityDefinition.entity];
+        if(keyPaths)
+            [keyPathsByEntityName setValue:keyPaths forKey:entityName];
+    }
+    
+    return keyPathsByEntityName;
+}
+
+// Faults in the given objects of the store's context and their to-one prefetch relationships
+- (void)prefetchRelationshipsForObjects:(NSArray *)objects
+{
+    if(!self.prefetchesRelationships || !objects.count)
+        return;
+    
+    [SCCoreDataStore prefetchRelationshipsForObjects:objects keyPathsByEntityName:[self prefetchKeyPathsByEntityName] context:self.managedObjectContext];
+}
+
+// Faults in the given objects (when they are faults themselves) and their to-one prefetch relationships, using one fetch request per entity and key path. Must be called on the queue of context.
++ (void)prefetchRelationshipsForObjects:(NSArray *)objects keyPathsByEntityName:(NSDictionary *)keyPathsByEntityName context:(NSManagedObjectContext *)context
+{
+    NSMutableDictionary *objectsByEntityName = [NSMutableDictionary dictionary];
+    for(NSManagedObject *object in objects)
+    {
+        if(![object isKindOfClass:[NSManagedObject class]])
+            continue;
+        
+        NSMutableArray *entityObjects = [objectsByEntityName valueForKey:object.entity.name];
+        if(!entityObjects)
+        {
+            entityObjects = [NSMutableArray array];
+            [objectsByEntityName setValue:entityObjects forKey:object.entity.name];
+        }
+        [entityObjects addObject:object];
+    }
+    
+    for(NSString *entityName in objectsByEntityName)
+    {
+        NSArray *entityObjects = [objectsByEntityName valueForKey:entityName];
+        NSEntityDescription *entity = [[entityObjects objectAtIndex:0] entity];
+        NSArray *keyPaths = [keyPathsByEntityName valueForKey:entityName];
+        
+        NSMutableArray *faults = [NSMutableArray array];
+        NSMutableArray *loadedObjects = [NSMutableArray array];
+        for(NSManagedObject *object in entityObjects)
+        {
+            if(object.isFault)
+                [faults addObject:object];
+            else
+                [loadedObjects addObject:object];
+        }
+        
+        if(faults.count)
+        {
+            // a single fetch loads the faults along with all their prefetch relationships
+            NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
+            [fetchRequest setEntity:entity];
+            [fetchRequest setPredicate:[NSPredicate predicateWithFormat:@"SELF IN %@", faults]];
+            [fetchRequest setReturnsObjectsAsFaults:NO];
+            [fetchRequest setRelationshipKeyPathsForPrefetching:keyPaths];
+            NSError *error = nil;
+            if(![context executeFetchRequest:fetchRequest error:&error])
+                SCDebugLog(@"Warning: Unable to prefetch objects of entity '%@': %@", entityName, error);
+        }
+        if(!loadedObjects.count || !keyPaths.count)
+            continue;
+        
+        // the other objects are already loaded: fault in their to-one relationships one level at a time, so that 'a' is faulted in for all the objects before 'a.b' is
+        NSMutableOrderedSet *levelKeyPaths = [NSMutableOrderedSet orderedSet];
+        for(NSString *keyPath in keyPaths)
+        {
+            NSArray *components = [keyPath componentsSeparatedByString:@"."];
+            for(NSUInteger i=1; i<=components.count; i++)
+                [levelKeyPaths addObject:[[components subarrayWithRange:NSMakeRange(0, i)] componentsJoinedByString:@"."]];
+        }
+        NSArray *sortedKeyPaths = [[levelKeyPaths array] sortedArrayUsingComparator:^NSComparisonResult(NSString *keyPath1, NSString *keyPath2)
+                                   {
+                                       NSUInteger depth1 = [[keyPath1 componentsSeparatedByString:@"."] count];
+                                       NSUInteger depth2 = [[keyPath2 componentsSeparatedByString:@"."] count];
+                                       return depth1 < depth2 ? NSOrderedAscending : (depth1 > depth2 ? NSOrderedDescending : NSOrderedSame);
+                                   }];
+        for(NSString *keyPath in sortedKeyPaths)
+        {
+            NSMutableDictionary *faultsByEntityName = [NSMutableDictionary dictionary];
+            for(NSManagedObject *object in loadedObjects)
+            {
+                NSManagedObject *relatedObject = [object valueForKeyPath:keyPath];
+                if(![relatedObject isKindOfClass:[NSManagedObject class]] || !relatedObject.isFault)
+                    continue;
+                
+                NSMutableArray *relatedFaults = [faultsByEntityName valueForKey:relatedObject.entity.name];
+                if(!relatedFaults)
+                {
+                    relatedFaults = [NSMutableArray array];
+                    [faultsByEntityName setValue:relatedFaults forKey:relatedObject.entity.name];
+                }
+                [relatedFaults addObject:relatedObject];
+            }
+            
+            for(NSString *relatedEntityName in faultsByEntityName)
+            {
+                NSArray *relatedFaults = [faultsByEntityName valueForKey:relatedEntityName];
+                NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
+                [fetchRequest setEntity:[[relatedFaults objectAtIndex:0] entity]];
+                [fetchRequest setPredicate:[NSPredicate predicateWithFormat:@"SELF IN %@", relatedFaults]];
+                [fetchRequest setReturnsObjectsAsFaults:NO];
+                NSError *error = nil;
+                if(![context executeFetchRequest:fetchRequest error:&error])
+                    SCDebugLog(@"Warning: Unable to prefetch relationship '%@' of entity '%@': %@", keyPath, entityName, error);
+            }
+        }
+    }
+}
+
+// Returns the given fetch options if they are Core Data fetch options, otherwise returns default Core Data fetch options with the same filter predicate
+- (SCCoreDataFetchOptions *)coreDataFetchOptionsForFetchOptions:(SCDataFetchOptions *)fetchOptions
+{
+    SCCoreDataFetchOptions *defaultFetchOptions = (SCCoreDataFetchOptions *)[self.defaultDataDefinition generateCompatibleDataFetchOptions];
+    
+    SCCoreDataFetchOptions *coreDataFetchOptions;
+    if([fetchOptions isKindOfClass:[SCCoreDataFetchOptions class]])
+    {
+        coreDataFetchOptions = (SCCoreDataFetchOptions *)fetchOptions;
+        
+        if(coreDataFetchOptions.sort && !coreDataFetchOptions.sortKey)
+            coreDataFetchOptions.sortKey = defaultFetchOptions.sortKey;
+    }
+    else
+    {
+        coreDataFetchOptions = defaultFetchOptions;
+        if(fetchOptions.filterPredicate)
+            coreDataFetchOptions.filterPredicate = fetchOptions.filterPredicate;
+    }
+    
+    return coreDataFetchOptions;
+}
+
+// Returns a fetch request configured with the given options, without an entity
+- (NSFetchRequest *)fetchRequestWithOptions:(SCCoreDataFetchOptions *)coreDataFetchOptions
+{
+    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
+    [fetchRequest setFetchBatchSize:coreDataFetchOptions.fetchBatchSize];
+    if(coreDataFetchOptions.batchSize)
+    {
+        [fetchRequest setFetchLimit:coreDataFetchOptions.batchSize];
+        [fetchRequest setFetchOffset:coreDataFetchOptions.batchCurrentOffset*coreDataFetchOptions.batchSize];
+    }
+    NSArray *sortDescriptors = [coreDataFetchOptions sortDescriptors];
+    if(sortDescriptors)
+        [fetchRequest setSortDescriptors:sortDescriptors];
+    if(coreDataFetchOptions.filter && coreDataFetchOptions.filterPredicate)
+        [fetchRequest setPredicate:coreDataFetchOptions.filterPredicate];
+    
+    return fetchRequest;
+}
+
+// Returns the entities of the store's entity definitions, sorted by name so that objects with equal sort values always come out in the same order
+- (NSArray *)fetchEntities
+{
+    NSMutableArray *entities = [NSMutableArray array];
+    for(SCEntityDefinition *entityDefinition in [_dataDefinitions allValues])
+    {
+        if([entityDefinition isKindOfClass:[SCEntityDefinition class]] && entityDefinition.entity)
+            [entities addObject:entityDefinition.entity];
+    }
+    [entities sortUsingDescriptors:[NSArray arrayWithObject:[NSSortDescriptor sortDescriptorWithKey:@"name" ascending:YES]]];
+    
+    return entities;
+}
+
+// Returns the per entity offsets to resume the given fetch options' current page from, setting skipCount to the number of merged objects that must be skipped first (when there is no cursor to resume from)
+- (NSDictionary *)multiEntityFetchOffsetsForOptions:(SCCoreDataFetchOptions *)coreDataFetchOptions skipCount:(NSUInteger *)skipCount
+{
+    *skipCount = 0;
+    if(!coreDataFetchOptions.batchSize)
+        return [NSDictionary dictionary];
+    
+    NSUInteger pageOffset = coreDataFetchOptions.batchCurrentOffset*coreDataFetchOptions.batchSize;
+    SCMultiEntityFetchCursor *cursor = [self.multiEntityFetchCursors objectForKey:coreDataFetchOptions];
+    if(pageOffset && cursor.fetchedCount==pageOffset)
+        return cursor.entityOffsets;
+    
+    *skipCount = pageOffset;
+    return [NSDictionary dictionary];
+}
+
+- (void)setMultiEntityFetchOffsets:(NSDictionary *)entityOffsets fetchedCount:(NSUInteger)fetchedCount forOptions:(SCCoreDataFetchOptions *)coreDataFetchOptions
+{
+    if(!coreDataFetchOptions.batchSize)
+        return;
+    
+    SCMultiEntityFetchCursor *cursor = [[SCMultiEntityFetchCursor alloc] init];
+    cursor.fetchedCount = fetchedCount;
+    cursor.entityOffsets = entityOffsets;
+    [self.multiEntityFetchCursors setObject:cursor forKey:coreDataFetchOptions];
+}
+
+// Fetches a globally sorted page of up to 'limit' objects (all objects if zero) from several entities, by merging per entity fetches that each start at the entity's offset in entityOffsets. Each entity contributes at most skipCount+limit objects to the merge. entityOffsets is advanced by the number of objects each entity contributed.
+- (NSArray *)fetchMergedObjectsForEntities:(NSArray *)entities fetchRequest:(NSFetchRequest *)fetchRequest context:(NSManagedObjectContext *)context skipCount:(NSUInteger)skipCount limit:(NSUInteger)limit entityOffsets:(NSMutableDictionary *)entityOffsets error:(NSError **)error
+{
+    NSArray *sortDescriptors = fetchRequest.sortDescriptors;
+    
+    NSMutableArray *entityResults = [NSMutableArray arrayWithCapacity:entities.count];
+    for(NSEntityDescription *entity in entities)
+    {
+        NSFetchRequest *entityFetchRequest = [fetchRequest copy];
+        [entityFetchRequest setEntity:entity];
+        [entityFetchRequest setFetchOffset:[[entityOffsets valueForKey:entity.name] unsignedIntegerValue]];
+        [entityFetchRequest setFetchLimit:(limit ? skipCount+limit : 0)];
+        NSArray *results = [context executeFetchRequest:entityFetchRequest error:error];
+        if(!results)
+            return nil;
+        
+        [entityResults addObject:results];
+    }
+    
+    // k-way merge of the sorted results
+    NSUInteger heads[entityResults.count];
+    memset(heads, 0, sizeof(heads));
+    NSMutableArray *mergedObjects = [NSMutableArray array];
+    for(NSUInteger mergedCount=0; !limit || mergedCount<skipCount+limit; mergedCount++)
+    {
+        NSInteger nextIndex = -1;
+        NSObject *nextObject = nil;
+        for(NSUInteger i=0; i<entityResults.count; i++)
+        {
+            NSArray *results = [entityResults objectAtIndex:i];
+            if(heads[i] >= results.count)
+                continue;
+            
+            NSObject *object = [results objectAtIndex:heads[i]];
+            NSComparisonResult comparison = NSOrderedDescending;
+            for(NSUInteger j=0; nextObject && j<sortDescriptors.count; j++)
+            {
+                comparison = [[sortDescriptors objectAtIndex:j] compareObject:object toObject:nextObject];
+                if(comparison != NSOrderedSame)
+                    break;
+            }
+            if(!nextObject || comparison==NSOrderedAscending)
+            {
+                nextIndex = i;
+                nextObject = object;
+            }
+        }
+        if(nextIndex < 0)
+            break;  // all entities are exhausted
+        
+        heads[nextIndex]++;
+        if(mergedCount >= skipCount)
+            [mergedObjects addObject:nextObject];
+    }
+    
+    for(NSUInteger i=0; i<entities.count; i++)
+    {
+        NSEntityDescription *entity = [entities objectAtIndex:i];
+        NSUInteger offset = [[entityOffsets valueForKey:entity.name] unsignedIntegerValue] + heads[i];
+        [entityOffsets setValue:[NSNumber numberWithUnsignedInteger:offset] forKey:entity.name];
+    }
+    
+    return mergedObjects;
+}
+
+// overrides superclass
+- (NSArray *)fetchObjectsWithOptions:(SCDataFetchOptions *)fetchOptions
+{
+    SCCoreDataFetchOptions *coreDataFetchOptions = [self coreDataFetchOptionsForFetchOptions:fetchOptions];
+    
+    NSPredicate *filterPredicate = nil;
+    if(coreDataFetchOptions.filter)
+        filterPredicate = coreDataFetchOptions.filterPredicate;
+    
+    NSArray *sortDescriptors = nil;
+    if(!self.boundOrderedSet)
+        sortDescriptors = [coreDataFetchOptions sortDescriptors];
+    
+    if(coreDataFetchOptions.usesFetchedResultsController && !self.boundSet && !self.boundOrderedSet)
+    {
+        // live results are fetched all at once, with Core Data loading their data fetchBatchSize objects at a time
+        NSArray *fetchedObjects = [self fetchedResultsControllerForFetchOptions:coreDataFetchOptions].fetchedObjects;
+        
+        return fetchedObjects ? fetchedObjects : [NSArray array];
+    }
+    
+    NSMutableArray *array = [NSMutableArray array];
+    if(self.boundSet || self.boundOrderedSet)
+    {
+        if(self.boundSet)
+            [array addObjectsFromArray:[self.boundSet allObjects]];
+        else
+            [array addObjectsFromArray:[self.boundOrderedSet array]];
+        if(filterPredicate)
+        {
+            @try 
+            {
+                [array filterUsingPredicate:filterPredicate];
+            }
+            @catch (NSException * e) 
+            {
+                SCDebugLog(@"Warning: Invalid filter predicate: %@.", filterPredicate);
+            }
+        }
+        if(sortDescriptors)
+        {
+            @try 
+            {
+                [array sortUsingDescriptors:sortDescriptors];
+            }
+            @catch (NSException * e) 
+            {
+                SCDebugLog(@"Warning: Invalid sort key: %@ or orderAttribute:%@.", coreDataFetchOptions.sortKey, coreDataFetchOptions.orderAttributeName);
+            }
+        }
+        
+        [self prefetchRelationshipsForObjects:array];
+    }
+    else 
+    {
+        NSFetchRequest *fetchRequest = [self fetchRequestWithOptions:coreDataFetchOptions];
+		
+        // fetch all entities in dataDefinitions
+        NSArray *entities = [self fetchEntities];
+        if(entities.count > 1)
+        {
+            // merge the entities' objects into a single sorted page
+            NSUInteger skipCount;
+            NSUInteger pageOffset = coreDataFetchOptions.batchCurrentOffset*coreDataFetchOptions.batchSize;
+            NSMutableDictionary *entityOffsets = [NSMutableDictionary dictionaryWithDictionary:[self multiEntityFetchOffsetsForOptions:coreDataFetchOptions skipCount:&skipCount]];
+            NSError *error = nil;
+            NSArray *mergedObjects = [self fetchMergedObjectsForEntities:entities fetchRequest:fetchRequest context:self.managedObjectContext skipCount:skipCount limit:coreDataFetchOptions.batchSize entityOffsets:entityOffsets error:&error];
+            if(mergedObjects)
+            {
+                [array addObjectsFromArray:mergedObjects];
+                [self prefetchRelationshipsForObjects:mergedObjects];
+                [self setMultiEntityFetchOffsets:entityOffsets fetchedCount:pageOffset+mergedObjects.count forOptions:coreDataFetchOptions];
+            }
+            else
+            {
+                SCDebugLog(@"Error fetching from the Core Data store: %@, %@", error, [error userInfo]);
+            }
+        }
+        else
+        {
+            for(SCEntityDefinition *entityDefinition in [_dataDefinitions allValues])
+            {
+                if(![entityDefinition isKindOfClass:[SCEntityDefinition class]])
+                    continue;
+                
+                [fetchRequest setEntity:entityDefinition.entity];
+                [fetchRequest setRelationshipKeyPathsForPrefetching:[self prefetchKeyPathsForEntity:entityDefinition.entity]];
+                [array addObjectsFromArray:[entityDefinition.managedObjectContext executeFetchRequest:fetchRequest error:NULL]];
+            }
+        }
+		
+		if(coreDataFetchOptions.batchSize)
+            [coreDataFetchOptions incrementBatchOffset];
+    }
+    
+    return array;
+}
+
+// overrides superclass
+- (NSArray *)fetchSharedObjectsWithOptions:(SCDataFetchOptions *)fetchOptions forConsumer:(NSObject *)consumer
+{
+    // each consumer of live results needs its own fetched results controller, whose changes are posted with the consumer's fetch options
+    if([self coreDataFetchOptionsForFetchOptions:fetchOptions].usesFetchedResultsController)
+    {
+        [self releaseSharedFetchResultsForConsumer:consumer];
+        return [self fetchObjectsWithOptions:fetchOptions];
+    }
+    
+    return [super fetchSharedObjectsWithOptions:fetchOptions forConsumer:consumer];
+}
+
+// overrides superclass
+- (NSString *)sharedFetchResultsKeyForOptions:(SCDataFetchOptions *)fetchOptions
+{
+    SCCoreDataFetchOptions *coreDataFetchOptions = [self coreDataFetchOptionsForFetchOptions:fetchOptions];
+    
+    return [NSString stringWithFormat:@"%@|order:%@|fetchBatch:%lu|frc:%i,%@", [super sharedFetchResultsKeyForOptions:coreDataFetchOptions], coreDataFetchOptions.orderAttributeName, (unsigned long)coreDataFetchOptions.fetchBatchSize, coreDataFetchOptions.usesFetchedResultsController, coreDataFetchOptions.sectionNameKeyPath];
+}
+
+// overrides superclass
+- (BOOL)sharedFetchResultsOfOptions:(SCDataFetchOptions *)fetchOptions dependOnPropertyName:(NSString *)propertyName
+{
+    // the Core Data options also sort by the order attribute and group by the section name key path
+    SCCoreDataFetchOptions *coreDataFetchOptions = [self coreDataFetchOptionsForFetchOptions:fetchOptions];
+    if(coreDataFetchOptions.sectionNameKeyPath && [coreDataFetchOptions.sectionNameKeyPath isEqualToString:propertyName])
+        return TRUE;
+    
+    return [super sharedFetchResultsOfOptions:coreDataFetchOptions dependOnPropertyName:propertyName];
+}
+
+// overrides superclass
+- (NSUInteger)countObjectsWithOptions:(SCDataFetchOptions *)fetchOptions
+{
+    SCCoreDataFetchOptions *coreDataFetchOptions = [self coreDataFetchOptionsForFetchOptions:fetchOptions];
+    
+    NSPredicate *filterPredicate = nil;
+    if(coreDataFetchOptions.filter)
+        filterPredicate = coreDataFetchOptions.filterPredicate;
+    
+    if(self.boundSet || self.boundOrderedSet)
+    {
+        NSArray *objects = self.boundSet ? [self.boundSet allObjects] : [self.boundOrderedSet array];
+        if(!filterPredicate)
+            return objects.count;
+        
+        @try
+        {
+            return [objects filteredArrayUsingPredicate:filterPredicate].count;
+        }
+        @catch (NSException * e)
+        {
+            SCDebugLog(@"Warning: Invalid filter predicate: %@.", filterPredicate);
+            return objects.count;
+        }
+    }
+    
+    // count all entities in dataDefinitions
+    NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
+    [fetchRequest setPredicate:filterPredicate];
+    NSUInteger count = 0;
+    for(SCEntityDefinition *entityDefinition in [_dataDefinitions allValues])
+    {
+        if(![entityDefinition isKindOfClass:[SCEntityDefinition class]])
+            continue;
+        
+        [fetchRequest setEntity:entityDefinition.entity];
+        NSError *error = nil;
+        NSUInteger entityCount = [entityDefinition.managedObjectContext countForFetchRequest:fetchRequest error:&error];
+        if(entityCount == NSNotFound)
+        {
+            SCDebugLog(@"Error counting objects of entity '%@': %@, %@", entityDefinition.entity.name, error, [error userInfo]);
+            return NSNotFound;
+        }
+        
+        count += entityCount;
+    }
+    
+    return count;
+}
+
+// overrides superclass
+- (NSArray *)fetchGroupsForPropertyName:(NSString *)propertyName withOptions:(SCDataFetchOptions *)fetchOptions
+{
+    // dictionary fetches don't see unsaved changes, so these are grouped in memory
+    if(self.boundSet || self.boundOrderedSet || [self.managedObjectContext hasChanges])
+        return [super fetchGroupsForPropertyName:propertyName withOptions:fetchOptions];
+    
+    SCCoreDataFetchOptions *coreDataFetchOptions = [self coreDataFetchOptionsForFetchOptions:fetchOptions];
+    
+    NSPredicate *filterPredicate = nil;
+    if(coreDataFetchOptions.filter)
+        filterPredicate = coreDataFetchOptions.filterPredicate;
+    
+    NSExpressionDescription *countDescription = [[NSExpressionDescription alloc] init];
+    countDescription.name = @"count";
+    countDescription.expression = [NSExpression expressionForFunction:@"count:" arguments:[NSArray arrayWithObject:[NSExpression expressionForEvaluatedObject]]];
+    countDescription.expressionResultType = NSInteger64AttributeType;
+    
+    // have the persistent store count the objects of each group (e.g. GROUP BY in SQLite)
+    NSMapTable *groupCounts = [NSMapTable strongToStrongObjectsMapTable];
+    for(SCEntityDefinition *entityDefinition in [_dataDefinitions allValues])
+    {
+        if(![entityDefinition isKindOfClass:[SCEntityDefinition class]] || !entityDefinition.entity)
+            continue;
+        
+        NSAttributeDescription *attribute = [entityDefinition.entity.attributesByName objectForKey:propertyName];
+        if(!attribute)
+            return [super fetchGroupsForPropertyName:propertyName withOptions:fetchOptions];  // only attributes can be grouped by value
+        
+        NSFetchRequest *fetchRequest = [[NSFetchRequest alloc] init];
+        [fetchRequest setEntity:entityDefinition.entity];
+        [fetchRequest setPredicate:filterPredicate];
+        [fetchRequest setResultType:NSDictionaryResultType];
+        [fetchRequest setPropertiesToGroupBy:[NSArray arrayWithObject:attribute]];
+        [fetchRequest setPropertiesToFetch:[NSArray arrayWithObjects:attribute, countDescription, nil]];
+        
+        NSError *error = nil;
+        NSArray *results = [entityDefinition.managedObjectContext executeFetchRequest:fetchRequest error:&error];
+        if(!results)
+        {
+            SCDebugLog(@"Error grouping objects of entity '%@': %@, %@", entityDefinition.entity.name, error, [error userInfo]);
+            return nil;
+        }
+        
+        for(NSDictionary *result in results)
+        {
+            NSObject *value = [result valueForKey:propertyName];
+            if(!value)
+                value = [NSNull null];
+            NSUInteger count = [(NSNumber *)[groupCounts objectForKey:value] unsignedIntegerValue] + [[result valueForKey:@"count"] unsignedIntegerValue];
+            [groupCounts setObject:[NSNumber numberWithUnsignedInteger:count] forKey:value];
+        }
+    }
+    
+    NSMutableArray *groups = [NSMutableArray arrayWithCapacity:groupCounts.count];
+    for(NSObject *value in groupCounts)
+        [groups addObject:[NSDictionary dictionaryWithObjectsAndKeys:value, SCDataStoreGroupValueKey, [groupCounts objectForKey:value], SCDataStoreGroupCountKey, nil]];
+    [self sortGroups:groups];
+    
+    return groups;
+}
+
+// overrides superclass
+- (void)asynchronousFetchObjectsWithOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    SCCoreDataFetchOptions *coreDataFetchOptions = [self coreDataFetchOptionsForFetchOptions:fetchOptions];
+    
+    NSManagedObjectContext *mainContext = self.managedObjectContext;
+    
+    // the background fetch reads straight from the coordinator, so it can't see changes that haven't reached the persistent store yet
+    BOOL hasUnsavedChanges = mainContext.hasChanges;
+    NSManagedObjectContext *parentContext = mainContext.parentContext;
+    while(parentContext && !hasUnsavedChanges)
+    {
+        __block BOOL parentHasChanges = FALSE;
+        [parentContext performBlockAndWait:^
+         {
+             parentHasChanges = parentContext.hasChanges;
+         }];
+        hasUnsavedChanges = parentHasChanges;
+        parentContext = parentContext.parentContext;
+    }
+    
+    if(self.boundSet || self.boundOrderedSet || coreDataFetchOptions.usesFetchedResultsController || !mainContext.persistentStoreCoordinator || hasUnsavedChanges)
+    {
+        // in memory, live and unsaved results gain nothing from fetching in the background
+        NSArray *results = [self fetchObjectsWithOptions:fetchOptions];
+        [self fetchObjectsSuccessful:results successBlock:success_block failure:failure_block];
+        
+        return;
+    }
+    
+    NSFetchRequest *fetchRequest = [self fetchRequestWithOptions:coreDataFetchOptions];
+    [fetchRequest setResultType:NSManagedObjectIDResultType];
+    [fetchRequest setFetchBatchSize:0];  // only object ids are fetched
+    
+    NSArray *entities = [self fetchEntities];
+    
+    // multiple entities are merged into a single sorted page
+    BOOL mergesEntities = (entities.count > 1);
+    NSUInteger skipCount = 0;
+    NSUInteger pageOffset = coreDataFetchOptions.batchCurrentOffset*coreDataFetchOptions.batchSize;
+    NSMutableDictionary *entityOffsets = nil;
+    if(mergesEntities)
+        entityOffsets = [NSMutableDictionary dictionaryWithDictionary:[self multiEntityFetchOffsetsForOptions:coreDataFetchOptions skipCount:&skipCount]];
+    
+    // the relationships are prefetched into the row cache of the shared coordinator from the private context, so that firing the faults on the main queue is cheap
+    NSDictionary *prefetchKeyPathsByEntityName = [self prefetchKeyPathsByEntityName];
+    
+    // attached straight to the coordinator, since fetching through a parent context would run the fetch on the parent's (main) queue
+    NSManagedObjectContext *fetchContext = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
+    fetchContext.persistentStoreCoordinator = mainContext.persistentStoreCoordinator;
+    
+    NSProgress *progress = [NSProgress progressWithTotalUnitCount:entities.count];
+    progress.cancellable = TRUE;
+    if(fetchOptions)
+    {
+        [[self.asynchronousFetchProgresses objectForKey:fetchOptions] cancel];
+        [self.asynchronousFetchProgresses setObject:progress forKey:fetchOptions];
+    }
+    
+    __weak typeof(self) weak_self = self;
+    [fetchContext performBlock:^
+     {
+         NSMutableArray *objectIDs = [NSMutableArray array];
+         NSError *error = nil;
+         if(mergesEntities)
+         {
+             // merging compares the objects' sort values, so they have to be fetched
+             NSFetchRequest *mergeFetchRequest = [fetchRequest copy];
+             [mergeFetchRequest setResultType:NSManagedObjectResultType];
+             NSArray *mergedObjects = [weak_self fetchMergedObjectsForEntities:entities fetchRequest:mergeFetchRequest context:fetchContext skipCount:skipCount limit:coreDataFetchOptions.batchSize entityOffsets:entityOffsets error:&error];
+             [objectIDs addObjectsFromArray:[mergedObjects valueForKey:@"objectID"]];
+             progress.completedUnitCount = entities.count;
+         }
+         else
+         {
+             for(NSEntityDescription *entity in entities)
+             {
+                 if(progress.isCancelled)
+                     break;
+                 
+                 NSFetchRequest *entityFetchRequest = [fetchRequest copy];
+                 [entityFetchRequest setEntity:entity];
+                 NSArray *entityObjectIDs = [fetchContext executeFetchRequest:entityFetchRequest error:&error];
+                 if(!entityObjectIDs)
+                     break;
+                 
+                 [objectIDs addObjectsFromArray:entityObjectIDs];
+                 progress.completedUnitCount += 1;
+             }
+         }
+         
+         if(!error && prefetchKeyPathsByEntityName.count && !progress.isCancelled)
+         {
+             NSMutableArray *fetchedObjects = [NSMutableArray arrayWithCapacity:objectIDs.count];
+             for(NSManagedObjectID *objectID in objectIDs)
+                 [fetchedObjects addObject:[fetchContext objectWithID:objectID]];
+             [SCCoreDataStore prefetchRelationshipsForObjects:fetchedObjects keyPathsByEntityName:prefetchKeyPathsByEntityName context:fetchContext];
+         }
+         
+         dispatch_async(dispatch_get_main_queue(), ^
+                        {
+                            if(fetchOptions && [weak_self.asynchronousFetchProgresses objectForKey:fetchOptions]==progress)
+                                [weak_self.asynchronousFetchProgresses removeObjectForKey:fetchOptions];
+                            
+                            if(progress.isCancelled || !weak_self)
+                                return;
+                            
+                            if(mergesEntities && !error)
+                                [weak_self setMultiEntityFetchOffsets:entityOffsets fetchedCount:pageOffset+objectIDs.count forOptions:coreDataFetchOptions];
+                            
+                            if(error)
+                            {
+                                SCDebugLog(@"Error fetching from the Core Data store: %@, %@", error, [error userInfo]);
+                                if(failure_block)
+                                    failure_block(error);
+                                
+                                return;
+                            }
+                            
+                            // re-materialize the objects in the main context (as faults)
+                            NSMutableArray *objects = [NSMutableArray arrayWithCapacity:objectIDs.count];
+                            for(NSManagedObjectID *objectID in objectIDs)
+                                [objects addObject:[mainContext objectWithID:objectID]];
+                            
+                            if(coreDataFetchOptions.batchSize)
+                                [coreDataFetchOptions incrementBatchOffset];
+                            
+                            [weak_self fetchObjectsSuccessful:objects successBlock:success_block failure:failure_block];
+                        });
+     }];
+}
+
+// overrides superclass
+- (void)asynchronousSearchObjectsForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames withOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    SCDataFetchOptions *searchFetchOptions = [self searchFetchOptionsForString:searchString propertyNames:propertyNames withOptions:fetchOptions];
+    // search results are fetched once, rather than kept live
+    if([searchFetchOptions isKindOfClass:[SCCoreDataFetchOptions class]])
+        [(SCCoreDataFetchOptions *)searchFetchOptions setUsesFetchedResultsController:FALSE];
+    
+    [self asynchronousFetchObjectsWithOptions:searchFetchOptions
+    success:^(NSArray *results)
+     {
+         // keep the batch offset of fetchOptions in step with the searched batches
+         if(fetchOptions.batchSize)
+             [fetchOptions setBatchOffset:searchFetchOptions.batchCurrentOffset];
+         
+         if(success_block)
+             success_block(results);
+     }
+    failure:failure_block noConnection:noConnection_block];
+    
+    // lets the search be cancelled using fetchOptions
+    NSProgress *progress = [self.asynchronousFetchProgresses objectForKey:searchFetchOptions];
+    if(fetchOptions && progress)
+        [self.asynchronousFetchProgresses setObject:progress forKey:fetchOptions];
+}
+
+// overrides superclass
+- (void)cancelAsynchronousFetchWithOptions:(SCDataFetchOptions *)fetchOptions
+{
+    if(!fetchOptions)
+        return;
+    
+    [[self.asynchronousFetchProgresses objectForKey:fetchOptions] cancel];
+    [self.asynchronousFetchProgresses removeObjectForKey:fetchOptions];
+}
+
+- (NSProgress *)progressForAsynchronousFetchWithOptions:(SCDataFetchOptions *)fetchOptions
+{
+    if(!fetchOptions)
+        return nil;
+    
+    return [self.asynchronousFetchProgresses objectForKey:fetchOptions];
+}
+
+// overrides superclass
+- (NSObject *)valueForPropertyName:(NSString *)propertyName inObject:(NSObject *)object
+{
+    SCDataType dataType = [[self definitionForObject:object] propertyDataTypeForPropertyWithName:propertyName];
+    
+    NSObject *value = nil;
+    switch (dataType)
+    {
+        case SCDataTypeNSMutableSet:
+            value = [(NSManagedObject *)object mutableSetValueForKey:propertyName];
+            break;
+            
+        default:
+            value = [super valueForPropertyName:propertyName inObject:object];
+            break;
+    }
+    
+    return value;
+}
+
+// overrides superclass
+- (void)setValue:(NSObject *)value forPropertyName:(NSString *)propertyName inObject:(NSObject *)object
+{
+    if(![SCUtilities propertyName:propertyName existsInObject:object])
+        return;
+    
+    NSArray *keyPathArray = [propertyName componentsSeparatedByString:@"."];
+    if(keyPathArray.count == 1)
+    {
+        [object setValue:value forKey:propertyName];
+    }
+    else
+    {
+        if([object isKindOfClass:[NSManagedObject class]])
+        {
+            // Make sure all entity objects on the path exist, otherwise create them
+            NSManagedObject *mObject = (NSManagedObject *)object;
+            for(int i=0; i<keyPathArray.count-1; i++)
+            {
+                NSString *key = [keyPathArray objectAtIndex:i];
                 NSManagedObject *subObject = [mObject valueForKey:key];
                 if(!subObject)
                 {
@@ -447,6 +1751,8 @@
         }
         [object setValue:value forKeyPath:propertyName];
     }
+    
+    [self invalidateSharedFetchResultsDependingOnPropertyName:propertyName];
 }
 
 // overrides superclass
@@ -503,6 +1809,9 @@
 {
     [super bindStoreToPropertyName:propertyName forObject:object withDefinition:definition];
     
+    // next order values are specific to the bound relationship
+    [self.nextOrderValues removeAllObjects];
+    
     SCPropertyDefinition *propertyDefiniton = [definition propertyDefinitionWithName:propertyName];
     
     self.boundSet = nil;
@@ -558,19 +1867,107 @@
     }
 }
 
++ (NSManagedObjectContext *)mainQueueContextWithWriterContextForPersistentStoreCoordinator:(NSPersistentStoreCoordinator *)coordinator
+{
+    NSManagedObjectContext *writerContext = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSPrivateQueueConcurrencyType];
+    writerContext.persistentStoreCoordinator = coordinator;
+    
+    NSManagedObjectContext *mainContext = [[NSManagedObjectContext alloc] initWithConcurrencyType:NSMainQueueConcurrencyType];
+    mainContext.parentContext = writerContext;
+    
+    return mainContext;
+}
+
 // overrides superclass
 - (void)commitData
 {
-    NSError *error;
-    if (self.managedObjectContext) 
+    if(self.commitScheduled)
+        return;
+    
+    if(![self.managedObjectContext hasChanges])
     {
-        if ([self.managedObjectContext hasChanges] && ![self.managedObjectContext save:&error]) 
-        {
-            SCDebugLog(@"Error commiting the Core Data store: %@, %@", error, [error userInfo]);
-            abort();
-        } 
+        // changes may still be waiting in a parent context (e.g. after one of its saves failed), which is checked on its own queue
+        if(self.managedObjectContext.parentContext)
+            [self saveContext:self.managedObjectContext.parentContext andWait:NO];
+        
+        return;
+    }
+    
+    if(self.commitCoalescingInterval > 0)
+    {
+        self.commitScheduled = TRUE;
+        [self performSelector:@selector(commitScheduledData) withObject:nil afterDelay:self.commitCoalescingInterval];
+    }
+    else
+    {
+        [self saveContext:self.managedObjectContext andWait:NO];
     }
 }
 
+- (void)commitScheduledData
+{
+    self.commitScheduled = FALSE;
+    
+    [self saveContext:self.managedObjectContext andWait:NO];
+}
+
+- (BOOL)commitDataAndWait
+{
+    if(self.commitScheduled)
+    {
+        [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(commitScheduledData) object:nil];
+        self.commitScheduled = FALSE;
+    }
+    
+    return [self saveContext:self.managedObjectContext andWait:YES];
+}
+
+// Saves the given context, then its parent contexts on their own queues. Unless wait is TRUE, the method returns as soon as the first context has been saved, which (for a main queue context with a private queue parent) only pushes the changes to the parent in memory. Returns FALSE if a save failed, or if the parents are saved asynchronously and the first save failed.
+- (BOOL)saveContext:(NSManagedObjectContext *)context andWait:(BOOL)wait
+{
+    if(!context)
+        return TRUE;
+    
+    __block BOOL saved = TRUE;
+    void (^saveBlock)(void) = ^
+    {
+        NSError *error = nil;
+        if([context hasChanges] && ![context save:&error])
+        {
+            saved = FALSE;
+            [self commitDidFailWithError:error];
+            
+            return;
+        }
+        
+        if(context.parentContext)
+            saved = [self saveContext:context.parentContext andWait:wait];
+    };
+    
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+    if(context.concurrencyType == NSConfinementConcurrencyType)
+        saveBlock();
+    else
+        if(wait || context==self.managedObjectContext)
+            [context performBlockAndWait:saveBlock];
+        else
+            [context performBlock:saveBlock];
+#pragma clang diagnostic pop
+    
+    return saved;
+}
+
+- (void)commitDidFailWithError:(NSError *)error
+{
+    SCDebugLog(@"Error commiting the Core Data store: %@, %@", error, [error userInfo]);
+    
+    dispatch_async(dispatch_get_main_queue(), ^
+                   {
+                       NSDictionary *userInfo = error ? [NSDictionary dictionaryWithObject:error forKey:SCDataStoreErrorKey] : nil;
+                       [[NSNotificationCenter defaultCenter] postNotificationName:SCDataStoreDidFailCommitNotification object:self userInfo:userInfo];
+                   });
+}
+
 
 @end
@@ -38,6 +38,8 @@ typedef NSDictionary*(^SCParseStoreFetchObjectsCloudCodeFunctionParametersAction
  
  @note It is very rare when you'll need to create an SCParseStore instance yourself, as it's typically automatically created for you when you use the SCParseDefinition data definition. For example, when you use the SCArrayOfObjectsSection initializer method called [SCArrayOfObjectsSection sectionWithHeaderTitle:parseDefinition:batchSize:], SCArrayOfObjectsSection automatically sets its dataStore property by calling your parseDefinition's [SCDataDefinition generateCompatibleDataStore:] method.
  
+ @note When the store is bound to a relation, the fetch options' filter predicate is translated into constraints on the relation's query. Comparisons, IN, BETWEEN, BEGINSWITH, ENDSWITH, CONTAINS, MATCHES and AND/OR/NOT compounds of these are supported (case insensitive string comparisons become regular expressions). Other predicates, such as key paths into related objects or diacritic insensitive comparisons, are applied to the fetched objects instead, and prevent them from being counted on the server.
+ 
  @note For more information on data stores, check out the SCDataStore base class documentation.
  */
 @interface SCParseStore : SCDataStore
@@ -89,6 +91,83 @@ typedef NSDictionary*(^SCParseStoreFetchObjectsCloudCodeFunctionParametersAction
  */
 @property (nonatomic, copy) SCParseStoreQueryConfiguredAction_Block queryConfiguredAction;
 
+/** When TRUE, each batch after the first one is fetched relative to the last object of the previous batch (keyset paging) instead of skipping all the objects of the previous batches. This keeps the time it takes to fetch a batch constant no matter how many batches have already been fetched. Objects are then ordered by their objectId after the sort key, or by their createdAt date and objectId when the fetch options don't sort. Default: FALSE.
+ 
+ @note Only applicable to batched fetches (see SCDataFetchOptions' batchSize) that are sorted by a single key. Searches and any other fetches fall back to skipping.
+ @warning Parse limits the number of objects a query can skip, so the deep batches of large classes can only be fetched with keyset paging.
+ */
+@property (nonatomic, readwrite) BOOL usesKeysetPaging;
+
+/** The keys (or key paths) of the related objects that are fetched along with the store's objects using PFQuery's includeKey:. Set to an empty array to never fetch related objects. Default: nil (automaticIncludeKeys are used). */
+@property (nonatomic, copy) NSArray *includeKeys;
+
+/** The include keys used when includeKeys is nil. These are the key paths of the related objects that the default definition's titlePropertyName and descriptionPropertyName read, its relation properties (object, object selection and array of objects) that have a user interface for existing objects, and the related objects read by the controls of its custom properties' objectBindings.
+ 
+ @note automaticIncludeKeys are worked out on the first fetch and are reused until the default definition, its number of property definitions, or its title or description property names change. Call invalidateIncludeKeys after changing the type, modes or bindings of a property definition.
+ */
+@property (nonatomic, readonly) NSArray *automaticIncludeKeys;
+
+/** Discards automaticIncludeKeys, so that they're worked out again on the next fetch. */
+- (void)invalidateIncludeKeys;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Caching and Local Datastore
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** The cache policy of the queries that fetch the store's objects. Set to kPFCachePolicyCacheThenNetwork to show the cached results of a fetch right away while its fresh results are fetched, kPFCachePolicyNetworkElseCache to fall back to the cached results when the network is unavailable, or kPFCachePolicyCacheOnly to never access the network. Default: kPFCachePolicyIgnoreCache.
+ 
+ @note When a fetch delivers its cached results first, any differences in the network results are delivered using SCDataStoreDidChangeObjectsNotification, which sections bound to the store use to update only the affected rows.
+ @warning Parse only supports cache policies when its local datastore is disabled, otherwise cachePolicy is ignored. Use pinsFetchedObjects instead.
+ */
+@property (nonatomic, readwrite) PFCachePolicy cachePolicy;
+
+/** When TRUE and the Parse local datastore is enabled (see [Parse enableLocalDatastore]), fetched objects are pinned to the local datastore under pinName, and fetches are answered from the pinned objects first while their network results are fetched. Objects inserted or deleted through the store are pinned or unpinned accordingly. Default: FALSE.
+ 
+ @note As with cachePolicy, any differences in the network results are delivered using SCDataStoreDidChangeObjectsNotification.
+ */
+@property (nonatomic, readwrite) BOOL pinsFetchedObjects;
+
+/** The name that fetched objects are pinned under in the local datastore. Default: a name made of the default definition's class name and, for stores bound to a relation, the id of the bound object and the relation's name. */
+@property (nonatomic, copy) NSString *pinName;
+
+/** Removes all the objects pinned under pinName from the local datastore. */
+- (void)unpinAllFetchedObjects;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Batched Writes
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** The time interval during which the objects inserted, updated and deleted through the store are gathered, then written using a single saveAllInBackground: and deleteAllInBackground: instead of a request per object. The success or failure block of each write is called once its batch has been written. Default: 0 (objects are written immediately).
+ @note Writes made while there's no internet connection are never gathered, since Parse only saves objects eventually one by one.
+ */
+@property (nonatomic, readwrite) NSTimeInterval writeCoalescingInterval;
+
+/** Gathers all the inserts, updates and deletes made through the store while writesBlock executes, then writes them as a single batch regardless of writeCoalescingInterval.
+ 
+ Example:
+ 
+    // Objective-C
+    [myParseStore performBatchedWrites:^
+    {
+        [myParseStore asynchronousUpdateObject:task success:nil failure:nil noConnection:nil];
+        [myParseStore asynchronousUpdateObject:project success:nil failure:nil noConnection:nil];
+    }];
+ 
+    // Swift
+    myParseStore.performBatchedWrites
+    {
+        myParseStore.asynchronousUpdateObject(task, success: nil, failure: nil, noConnection: nil)
+        myParseStore.asynchronousUpdateObject(project, success: nil, failure: nil, noConnection: nil)
+    }
+ 
+ */
+- (void)performBatchedWrites:(void (^)(void))writesBlock;
+
+/** Immediately writes all the gathered inserts, updates and deletes. Called automatically when the application enters the background. */
+- (void)flushPendingWrites;
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 /// @name Cloud Code Configuration
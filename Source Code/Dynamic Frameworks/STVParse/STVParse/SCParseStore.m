@@ -23,12 +23,77 @@
 #import "SCParseStore.h"
 
 
+/* Adds a single constraint to a query, translated from part of a predicate */
+typedef void(^SCParseQueryConstraint_Block)(PFQuery *query);
+
+
+/* Internal class that remembers where the last fetched batch of a fetch ended, used for keyset paging */
+@interface SCParseFetchCursor : NSObject
+
+@property (nonatomic, readwrite) NSUInteger nextBatchStartIndex;
+@property (nonatomic, strong) id sortValue;
+@property (nonatomic, copy) NSString *objectId;
+
+@end
+
+@implementation SCParseFetchCursor
+
+@end
+
+
+
+/* Internal class that holds a write waiting for its batch to be flushed */
+@interface SCParsePendingWrite : NSObject
+
+@property (nonatomic, strong) PFObject *object;
+@property (nonatomic, copy) PFBooleanResultBlock block;
+
+@end
+
+@implementation SCParsePendingWrite
+
+@end
+
+
+
 
 @interface SCParseStore ()
 {
     PFRelation *_boundRelation;
+    NSMapTable *_fetchCursors;
+    
+    NSMutableArray *_pendingSaves;
+    NSMutableArray *_pendingDeletes;
+    NSUInteger _batchedWritesDepth;
+    
+    NSArray *_automaticIncludeKeys;
+    __weak SCDataDefinition *_includeKeysDefinition;
+    NSUInteger _includeKeysPropertyDefinitionCount;
+    NSString *_includeKeysTitlePropertyName;
+    NSString *_includeKeysDescriptionPropertyName;
 }
 
+@property (nonatomic, readwrite) BOOL writesFlushScheduled;
+
+- (void)saveObjectInBackground:(PFObject *)object block:(PFBooleanResultBlock)block;
+- (void)deleteObjectInBackground:(PFObject *)object block:(PFBooleanResultBlock)block;
+- (void)flushScheduledWrites;
+- (void (^)(void))beginBackgroundTaskForWrites;
+
+- (NSString *)keysetSortKeyForOptions:(SCDataFetchOptions *)fetchOptions searches:(BOOL)searches;
+- (void)updateFetchCursorForOptions:(SCDataFetchOptions *)fetchOptions keysetSortKey:(NSString *)keysetSortKey batchStartIndex:(NSUInteger)batchStartIndex fetchedObjects:(NSArray *)objects;
+
+- (NSArray *)subqueryConstraintsForPredicate:(NSPredicate *)predicate allowsOrQuery:(BOOL)allowsOrQuery residualPredicate:(NSPredicate **)residualPredicate;
+- (NSArray *)queryConstraintsForPredicate:(NSPredicate *)predicate;
+- (NSArray *)queryConstraintsForComparisonPredicate:(NSComparisonPredicate *)predicate negated:(BOOL)negated;
+- (PFQuery *)queryWithSubqueryConstraints:(NSArray *)subqueryConstraints newQuery:(PFQuery *(^)(void))newQuery;
+
+- (void)addIncludeKeysForKeyPaths:(NSString *)keyPaths toSet:(NSMutableOrderedSet *)includeKeys;
+
+- (BOOL)usesLocalDatastore;
+- (void)pinObjects:(NSArray *)objects;
+- (void)unpinObjects:(NSArray *)objects;
+
 @end
 
 
@@ -47,6 +112,21 @@
         self.storeMode = SCStoreModeAsynchronous;
         
         self.supportsNilValues = NO;
+        
+        _cachePolicy = kPFCachePolicyIgnoreCache;
+        _pinsFetchedObjects = FALSE;
+        _pinName = nil;
+        _usesKeysetPaging = FALSE;
+        _fetchCursors = [NSMapTable weakToStrongObjectsMapTable];
+        
+        _writeCoalescingInterval = 0;
+        _pendingSaves = [[NSMutableArray alloc] init];
+        _pendingDeletes = [[NSMutableArray alloc] init];
+        _batchedWritesDepth = 0;
+        _writesFlushScheduled = FALSE;
+        
+        _includeKeys = nil;
+        _automaticIncludeKeys = nil;
     }
     return self;
 }
@@ -71,6 +151,8 @@
     {
         PFObject *parseObject = (PFObject *)object;
         [parseObject removeObjectForKey:propertyName];
+        
+        [self markPropertyName:propertyName dirtyInObject:object];
     }
 }
 
@@ -85,6 +167,60 @@
 }
 
 
+- (NSString *)pinName
+{
+    if(_pinName)
+        return _pinName;
+    
+    // each bound relation gets its own pin, so that its objects can be queried locally without the relation
+    NSString *className = self.defaultParseDefinition.className;
+    if(!_boundObject)
+        return [NSString stringWithFormat:@"SCParseStore-%@", className];
+    
+    NSString *boundObjectId = nil;
+    if([_boundObject isKindOfClass:[PFObject class]])
+        boundObjectId = [(PFObject *)_boundObject objectId];
+    if(!boundObjectId)
+        return nil;  // unsaved objects have no relation objects to pin
+    
+    return [NSString stringWithFormat:@"SCParseStore-%@-%@-%@", className, boundObjectId, _boundPropertyName];
+}
+
+- (BOOL)usesLocalDatastore
+{
+    return (self.pinsFetchedObjects && [Parse isLocalDatastoreEnabled] && self.pinName);
+}
+
+- (void)pinObjects:(NSArray *)objects
+{
+    if(!objects.count || ![self usesLocalDatastore])
+        return;
+    
+    NSString *pinName = self.pinName;
+    [PFObject pinAllInBackground:objects withName:pinName block:^(BOOL succeeded, NSError *error)
+     {
+         if(!succeeded)
+             SCDebugLog(@"Warning: SCParseStore - unable to pin objects with name '%@': %@", pinName, error);
+     }];
+}
+
+- (void)unpinObjects:(NSArray *)objects
+{
+    if(!objects.count || ![self usesLocalDatastore])
+        return;
+    
+    [PFObject unpinAllInBackground:objects withName:self.pinName block:nil];
+}
+
+- (void)unpinAllFetchedObjects
+{
+    if(![Parse isLocalDatastoreEnabled] || !self.pinName)
+        return;
+    
+    [PFObject unpinAllObjectsInBackgroundWithName:self.pinName block:nil];
+}
+
+
 - (void)setParseAppIdAndCliendKeyForObject:(PFObject *)object
 {
     if(![[Parse getApplicationId] length])
@@ -111,6 +247,30 @@
     return definition;
 }
 
+// overrides superclass
+- (id)objectIdForObject:(NSObject *)object
+{
+    if(![object isKindOfClass:[PFObject class]])
+        return nil;
+    
+    return [(PFObject *)object objectId];
+}
+
+// overrides superclass
+- (BOOL)object:(NSObject *)object isUnchangedFromObject:(NSObject *)previousObject
+{
+    if(![object isKindOfClass:[PFObject class]] || ![previousObject isKindOfClass:[PFObject class]])
+        return [super object:object isUnchangedFromObject:previousObject];
+    
+    // each fetch returns new PFObject instances, so they are compared by the time they were last saved
+    PFObject *parseObject = (PFObject *)object;
+    PFObject *previousParseObject = (PFObject *)previousObject;
+    if(![parseObject.objectId isEqualToString:previousParseObject.objectId])
+        return FALSE;
+    
+    return (parseObject.updatedAt==previousParseObject.updatedAt || [parseObject.updatedAt isEqualToDate:previousParseObject.updatedAt]);
+}
+
 // overrides superclass
 - (void)bindStoreToPropertyName:(NSString *)propertyName forObject:(NSObject *)object withDefinition:(SCDataDefinition *)definition
 {
@@ -181,14 +341,18 @@
     [self setParseAppIdAndCliendKeyForObject:parseObject];
     
     PFRelation *relation = _boundRelation;  // to avoid unnecessarily retaining self in block
+    NSSet *sentPropertyNames = [self dirtyPropertyNamesForObject:object];
+    __weak typeof(self) weak_self = self;
     if([SCUtilities IsInternetConnectionAvailable])
     {
-        [parseObject saveInBackgroundWithBlock:^(BOOL succeeded, NSError *error)
+        [self saveObjectInBackground:parseObject block:^(BOOL succeeded, NSError *error)
          {
              if(succeeded)
              {
                  if(relation)
                      [relation addObject:(PFObject *)object];
+                 [weak_self clearDirtyPropertyNames:sentPropertyNames forObject:object];
+                 [weak_self pinObjects:[NSArray arrayWithObject:object]];
                  
                  if(success_block)
                      success_block();
@@ -214,6 +378,8 @@
                  {
                      if(relation)
                          [relation addObject:(PFObject *)object];
+                     [weak_self clearDirtyPropertyNames:sentPropertyNames forObject:object];
+                     [weak_self pinObjects:[NSArray arrayWithObject:object]];
                      
                      if(success_block)
                          success_block();
@@ -237,14 +403,28 @@
 - (void)asynchronousUpdateObject:(NSObject *)object success:(SCDataStoreUpdateSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
 {
     PFObject *parseObject = (PFObject *)object;
+    
+    // skip the save round-trip when nothing has changed since the last fetch or save
+    if(![self objectHasDirtyProperties:parseObject] && !parseObject.isDirty)
+    {
+        if(success_block)
+            success_block();
+        
+        return;
+    }
+    
     [self setParseAppIdAndCliendKeyForObject:parseObject];
     
+    NSSet *sentPropertyNames = [self dirtyPropertyNamesForObject:parseObject];
+    __weak typeof(self) weak_self = self;
     if([SCUtilities IsInternetConnectionAvailable])
     {
-        [parseObject saveInBackgroundWithBlock:^(BOOL succeeded, NSError *error)
+        [self saveObjectInBackground:parseObject block:^(BOOL succeeded, NSError *error)
          {
              if(succeeded)
              {
+                 [weak_self clearDirtyPropertyNames:sentPropertyNames forObject:parseObject];
+                 
                  if(success_block)
                      success_block();
              }
@@ -267,6 +447,8 @@
              {
                  if(succeeded)
                  {
+                     [weak_self clearDirtyPropertyNames:sentPropertyNames forObject:parseObject];
+                     
                      if(success_block)
                          success_block();
                  }
@@ -295,27 +477,36 @@
     }
     else
     {
+        // only the relation changes, which takes a save of the bound object
         parseObject = (PFObject *)_boundObject;
         [_boundRelation removeObject:(PFObject *)object];
     }
     
     [self setParseAppIdAndCliendKeyForObject:parseObject];
     
+    __weak typeof(self) weak_self = self;
+    PFBooleanResultBlock completionBlock = ^(BOOL succeeded, NSError *error)
+    {
+        if(succeeded)
+        {
+            [weak_self unpinObjects:[NSArray arrayWithObject:object]];
+            
+            if(success_block)
+                success_block();
+        }
+        else
+        {
+            if(failure_block)
+                failure_block(error);
+        }
+    };
+    
     if([SCUtilities IsInternetConnectionAvailable])
     {
-        [parseObject deleteInBackgroundWithBlock:^(BOOL succeeded, NSError *error)
-         {
-             if(succeeded)
-             {
-                 if(success_block)
-                     success_block();
-             }
-             else
-             {
-                 if(failure_block)
-                     failure_block(error);
-             }
-         }];
+        if(!_boundRelation)
+            [self deleteObjectInBackground:parseObject block:completionBlock];
+        else
+            [self saveObjectInBackground:parseObject block:completionBlock];
     }
     else
     {
@@ -326,7 +517,11 @@
         if(tryAgainLater)
         {
             
-            [parseObject deleteEventually]; // Parse API does not yet support [deleteEventually:block]
+            if(!_boundRelation)
+                [parseObject deleteEventually]; // Parse API does not yet support [deleteEventually:block]
+            else
+                [parseObject saveEventually];
+            [self unpinObjects:[NSArray arrayWithObject:object]];
             if(success_block)
                 success_block();
         }
@@ -338,8 +533,266 @@
     }
 }
 
+// Saves the object right away, or with its batch of writes when writes are being gathered
+- (void)saveObjectInBackground:(PFObject *)object block:(PFBooleanResultBlock)block
+{
+    if(!_batchedWritesDepth && self.writeCoalescingInterval<=0)
+    {
+        [object saveInBackgroundWithBlock:block];
+        return;
+    }
+    
+    SCParsePendingWrite *write = [[SCParsePendingWrite alloc] init];
+    write.object = object;
+    write.block = block;
+    [_pendingSaves addObject:write];
+    
+    if(!_batchedWritesDepth && !self.writesFlushScheduled)
+    {
+        self.writesFlushScheduled = TRUE;
+        [self performSelector:@selector(flushScheduledWrites) withObject:nil afterDelay:self.writeCoalescingInterval];
+    }
+}
+
+// Deletes the object right away, or with its batch of writes when writes are being gathered
+- (void)deleteObjectInBackground:(PFObject *)object block:(PFBooleanResultBlock)block
+{
+    if(!_batchedWritesDepth && self.writeCoalescingInterval<=0)
+    {
+        [object deleteInBackgroundWithBlock:block];
+        return;
+    }
+    
+    SCParsePendingWrite *write = [[SCParsePendingWrite alloc] init];
+    write.object = object;
+    write.block = block;
+    [_pendingDeletes addObject:write];
+    
+    if(!_batchedWritesDepth && !self.writesFlushScheduled)
+    {
+        self.writesFlushScheduled = TRUE;
+        [self performSelector:@selector(flushScheduledWrites) withObject:nil afterDelay:self.writeCoalescingInterval];
+    }
+}
+
+- (void)performBatchedWrites:(void (^)(void))writesBlock
+{
+    _batchedWritesDepth++;
+    if(writesBlock)
+        writesBlock();
+    _batchedWritesDepth--;
+    
+    if(!_batchedWritesDepth)
+        [self flushPendingWrites];
+}
+
+// Keeps the app running until the batched writes are done, since they're typically flushed when the app enters the background. Returns the block that ends the task.
+- (void (^)(void))beginBackgroundTaskForWrites
+{
+    __block UIBackgroundTaskIdentifier backgroundTask = UIBackgroundTaskInvalid;
+    void (^endBackgroundTask)(void) = ^
+    {
+        if(backgroundTask == UIBackgroundTaskInvalid)
+            return;
+        
+        [[UIApplication sharedApplication] endBackgroundTask:backgroundTask];
+        backgroundTask = UIBackgroundTaskInvalid;
+    };
+    backgroundTask = [[UIApplication sharedApplication] beginBackgroundTaskWithExpirationHandler:endBackgroundTask];
+    
+    return endBackgroundTask;
+}
+
+- (void)flushScheduledWrites
+{
+    self.writesFlushScheduled = FALSE;
+    
+    [self flushPendingWrites];
+}
+
+- (void)flushPendingWrites
+{
+    if(self.writesFlushScheduled)
+    {
+        [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(flushScheduledWrites) object:nil];
+        self.writesFlushScheduled = FALSE;
+    }
+    
+    NSArray *saves = [NSArray arrayWithArray:_pendingSaves];
+    NSArray *deletes = [NSArray arrayWithArray:_pendingDeletes];
+    [_pendingSaves removeAllObjects];
+    [_pendingDeletes removeAllObjects];
+    if(!saves.count && !deletes.count)
+        return;
+    
+    // the same object can be written more than once within a batch
+    NSArray *(^objectsOfWrites)(NSArray *) = ^NSArray *(NSArray *writes)
+    {
+        NSHashTable *addedObjects = [NSHashTable hashTableWithOptions:NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality];
+        NSMutableArray *objects = [NSMutableArray arrayWithCapacity:writes.count];
+        for(SCParsePendingWrite *write in writes)
+        {
+            if([addedObjects containsObject:write.object])
+                continue;
+            [addedObjects addObject:write.object];
+            [objects addObject:write.object];
+        }
+        return objects;
+    };
+    
+    void (^endBackgroundTask)(void) = [self beginBackgroundTaskForWrites];
+    
+    // deletes wait for the saves, in case an object is saved and then deleted within the same batch
+    void (^flushDeletes)(void) = ^
+    {
+        if(!deletes.count)
+        {
+            endBackgroundTask();
+            return;
+        }
+        
+        [PFObject deleteAllInBackground:objectsOfWrites(deletes) block:^(BOOL succeeded, NSError *error)
+         {
+             for(SCParsePendingWrite *write in deletes)
+             {
+                 if(write.block)
+                     write.block(succeeded, error);
+             }
+             
+             endBackgroundTask();
+         }];
+    };
+    
+    SCParsePendingWrite *firstWrite = saves.count ? [saves objectAtIndex:0] : [deletes objectAtIndex:0];
+    [self setParseAppIdAndCliendKeyForObject:firstWrite.object];
+    
+    if(!saves.count)
+    {
+        flushDeletes();
+        return;
+    }
+    
+    [PFObject saveAllInBackground:objectsOfWrites(saves) block:^(BOOL succeeded, NSError *error)
+     {
+         for(SCParsePendingWrite *write in saves)
+         {
+             // a failed batch can still have saved some of its objects
+             BOOL saved = succeeded || (write.object.objectId && !write.object.isDirty);
+             if(write.block)
+                 write.block(saved, saved ? nil : error);
+         }
+         
+         flushDeletes();
+     }];
+}
+
+// overrides superclass
+- (void)commitData
+{
+    // make sure gathered writes aren't lost when the application enters the background
+    [self flushPendingWrites];
+}
+
+// overrides superclass
+- (void)asynchronousUpdateObjects:(NSArray *)objects withPropertyValues:(NSDictionary *)propertyValues success:(SCDataStoreUpdateSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    if(!objects.count || ![SCUtilities IsInternetConnectionAvailable])
+    {
+        // saving eventually is only possible object by object
+        [super asynchronousUpdateObjects:objects withPropertyValues:propertyValues success:success_block failure:failure_block noConnection:noConnection_block];
+        
+        return;
+    }
+    
+    for(NSObject *object in objects)
+    {
+        for(NSString *propertyName in propertyValues)
+            [self setValue:[propertyValues valueForKey:propertyName] forPropertyName:propertyName inObject:object];
+    }
+    [self setParseAppIdAndCliendKeyForObject:[objects objectAtIndex:0]];
+    
+    NSMapTable *sentPropertyNames = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality valueOptions:NSPointerFunctionsStrongMemory];
+    for(NSObject *object in objects)
+        [sentPropertyNames setObject:[self dirtyPropertyNamesForObject:object] forKey:object];
+    
+    void (^endBackgroundTask)(void) = [self beginBackgroundTaskForWrites];
+    __weak typeof(self) weak_self = self;
+    [PFObject saveAllInBackground:objects block:^(BOOL succeeded, NSError *error)
+     {
+         if(succeeded)
+         {
+             for(NSObject *object in objects)
+                 [weak_self clearDirtyPropertyNames:[sentPropertyNames objectForKey:object] forObject:object];
+             
+             if(success_block)
+                 success_block();
+         }
+         else
+         {
+             if(failure_block)
+                 failure_block(error);
+         }
+         
+         endBackgroundTask();
+     }];
+}
+
+// overrides superclass
+- (void)asynchronousDeleteObjects:(NSArray *)objects success:(SCDataStoreDeleteSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    if(!objects.count || ![SCUtilities IsInternetConnectionAvailable])
+    {
+        // deleting eventually is only possible object by object
+        [super asynchronousDeleteObjects:objects success:success_block failure:failure_block noConnection:noConnection_block];
+        
+        return;
+    }
+    
+    [self setParseAppIdAndCliendKeyForObject:[objects objectAtIndex:0]];
+    
+    __weak typeof(self) weak_self = self;
+    void (^completionBlock)(BOOL succeeded, NSError *error) = ^(BOOL succeeded, NSError *error)
+    {
+        if(succeeded)
+        {
+            [weak_self unpinObjects:objects];
+            
+            if(success_block)
+                success_block();
+        }
+        else
+        {
+            if(failure_block)
+                failure_block(error);
+        }
+    };
+    
+    if(!_boundRelation)
+    {
+        [PFObject deleteAllInBackground:objects block:completionBlock];
+    }
+    else
+    {
+        // only the relation changes, which takes a single save of the bound object
+        for(PFObject *object in objects)
+            [_boundRelation removeObject:object];
+        [(PFObject *)_boundObject saveInBackgroundWithBlock:completionBlock];
+    }
+}
+
 // overrides superclass
 - (void)asynchronousFetchObjectsWithOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    [self asynchronousFetchObjectsWithOptions:fetchOptions searchString:nil propertyNames:nil success:success_block failure:failure_block noConnection:noConnection_block];
+}
+
+// overrides superclass
+- (void)asynchronousSearchObjectsForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames withOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    [self asynchronousFetchObjectsWithOptions:fetchOptions searchString:searchString propertyNames:propertyNames success:success_block failure:failure_block noConnection:noConnection_block];
+}
+
+- (void)asynchronousFetchObjectsWithOptions:(SCDataFetchOptions *)fetchOptions searchString:(NSString *)searchString propertyNames:(NSArray *)propertyNames success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
 {
     if(![[Parse getApplicationId] length])
     {
@@ -371,13 +824,32 @@
     {
         if(!self.fetchObjectsCloudCodeFunctionName)
         {
-            [self asynchronousFetchObjectsUsingQueryWithOptions:fetchOptions success:success_block failure:failure_block];
+            [self asynchronousFetchObjectsUsingQueryWithOptions:fetchOptions searchString:searchString propertyNames:propertyNames success:success_block failure:failure_block];
         }
         else
         {
-            [self asynchronousFetchObjectsUsingCloudCodeWithOptions:fetchOptions success:success_block failure:failure_block];
+            if([searchString length])
+            {
+                // cloud code functions can't be searched, so their results are searched locally
+                NSPredicate *searchPredicate = [self searchPredicateForString:searchString propertyNames:propertyNames];
+                [self asynchronousFetchObjectsUsingCloudCodeWithOptions:fetchOptions success:^(NSArray *results)
+                 {
+                     if(success_block)
+                         success_block([results filteredArrayUsingPredicate:searchPredicate]);
+                 }
+                failure:failure_block];
+            }
+            else
+            {
+                [self asynchronousFetchObjectsUsingCloudCodeWithOptions:fetchOptions success:success_block failure:failure_block];
+            }
         }
     }
+    else if(!self.fetchObjectsCloudCodeFunctionName && ([self usesLocalDatastore] || (![Parse isLocalDatastoreEnabled] && self.cachePolicy!=kPFCachePolicyIgnoreCache && self.cachePolicy!=kPFCachePolicyNetworkOnly)))
+    {
+        // pinned or cached objects can still be fetched
+        [self asynchronousFetchObjectsUsingQueryWithOptions:fetchOptions searchString:searchString propertyNames:propertyNames success:success_block failure:failure_block];
+    }
     else
     {
         BOOL tryAgainLater = YES;
@@ -398,76 +870,700 @@
     }
 }
 
-- (void)asynchronousFetchObjectsUsingQueryWithOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block
+// Returns a query for the objects that satisfy filterPredicate and have at least one of the given properties containing searchString, case insensitively
+- (PFQuery *)searchQueryForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames filterPredicate:(NSPredicate *)filterPredicate
 {
-    NSPredicate *filterPredicate = nil;
-    if(fetchOptions.filter)
-        filterPredicate = fetchOptions.filterPredicate;
+    NSString *searchPattern = [NSRegularExpression escapedPatternForString:searchString];
     
-    PFQuery *query;
-    if(!_boundRelation)
-    {
-        query = [PFQuery queryWithClassName:self.defaultParseDefinition.className predicate:filterPredicate];
-    }
-    else
-    {
-        query = [_boundRelation query];
-        
-        // apply filterPredicate after objects are fetched, since PFQuery does not yet support assigning a predicate after creation
-    }
-    
-    if(!query)
+    NSMutableArray *subqueries = [NSMutableArray arrayWithCapacity:propertyNames.count];
+    for(NSString *propertyName in propertyNames)
     {
-        SCDebugLog(@"Warning: SCParseStore - unexpected unable to initiate PFQuery.");
-        if(failure_block)
-            failure_block([NSError errorWithDomain:@"Unable to initiate PFQuery" code:0 userInfo:nil]);
-        
-        return;
+        PFQuery *subquery = [PFQuery queryWithClassName:self.defaultParseDefinition.className predicate:filterPredicate];
+        [subquery whereKey:propertyName matchesRegex:searchPattern modifiers:@"i"];
+        [subqueries addObject:subquery];
     }
     
-    if(fetchOptions.sort)
+    if(subqueries.count == 1)
+        return [subqueries objectAtIndex:0];
+    //else
+    return [PFQuery orQueryWithSubqueries:subqueries];
+}
+
+// Returns the key that keyset paging orders the objects of fetchOptions by, or nil if they can only be paged by skipping
+- (NSString *)keysetSortKeyForOptions:(SCDataFetchOptions *)fetchOptions searches:(BOOL)searches
+{
+    // search queries are already compound queries, and relation queries can't be combined into the OR query that keyset paging needs
+    if(!self.usesKeysetPaging || !fetchOptions.batchSize || searches || _boundRelation)
+        return nil;
+    
+    if(!fetchOptions.sort)
+        return @"createdAt";
+    
+    NSString *sortKey = fetchOptions.sortKey;
+    if(![sortKey length] || [sortKey rangeOfString:@";"].location!=NSNotFound || [sortKey rangeOfString:@"."].location!=NSNotFound)
+        return nil;
+    //else
+    return sortKey;
+}
+
+// Remembers the position of the last of the given objects, fetched as the batch starting at batchStartIndex
+- (void)updateFetchCursorForOptions:(SCDataFetchOptions *)fetchOptions keysetSortKey:(NSString *)keysetSortKey batchStartIndex:(NSUInteger)batchStartIndex fetchedObjects:(NSArray *)objects
+{
+    if(!keysetSortKey)
+        return;
+    
+    SCParseFetchCursor *cursor = [_fetchCursors objectForKey:fetchOptions];
+    if(cursor.nextBatchStartIndex > batchStartIndex+fetchOptions.batchSize)
+        return;  // a later batch has already been fetched
+    
+    PFObject *lastObject = [objects lastObject];
+    if(objects.count < fetchOptions.batchSize || ![lastObject isKindOfClass:[PFObject class]])
     {
-        if(fetchOptions.sortAscending)
-            [query orderByAscending:fetchOptions.sortKey];
+        // no more batches to fetch
+        [_fetchCursors removeObjectForKey:fetchOptions];
+        return;
+    }
+    
+    cursor = [[SCParseFetchCursor alloc] init];
+    cursor.nextBatchStartIndex = batchStartIndex + fetchOptions.batchSize;
+    if([keysetSortKey isEqualToString:@"createdAt"])
+        cursor.sortValue = lastObject.createdAt;
+    else
+        if([keysetSortKey isEqualToString:@"updatedAt"])
+            cursor.sortValue = lastObject.updatedAt;
         else
-            [query orderByDescending:fetchOptions.sortKey];
+            cursor.sortValue = [lastObject objectForKey:keysetSortKey];
+    cursor.objectId = lastObject.objectId;
+    [_fetchCursors setObject:cursor forKey:fetchOptions];
+}
+
+// Translates predicate into query constraints, returning an array with the constraints of each subquery of an OR query (or a single array for a plain query, which is always the case when allowsOrQuery is FALSE). The parts of predicate that can't be translated are returned in residualPredicate.
+- (NSArray *)subqueryConstraintsForPredicate:(NSPredicate *)predicate allowsOrQuery:(BOOL)allowsOrQuery residualPredicate:(NSPredicate **)residualPredicate
+{
+    NSArray *conjuncts;
+    if([predicate isKindOfClass:[NSCompoundPredicate class]] && [(NSCompoundPredicate *)predicate compoundPredicateType]==NSAndPredicateType)
+        conjuncts = [(NSCompoundPredicate *)predicate subpredicates];
+    else
+        if(predicate)
+            conjuncts = [NSArray arrayWithObject:predicate];
+        else
+            conjuncts = [NSArray array];
+    
+    NSMutableArray *commonConstraints = [NSMutableArray array];
+    NSMutableArray *disjunctConstraints = nil;
+    NSMutableArray *residualConjuncts = [NSMutableArray array];
+    for(NSPredicate *conjunct in conjuncts)
+    {
+        NSArray *constraints = [self queryConstraintsForPredicate:conjunct];
+        if(constraints)
+        {
+            [commonConstraints addObjectsFromArray:constraints];
+            continue;
+        }
+        
+        // a single OR can be translated into subqueries (e.g. a search over several properties)
+        if(allowsOrQuery && !disjunctConstraints && [conjunct isKindOfClass:[NSCompoundPredicate class]] && [(NSCompoundPredicate *)conjunct compoundPredicateType]==NSOrPredicateType)
+        {
+            NSArray *disjuncts = [(NSCompoundPredicate *)conjunct subpredicates];
+            disjunctConstraints = [NSMutableArray arrayWithCapacity:disjuncts.count];
+            for(NSPredicate *disjunct in disjuncts)
+            {
+                constraints = [self queryConstraintsForPredicate:disjunct];
+                if(!constraints)
+                {
+                    disjunctConstraints = nil;
+                    break;
+                }
+                [disjunctConstraints addObject:constraints];
+            }
+            if(disjunctConstraints.count)
+                continue;
+            //else
+            disjunctConstraints = nil;
+        }
+        
+        [residualConjuncts addObject:conjunct];
+    }
+    
+    if(residualPredicate)
+    {
+        if(!residualConjuncts.count)
+            *residualPredicate = nil;
+        else
+            if(residualConjuncts.count == 1)
+                *residualPredicate = [residualConjuncts objectAtIndex:0];
+            else
+                *residualPredicate = [NSCompoundPredicate andPredicateWithSubpredicates:residualConjuncts];
+    }
+    
+    if(!disjunctConstraints)
+        return [NSArray arrayWithObject:commonConstraints];
+    
+    NSMutableArray *subqueryConstraints = [NSMutableArray arrayWithCapacity:disjunctConstraints.count];
+    for(NSArray *constraints in disjunctConstraints)
+        [subqueryConstraints addObject:[commonConstraints arrayByAddingObjectsFromArray:constraints]];
+    return subqueryConstraints;
+}
+
+// Returns the constraints that add predicate to a query, or nil if predicate can't be expressed using query constraints
+- (NSArray *)queryConstraintsForPredicate:(NSPredicate *)predicate
+{
+    if([predicate isKindOfClass:[NSComparisonPredicate class]])
+        return [self queryConstraintsForComparisonPredicate:(NSComparisonPredicate *)predicate negated:FALSE];
+    
+    if([predicate isKindOfClass:[NSCompoundPredicate class]])
+    {
+        NSCompoundPredicate *compoundPredicate = (NSCompoundPredicate *)predicate;
+        switch(compoundPredicate.compoundPredicateType)
+        {
+            case NSAndPredicateType:
+            {
+                NSMutableArray *constraints = [NSMutableArray array];
+                for(NSPredicate *subpredicate in compoundPredicate.subpredicates)
+                {
+                    NSArray *subpredicateConstraints = [self queryConstraintsForPredicate:subpredicate];
+                    if(!subpredicateConstraints)
+                        return nil;
+                    [constraints addObjectsFromArray:subpredicateConstraints];
+                }
+                return constraints;
+            }
+            
+            case NSNotPredicateType:
+            {
+                NSPredicate *subpredicate = [compoundPredicate.subpredicates lastObject];
+                if(compoundPredicate.subpredicates.count==1 && [subpredicate isKindOfClass:[NSComparisonPredicate class]])
+                    return [self queryConstraintsForComparisonPredicate:(NSComparisonPredicate *)subpredicate negated:TRUE];
+                //else
+                return nil;
+            }
+            
+            default:
+                return nil;  // nested ORs can't be expressed as constraints of a single query
+        }
     }
+    
+    if([predicate isEqual:[NSPredicate predicateWithValue:TRUE]])
+        return [NSArray array];
+    //else
+    return nil;
+}
+
+// Returns the constraints that add predicate (or its negation) to a query, or nil if it can't be expressed using query constraints
+- (NSArray *)queryConstraintsForComparisonPredicate:(NSComparisonPredicate *)predicate negated:(BOOL)negated
+{
+    NSExpression *keyExpression = predicate.leftExpression;
+    NSExpression *valueExpression = predicate.rightExpression;
+    NSPredicateOperatorType operatorType = predicate.predicateOperatorType;
+    if(keyExpression.expressionType!=NSKeyPathExpressionType && valueExpression.expressionType==NSKeyPathExpressionType)
+    {
+        // the key is on the right side (e.g. 5 < count)
+        keyExpression = predicate.rightExpression;
+        valueExpression = predicate.leftExpression;
+        switch(operatorType)
+        {
+            case NSLessThanPredicateOperatorType:
+                operatorType = NSGreaterThanPredicateOperatorType;
+                break;
+            case NSLessThanOrEqualToPredicateOperatorType:
+                operatorType = NSGreaterThanOrEqualToPredicateOperatorType;
+                break;
+            case NSGreaterThanPredicateOperatorType:
+                operatorType = NSLessThanPredicateOperatorType;
+                break;
+            case NSGreaterThanOrEqualToPredicateOperatorType:
+                operatorType = NSLessThanOrEqualToPredicateOperatorType;
+                break;
+            case NSEqualToPredicateOperatorType:
+            case NSNotEqualToPredicateOperatorType:
+                break;
+            
+            default:
+                return nil;
+        }
+    }
+    
+    if(keyExpression.expressionType != NSKeyPathExpressionType)
+        return nil;
+    NSString *key = keyExpression.keyPath;
+    // key paths into related objects would need matchesQuery subqueries
+    if(![key length] || [key rangeOfString:@"."].location!=NSNotFound || [key hasPrefix:@"@"])
+        return nil;
+    
+    id value;
+    if(valueExpression.expressionType == NSConstantValueExpressionType)
+    {
+        value = valueExpression.constantValue;
+    }
+    else
+    {
+        // constant aggregates (e.g. IN {1, 2, 3})
+        if(valueExpression.expressionType != NSAggregateExpressionType || ![valueExpression.collection isKindOfClass:[NSArray class]])
+            return nil;
+        
+        NSMutableArray *values = [NSMutableArray array];
+        for(NSExpression *expression in valueExpression.collection)
+        {
+            if(expression.expressionType!=NSConstantValueExpressionType || !expression.constantValue)
+                return nil;
+            [values addObject:expression.constantValue];
+        }
+        value = values;
+    }
+    if([value isKindOfClass:[NSNull class]])
+        value = nil;
+    else
+        if([value isKindOfClass:[NSSet class]])
+            value = [(NSSet *)value allObjects];
+        else
+            if([value isKindOfClass:[NSOrderedSet class]])
+                value = [(NSOrderedSet *)value array];
+    NSString *stringValue = [value isKindOfClass:[NSString class]] ? value : nil;
+    
+    // Parse queries can only ignore case using regular expressions, and can't ignore diacritics at all
+    if(predicate.options & NSDiacriticInsensitivePredicateOption)
+        return nil;
+    BOOL caseInsensitive = (predicate.options & NSCaseInsensitivePredicateOption) != 0;
+    
+    if(predicate.comparisonPredicateModifier == NSAnyPredicateModifier)
+    {
+        // equality on an array key already matches the objects whose array contains the value
+        if(operatorType!=NSEqualToPredicateOperatorType || negated || caseInsensitive || !value)
+            return nil;
+    }
+    else
+        if(predicate.comparisonPredicateModifier != NSDirectPredicateModifier)
+            return nil;
+    
+    SCParseQueryConstraint_Block constraint = nil;
+    NSString *regexPattern = nil;
+    switch(operatorType)
+    {
+        case NSEqualToPredicateOperatorType:
+        case NSNotEqualToPredicateOperatorType:
+        {
+            BOOL equal = ((operatorType == NSEqualToPredicateOperatorType) != negated);
+            if(!value)
+            {
+                if(equal)
+                    constraint = ^(PFQuery *query){ [query whereKeyDoesNotExist:key]; };
+                else
+                    constraint = ^(PFQuery *query){ [query whereKeyExists:key]; };
+            }
+            else
+                if(caseInsensitive)
+                {
+                    if(!equal || !stringValue)
+                        return nil;
+                    regexPattern = [NSString stringWithFormat:@"^%@$", [NSRegularExpression escapedPatternForString:stringValue]];
+                }
+                else
+                {
+                    if(equal)
+                        constraint = ^(PFQuery *query){ [query whereKey:key equalTo:value]; };
+                    else
+                        constraint = ^(PFQuery *query){ [query whereKey:key notEqualTo:value]; };
+                }
+        }
+            break;
+        
+        case NSLessThanPredicateOperatorType:
+        case NSLessThanOrEqualToPredicateOperatorType:
+        case NSGreaterThanPredicateOperatorType:
+        case NSGreaterThanOrEqualToPredicateOperatorType:
+            // a negated comparison would also match objects missing the key
+            if(negated || caseInsensitive || !value)
+                return nil;
+            switch(operatorType)
+            {
+                case NSLessThanPredicateOperatorType:
+                    constraint = ^(PFQuery *query){ [query whereKey:key lessThan:value]; };
+                    break;
+                case NSLessThanOrEqualToPredicateOperatorType:
+                    constraint = ^(PFQuery *query){ [query whereKey:key lessThanOrEqualTo:value]; };
+                    break;
+                case NSGreaterThanPredicateOperatorType:
+                    constraint = ^(PFQuery *query){ [query whereKey:key greaterThan:value]; };
+                    break;
+                default:
+                    constraint = ^(PFQuery *query){ [query whereKey:key greaterThanOrEqualTo:value]; };
+                    break;
+            }
+            break;
+        
+        case NSInPredicateOperatorType:
+            if(caseInsensitive || ![value isKindOfClass:[NSArray class]])
+                return nil;
+            if(negated)
+                constraint = ^(PFQuery *query){ [query whereKey:key notContainedIn:value]; };
+            else
+                constraint = ^(PFQuery *query){ [query whereKey:key containedIn:value]; };
+            break;
+        
+        case NSBetweenPredicateOperatorType:
+        {
+            if(negated || caseInsensitive || ![value isKindOfClass:[NSArray class]] || [(NSArray *)value count]!=2)
+                return nil;
+            id lowerValue = [(NSArray *)value objectAtIndex:0];
+            id upperValue = [(NSArray *)value objectAtIndex:1];
+            constraint = ^(PFQuery *query)
+            {
+                [query whereKey:key greaterThanOrEqualTo:lowerValue];
+                [query whereKey:key lessThanOrEqualTo:upperValue];
+            };
+        }
+            break;
+        
+        case NSBeginsWithPredicateOperatorType:
+            if(negated || !stringValue)
+                return nil;
+            if(caseInsensitive)
+                regexPattern = [NSString stringWithFormat:@"^%@", [NSRegularExpression escapedPatternForString:stringValue]];
+            else
+                constraint = ^(PFQuery *query){ [query whereKey:key hasPrefix:stringValue]; };
+            break;
+        
+        case NSEndsWithPredicateOperatorType:
+            if(negated || !stringValue)
+                return nil;
+            if(caseInsensitive)
+                regexPattern = [NSString stringWithFormat:@"%@$", [NSRegularExpression escapedPatternForString:stringValue]];
+            else
+                constraint = ^(PFQuery *query){ [query whereKey:key hasSuffix:stringValue]; };
+            break;
+        
+        case NSContainsPredicateOperatorType:
+        {
+            if(negated || !stringValue)
+                return nil;
+            // CONTAINS on an array key tests membership rather than a substring
+            SCPropertyDefinition *propertyDefinition = [self.defaultParseDefinition propertyDefinitionWithName:key];
+            if(propertyDefinition.dataType==SCDataTypeNSMutableArray || propertyDefinition.type==SCPropertyTypeArrayOfObjects || propertyDefinition.type==SCPropertyTypeObjectSelection)
+                return nil;
+            
+            if(caseInsensitive)
+                regexPattern = [NSRegularExpression escapedPatternForString:stringValue];
+            else
+                constraint = ^(PFQuery *query){ [query whereKey:key containsString:stringValue]; };
+        }
+            break;
+        
+        case NSMatchesPredicateOperatorType:
+            if(negated || !stringValue)
+                return nil;
+            // MATCHES must match the whole string
+            regexPattern = [NSString stringWithFormat:@"^(?:%@)$", stringValue];
+            break;
+        
+        default:
+            return nil;  // LIKE and custom selectors have no query counterpart
+    }
+    
+    if(regexPattern)
+    {
+        NSString *modifiers = caseInsensitive ? @"i" : nil;
+        constraint = ^(PFQuery *query){ [query whereKey:key matchesRegex:regexPattern modifiers:modifiers]; };
+    }
+    
+    return [NSArray arrayWithObject:constraint];
+}
+
+// Returns a query (an OR query if subqueryConstraints has more than one item) with the given constraints applied to queries created by newQuery
+- (PFQuery *)queryWithSubqueryConstraints:(NSArray *)subqueryConstraints newQuery:(PFQuery *(^)(void))newQuery
+{
+    NSMutableArray *subqueries = [NSMutableArray arrayWithCapacity:subqueryConstraints.count];
+    for(NSArray *constraints in subqueryConstraints)
+    {
+        PFQuery *subquery = newQuery();
+        if(!subquery)
+            return nil;
+        
+        for(SCParseQueryConstraint_Block constraint in constraints)
+            constraint(subquery);
+        [subqueries addObject:subquery];
+    }
+    
+    if(subqueries.count == 1)
+        return [subqueries objectAtIndex:0];
+    //else
+    return [PFQuery orQueryWithSubqueries:subqueries];
+}
+
+// Returns the query that fetches the objects satisfying fetchOptions from the network or, when fromLocalDatastore is TRUE, the query's local datastore counterpart. Any filtering that the query can't do is returned in fetchedObjectsPredicate, and must be applied to the fetched objects.
+- (PFQuery *)queryWithOptions:(SCDataFetchOptions *)fetchOptions searchString:(NSString *)searchString propertyNames:(NSArray *)propertyNames fromLocalDatastore:(BOOL)fromLocalDatastore fetchedObjectsPredicate:(NSPredicate **)fetchedObjectsPredicate
+{
+    NSPredicate *filterPredicate = nil;
+    if(fetchOptions.filter)
+        filterPredicate = fetchOptions.filterPredicate;
+    BOOL searches = ([searchString length] && propertyNames.count);
+    
+    NSPredicate *objectsPredicate = nil;
+    NSArray *relationSubqueryConstraints = nil;
+    if(_boundRelation)
+    {
+        // PFRelation queries can't be created with a predicate, so the predicate is translated into constraints on the relation query, with only the untranslatable parts applied after objects are fetched
+        NSPredicate *relationPredicate = filterPredicate;
+        if(searches)
+        {
+            // matches searchQueryForString:propertyNames:filterPredicate:, which also only ignores case
+            NSMutableArray *subpredicates = [NSMutableArray arrayWithCapacity:propertyNames.count];
+            for(NSString *propertyName in propertyNames)
+                [subpredicates addObject:[NSPredicate predicateWithFormat:@"%K contains[c] %@", propertyName, searchString]];
+            NSPredicate *searchPredicate = [NSCompoundPredicate orPredicateWithSubpredicates:subpredicates];
+            
+            if(relationPredicate)
+                relationPredicate = [NSCompoundPredicate andPredicateWithSubpredicates:[NSArray arrayWithObjects:relationPredicate, searchPredicate, nil]];
+            else
+                relationPredicate = searchPredicate;
+        }
+        // Parse can't combine relation queries into an OR query, so any OR is applied after the objects are fetched. The local query has no relation, but batches it fetches must match the network ones.
+        relationSubqueryConstraints = [self subqueryConstraintsForPredicate:relationPredicate allowsOrQuery:(fromLocalDatastore && !fetchOptions.batchSize) residualPredicate:&objectsPredicate];
+    }
+    
+    PFRelation *boundRelation = _boundRelation;
+    PFQuery *(^newQuery)(void) = ^PFQuery *
+    {
+        if(!boundRelation)
+        {
+            if(searches)
+                return [self searchQueryForString:searchString propertyNames:propertyNames filterPredicate:filterPredicate];
+            //else
+            return [PFQuery queryWithClassName:self.defaultParseDefinition.className predicate:filterPredicate];
+        }
+        
+        return [self queryWithSubqueryConstraints:relationSubqueryConstraints newQuery:^PFQuery *
+                {
+                    // the relation's objects are pinned under their own name, so the local query doesn't need the relation
+                    if(fromLocalDatastore)
+                        return [PFQuery queryWithClassName:self.defaultParseDefinition.className];
+                    //else
+                    return [boundRelation query];
+                }];
+    };
+    
+    if(fetchedObjectsPredicate)
+        *fetchedObjectsPredicate = objectsPredicate;
+    
+    NSString *keysetSortKey = [self keysetSortKeyForOptions:fetchOptions searches:searches];
+    BOOL keysetAscending = (!fetchOptions.sort || fetchOptions.sortAscending);
+    SCParseFetchCursor *cursor = nil;
+    if(keysetSortKey)
+    {
+        cursor = [_fetchCursors objectForKey:fetchOptions];
+        if(cursor.nextBatchStartIndex!=fetchOptions.nextBatchStartIndex || !cursor.sortValue || !cursor.objectId)
+            cursor = nil;  // the batch doesn't follow the one the cursor was taken from
+    }
+    
+    PFQuery *query;
+    if(cursor)
+    {
+        // the objects after the cursor either have a later sort value, or the same sort value and a later objectId
+        PFQuery *laterValueQuery = newQuery();
+        PFQuery *sameValueQuery = newQuery();
+        if(!laterValueQuery || !sameValueQuery)
+            return nil;
+        
+        [sameValueQuery whereKey:keysetSortKey equalTo:cursor.sortValue];
+        if(keysetAscending)
+        {
+            [laterValueQuery whereKey:keysetSortKey greaterThan:cursor.sortValue];
+            [sameValueQuery whereKey:@"objectId" greaterThan:cursor.objectId];
+        }
+        else
+        {
+            [laterValueQuery whereKey:keysetSortKey lessThan:cursor.sortValue];
+            [sameValueQuery whereKey:@"objectId" lessThan:cursor.objectId];
+        }
+        query = [PFQuery orQueryWithSubqueries:[NSArray arrayWithObjects:laterValueQuery, sameValueQuery, nil]];
+    }
+    else
+    {
+        query = newQuery();
+    }
+    
+    if(!query)
+        return nil;
+    
+    if(keysetSortKey)
+    {
+        // objectId breaks sort value ties, so that the cursor identifies a single position
+        if(keysetAscending)
+        {
+            [query orderByAscending:keysetSortKey];
+            [query addAscendingOrder:@"objectId"];
+        }
+        else
+        {
+            [query orderByDescending:keysetSortKey];
+            [query addDescendingOrder:@"objectId"];
+        }
+    }
+    else
+        if(fetchOptions.sort && fetchOptions.sortKey)
+            [query orderBySortDescriptors:[fetchOptions sortDescriptors]];  // also covers multiple ';' separated keys
     if(fetchOptions.batchSize)
     {
         query.limit = fetchOptions.batchSize;
-        query.skip = fetchOptions.nextBatchStartIndex;
+        if(!cursor)
+            query.skip = fetchOptions.nextBatchStartIndex;
     }
     
     [self addIncludeKeysForQuery:query];
     
+    // Parse does not allow cache policies once the local datastore is enabled
+    if(!fromLocalDatastore && ![Parse isLocalDatastoreEnabled])
+        query.cachePolicy = self.cachePolicy;
+    
+    return query;
+}
+
+- (void)asynchronousFetchObjectsUsingQueryWithOptions:(SCDataFetchOptions *)fetchOptions searchString:(NSString *)searchString propertyNames:(NSArray *)propertyNames success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block
+{
+    NSPredicate *fetchedObjectsPredicate = nil;
+    PFQuery *query = [self queryWithOptions:fetchOptions searchString:searchString propertyNames:propertyNames fromLocalDatastore:NO fetchedObjectsPredicate:&fetchedObjectsPredicate];
+    
+    if(!query)
+    {
+        SCDebugLog(@"Warning: SCParseStore - unexpected unable to initiate PFQuery.");
+        if(failure_block)
+            failure_block([NSError errorWithDomain:@"Unable to initiate PFQuery" code:0 userInfo:nil]);
+        
+        return;
+    }
+    
     if(self.queryConfiguredAction)
         query = self.queryConfiguredAction(query);
     
-    if(query)
+    if(!query)
+    {
+        [self fetchObjectsSuccessful:[NSArray array] successBlock:success_block failure:failure_block];  // empty array
+        
+        return;
+    }
+    
+    // where the fetched batch ends is only known once it arrives, by which time the batch offset has moved on
+    NSString *keysetSortKey = [self keysetSortKeyForOptions:fetchOptions searches:([searchString length] && propertyNames.count)];
+    NSUInteger batchStartIndex = fetchOptions.nextBatchStartIndex;
+    
+    PFQuery *localQuery = nil;
+    if([self usesLocalDatastore])
     {
-        [query findObjectsInBackgroundWithBlock:^(NSArray *objects, NSError *error)
+        localQuery = [self queryWithOptions:fetchOptions searchString:searchString propertyNames:propertyNames fromLocalDatastore:YES fetchedObjectsPredicate:NULL];
+        if(localQuery && self.queryConfiguredAction)
+            localQuery = self.queryConfiguredAction(localQuery);
+        [localQuery fromPinWithName:self.pinName];
+    }
+    
+    // the results delivered to success_block. Later results are only delivered as changes to these.
+    __block NSArray *deliveredObjects = nil;
+    void (^deliverObjects)(NSArray *objects) = ^(NSArray *objects)
+    {
+        deliveredObjects = objects;
+        if(fetchOptions.batchSize)
+            [fetchOptions incrementBatchOffset];
+        
+        [self fetchObjectsSuccessful:objects successBlock:success_block failure:failure_block];
+    };
+    
+    PFCachePolicy cachePolicy = query.cachePolicy;
+    PFArrayResultBlock networkResultBlock = ^(NSArray *objects, NSError *error)
+    {
+        if(error)
+        {
+            if(deliveredObjects)
+                SCDebugLog(@"Warning: SCParseStore - unable to refresh fetched objects: %@", error);
+            else
+                if(!(error.code==kPFErrorCacheMiss && cachePolicy==kPFCachePolicyCacheThenNetwork))  // the network results are still on their way
+                {
+                    if(failure_block)
+                        failure_block(error);
+                }
+            
+            return;
+        }
+        
+        [self updateFetchCursorForOptions:fetchOptions keysetSortKey:keysetSortKey batchStartIndex:batchStartIndex fetchedObjects:objects];
+        
+        if(fetchedObjectsPredicate)
+        {
+            // apply the filterPredicate
+            objects = [objects filteredArrayUsingPredicate:fetchedObjectsPredicate];
+        }
+        
+        if(localQuery)
+            [self pinObjects:objects];
+        
+        if(!deliveredObjects)
+        {
+            deliverObjects(objects);
+            
+            return;
+        }
+        
+        NSArray *previousObjects = deliveredObjects;
+        if(localQuery && !fetchOptions.batchSize)
+        {
+            // pinned objects missing from the complete network results no longer exist
+            NSMutableSet *objectIds = [NSMutableSet setWithCapacity:objects.count];
+            for(PFObject *object in objects)
+            {
+                if(object.objectId)
+                    [objectIds addObject:object.objectId];
+            }
+            NSMutableArray *removedObjects = [NSMutableArray array];
+            for(PFObject *object in previousObjects)
+            {
+                if(object.objectId && ![objectIds containsObject:object.objectId])
+                    [removedObjects addObject:object];
+            }
+            [self unpinObjects:removedObjects];
+        }
+        
+        [self fetchObjectsSuccessful:objects successBlock:^(NSArray *finalResults)
          {
-             if (!error)
-             {
-                 if(filterPredicate && _boundRelation)
-                 {
-                     // apply the filterPredicate
-                     objects = [objects filteredArrayUsingPredicate:filterPredicate];
-                 }
-                 
-                 [self fetchObjectsSuccessful:objects successBlock:success_block failure:failure_block];
-             }
+             // a batch is only part of the results, so it's redelivered at its position instead of being diffed against them
+             if(fetchOptions.batchSize)
+                 deliveredObjects = [self postChangesFromBatchObjects:previousObjects toObjects:finalResults batchStartIndex:batchStartIndex fetchOptions:fetchOptions];
              else
+                 deliveredObjects = [self postChangesFromObjects:previousObjects toObjects:finalResults fetchOptions:fetchOptions];
+         }
+        failure:nil];
+    };
+    
+    if(!localQuery)
+    {
+        [query findObjectsInBackgroundWithBlock:networkResultBlock];
+        
+        return;
+    }
+    
+    // answer from the local datastore first, then refresh the pinned objects from the network
+    [localQuery findObjectsInBackgroundWithBlock:^(NSArray *objects, NSError *error)
+     {
+         if(!error && objects.count)
+         {
+             [self updateFetchCursorForOptions:fetchOptions keysetSortKey:keysetSortKey batchStartIndex:batchStartIndex fetchedObjects:objects];
+             
+             if(fetchedObjectsPredicate)
+                 objects = [objects filteredArrayUsingPredicate:fetchedObjectsPredicate];
+             
+             deliverObjects(objects);
+         }
+         else
+             if(error)
+                 SCDebugLog(@"Warning: SCParseStore - unable to fetch pinned objects: %@", error);
+         
+         if([SCUtilities IsInternetConnectionAvailable])
+         {
+             [query findObjectsInBackgroundWithBlock:networkResultBlock];
+         }
+         else
+             if(!deliveredObjects)
              {
                  if(failure_block)
-                     failure_block(error);
+                     failure_block([NSError errorWithDomain:kNoInternetConnectionString code:0 userInfo:nil]);
              }
-         }];
-    }
-    else
-    {
-        [self fetchObjectsSuccessful:[NSArray array] successBlock:success_block failure:failure_block];  // empty array
-    }
+     }];
 }
 
 - (void)asynchronousFetchObjectsUsingCloudCodeWithOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block
@@ -493,28 +1589,187 @@
 }
 
 
-- (void)addIncludeKeysForQuery:(PFQuery *)query
+// overrides superclass
+- (NSUInteger)countObjectsWithOptions:(SCDataFetchOptions *)fetchOptions
+{
+    return NSNotFound;  // Parse objects can only be counted asynchronously
+}
+
+// overrides superclass
+- (void)asynchronousCountObjectsWithOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreCountSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    NSPredicate *filterPredicate = nil;
+    if(fetchOptions.filter)
+        filterPredicate = fetchOptions.filterPredicate;
+    
+    // relations can only be counted on the server when their filter fully translates into query constraints
+    NSArray *relationSubqueryConstraints = nil;
+    NSPredicate *residualPredicate = nil;
+    if(_boundRelation)
+        relationSubqueryConstraints = [self subqueryConstraintsForPredicate:filterPredicate allowsOrQuery:FALSE residualPredicate:&residualPredicate];
+    
+    // cloud code functions can't be counted on the server
+    if(self.fetchObjectsCloudCodeFunctionName || residualPredicate)
+    {
+        if(failure_block)
+            failure_block(nil);
+        
+        return;
+    }
+    
+    if(![[Parse getApplicationId] length])
+    {
+        if(!self.defaultParseDefinition.applicationId || !self.defaultParseDefinition.clientKey)
+        {
+            if(failure_block)
+                failure_block([NSError errorWithDomain:@"Parse applicationId or clientKey not set" code:0 userInfo:nil]);
+            
+            return;
+        }
+        
+        [Parse setApplicationId:self.defaultParseDefinition.applicationId clientKey:self.defaultParseDefinition.clientKey];
+    }
+    
+    if(![SCUtilities IsInternetConnectionAvailable])
+    {
+        if(noConnection_block)
+            noConnection_block();
+        if(failure_block)
+            failure_block([NSError errorWithDomain:kNoInternetConnectionString code:0 userInfo:nil]);
+        
+        return;
+    }
+    
+    PFQuery *query;
+    if(!_boundRelation)
+        query = [PFQuery queryWithClassName:self.defaultParseDefinition.className predicate:filterPredicate];
+    else
+    {
+        PFRelation *boundRelation = _boundRelation;
+        query = [self queryWithSubqueryConstraints:relationSubqueryConstraints newQuery:^PFQuery *{ return [boundRelation query]; }];
+    }
+    
+    if(query && self.queryConfiguredAction)
+        query = self.queryConfiguredAction(query);
+    
+    if(!query)
+    {
+        if(failure_block)
+            failure_block([NSError errorWithDomain:@"Unable to initiate PFQuery" code:0 userInfo:nil]);
+        
+        return;
+    }
+    
+    [query countObjectsInBackgroundWithBlock:^(int count, NSError *error)
+     {
+         if(!error)
+         {
+             if(success_block)
+                 success_block(count);
+         }
+         else
+         {
+             if(failure_block)
+                 failure_block(error);
+         }
+     }];
+}
+
+- (NSArray *)automaticIncludeKeys
 {
-    // Auto detect include keys based on the data definition
-    NSMutableArray *includeKeys = [NSMutableArray array];
     SCParseDefinition *parseDefinition = [self defaultParseDefinition];
+    
+    // reuse the keys worked out for the same definition
+    if(_automaticIncludeKeys && _includeKeysDefinition==parseDefinition && _includeKeysPropertyDefinitionCount==parseDefinition.propertyDefinitionCount
+       && (_includeKeysTitlePropertyName==parseDefinition.titlePropertyName || [_includeKeysTitlePropertyName isEqualToString:parseDefinition.titlePropertyName])
+       && (_includeKeysDescriptionPropertyName==parseDefinition.descriptionPropertyName || [_includeKeysDescriptionPropertyName isEqualToString:parseDefinition.descriptionPropertyName]))
+    {
+        return _automaticIncludeKeys;
+    }
+    
+    NSMutableOrderedSet *includeKeys = [NSMutableOrderedSet orderedSet];
+    [self addIncludeKeysForKeyPaths:parseDefinition.titlePropertyName toSet:includeKeys];
+    [self addIncludeKeysForKeyPaths:parseDefinition.descriptionPropertyName toSet:includeKeys];
     for(NSInteger i=0; i<parseDefinition.propertyDefinitionCount; i++)
     {
         SCPropertyDefinition *propertyDefintion = [parseDefinition propertyDefinitionAtIndex:i];
+        
+        // fetched objects are existing objects, so properties without a UI for them are never displayed
+        if(!propertyDefintion.existsInDetailMode || (!propertyDefintion.existsInNormalMode && !propertyDefintion.existsInEditingMode))
+            continue;
+        
         switch (propertyDefintion.type)
         {
             case SCPropertyTypeArrayOfObjects:
             case SCPropertyTypeObject:
             case SCPropertyTypeObjectSelection:
-            case SCPropertyTypeCustom:
                 [includeKeys addObject:propertyDefintion.name];
                 break;
                 
+            case SCPropertyTypeCustom:
+                if(propertyDefintion.objectBindings.count)
+                {
+                    for(NSObject *keyPath in [propertyDefintion.objectBindings allValues])
+                    {
+                        if(![keyPath isKindOfClass:[NSString class]])
+                            continue;
+                        
+                        [self addIncludeKeysForKeyPaths:(NSString *)keyPath toSet:includeKeys];
+                        
+                        // controls bound directly to a relation property display its objects
+                        SCPropertyDefinition *boundPropertyDefinition = [parseDefinition propertyDefinitionWithName:(NSString *)keyPath];
+                        if(boundPropertyDefinition.type==SCPropertyTypeArrayOfObjects || boundPropertyDefinition.type==SCPropertyTypeObject || boundPropertyDefinition.type==SCPropertyTypeObjectSelection)
+                            [includeKeys addObject:keyPath];
+                    }
+                }
+                else
+                {
+                    [includeKeys addObject:propertyDefintion.name];
+                }
+                break;
+                
             default:
                 break;
         }
     }
     
+    _automaticIncludeKeys = [includeKeys array];
+    _includeKeysDefinition = parseDefinition;
+    _includeKeysPropertyDefinitionCount = parseDefinition.propertyDefinitionCount;
+    _includeKeysTitlePropertyName = [parseDefinition.titlePropertyName copy];
+    _includeKeysDescriptionPropertyName = [parseDefinition.descriptionPropertyName copy];
+    
+    return _automaticIncludeKeys;
+}
+
+// Adds the related objects read by the given ';' separated key paths (e.g. 'category.name' reads the 'category' object)
+- (void)addIncludeKeysForKeyPaths:(NSString *)keyPaths toSet:(NSMutableOrderedSet *)includeKeys
+{
+    if(![keyPaths length])
+        return;
+    
+    for(NSString *keyPath in [keyPaths componentsSeparatedByString:@";"])
+    {
+        NSRange lastDotRange = [keyPath rangeOfString:@"." options:NSBackwardsSearch];
+        if(lastDotRange.location==NSNotFound || lastDotRange.location==0)
+            continue;
+        
+        // including 'a.b' also includes 'a'
+        [includeKeys addObject:[keyPath substringToIndex:lastDotRange.location]];
+    }
+}
+
+- (void)invalidateIncludeKeys
+{
+    _automaticIncludeKeys = nil;
+}
+
+- (void)addIncludeKeysForQuery:(PFQuery *)query
+{
+    NSArray *includeKeys = self.includeKeys;
+    if(!includeKeys)
+        includeKeys = self.automaticIncludeKeys;
+    
     for(NSString *key in includeKeys)
         [query includeKey:key];
 }
@@ -64,6 +64,11 @@
  */
 - (instancetype)initWithHeaderTitle:(NSString *)sectionHeaderTitle webServiceDefinition:(SCWebServiceDefinition *)definition batchSize:(NSUInteger)batchSize;
 
+/** Fetches all the items available from the section's web service, replacing any items already fetched. Items are added to the section as soon as each contiguous run of batches arrives.
+ 
+ @note Batches are fetched in parallel when the web service definition sets totalCountKeyName. See [SCWebServiceStore asynchronousFetchAllObjectsWithOptions:progress:success:failure:noConnection:]. */
+- (void)fetchAllItems;
+
 @end
 
 
@@ -63,4 +63,47 @@
     return self;
 }
 
+- (void)fetchAllItems
+{
+    if(![self.dataStore isKindOfClass:[SCWebServiceStore class]])
+    {
+        [self fetchItems:self];
+        return;
+    }
+    
+    [self.mutableItems removeAllObjects];
+    [self.fetchItemsCell startActivityIndicator];
+    [self.ownerTableViewModel.tableView reloadData];
+    
+    __weak typeof(self) weak_self = self;
+    [(SCWebServiceStore *)self.dataStore asynchronousFetchAllObjectsWithOptions:self.dataFetchOptions
+    progress:^(NSArray *results)
+     {
+         [weak_self didFetchItems:results sender:weak_self];
+     }
+    success:^(NSArray *results)
+     {
+         // the batches were displayed as they arrived, the complete results are in their final order
+         [weak_self.fetchItemsCell stopActivityIndicator];
+         [weak_self removeSpecialCellsFromItems];
+         [weak_self.mutableItems setArray:results];
+         [weak_self addSpecialCellsToItems];
+         [weak_self.ownerTableViewModel.tableView reloadData];
+     }
+    failure:^(NSError *error)
+     {
+         [weak_self.fetchItemsCell stopActivityIndicator];
+         
+         if(weak_self.sectionActions.fetchItemsFromStoreFailed)
+             weak_self.sectionActions.fetchItemsFromStoreFailed(weak_self, error);
+         else
+             if(weak_self.ownerTableViewModel.sectionActions.fetchItemsFromStoreFailed)
+                 weak_self.ownerTableViewModel.sectionActions.fetchItemsFromStoreFailed(weak_self, error);
+     }
+    noConnection:^BOOL()
+     {
+         return NO;  // call failure_block
+     }];
+}
+
 @end
@@ -22,6 +22,7 @@
 
 
 #import <SensibleTableView/SCDictionaryDefinition.h>
+#import <SensibleTableView/SCClassDefinition.h>
 
 
 /****************************************************************************************/
@@ -126,6 +127,21 @@
  */
 @property (nonatomic, readonly) NSURL *deleteURL;
 
+/**
+ *  The change stream URL computed based on baseURL and changeStreamAPI;
+ */
+@property (nonatomic, readonly) NSURL *changeStreamURL;
+
+/**
+ *  The count URL computed based on baseURL and countObjectsAPI;
+ */
+@property (nonatomic, readonly) NSURL *countURL;
+
+/**
+ *  The groups URL computed based on baseURL and fetchGroupsAPI;
+ */
+@property (nonatomic, readonly) NSURL *groupsURL;
+
 /** The dictionary of HTTP header values.
  
  Sample use:
@@ -140,9 +156,14 @@
  
  Sample use:
     [tweetDef.fetchObjectsParameters setValue:@"#iosdev" forKey:@"q"];
+ 
+ @note Parameters sent in the query string are percent-encoded exactly as given. Set parametersArePercentEncoded to TRUE if your values are already percent-encoded.
  */
 @property (nonatomic, readonly) NSMutableDictionary *fetchObjectsParameters;
 
+/** Set to TRUE when the keys and values you add to fetchObjectsParameters, insertObjectParameters, updateObjectParameters and deleteObjectParameters are already percent-encoded (e.g. @"%23iosdev"). They are then sent in the query string as they are. Values generated by the store (e.g. for filters, searches and sorting) are always percent-encoded. Default: FALSE. */
+@property (nonatomic, readwrite) BOOL parametersArePercentEncoded;
+
 /** The name of the results dictionary key that will contain the objects fetched from the web service. This value has no effect if the returned results are an array instead of a dictionary. */
 @property (nonatomic, copy) NSString *resultsKeyName;
 
@@ -163,6 +184,27 @@
  */
 @property (nonatomic, readwrite) NSUInteger batchInitialStartIndex;
 
+/** The name of the dictionary key that contains the total number of objects available on the server. When set along with batchSizeParameterName and batchStartIndexParameterName, [SCWebServiceStore asynchronousFetchAllObjectsWithOptions:progress:success:failure:noConnection:] fetches the remaining batches in parallel. */
+@property (nonatomic, copy) NSString *totalCountKeyName;
+
+/** The string containing an API that returns the number of objects matching the fetch objects parameters, without returning the objects themselves. The response can either be a plain JSON number or a dictionary holding the number under countKeyName. When nil, [SCWebServiceStore asynchronousCountObjectsWithOptions:success:failure:noConnection:] falls back to fetching a single object and reading totalCountKeyName. */
+@property (nonatomic, copy) NSString *countObjectsAPI;
+
+/** The name of the dictionary key that contains the number of objects returned by countObjectsAPI. Default: @"count". */
+@property (nonatomic, copy) NSString *countKeyName;
+
+/** The string containing an API that groups the objects matching the fetch objects parameters by a property, returning each distinct value along with its number of objects. The property name is sent in the groupByParameterName parameter, and the response is an array (or a dictionary holding the array under resultsKeyName) of dictionaries with the groupValueKeyName and groupCountKeyName keys. When nil, [SCWebServiceStore asynchronousFetchGroupsForPropertyName:withOptions:success:failure:noConnection:] fetches all the objects and groups them locally. */
+@property (nonatomic, copy) NSString *fetchGroupsAPI;
+
+/** The name of the parameter that the grouped property name is sent in to fetchGroupsAPI. Default: @"group_by". */
+@property (nonatomic, copy) NSString *groupByParameterName;
+
+/** The name of the dictionary key that contains a group's value in the fetchGroupsAPI response. Default: @"value". */
+@property (nonatomic, copy) NSString *groupValueKeyName;
+
+/** The name of the dictionary key that contains a group's number of objects in the fetchGroupsAPI response. Default: @"count". */
+@property (nonatomic, copy) NSString *groupCountKeyName;
+
 /** The name of the dictionary key that contains the URL to the next batch of objects. */
 @property (nonatomic, copy) NSString *nextBatchURLKeyName;
 
@@ -201,6 +243,20 @@
 /** The dictionary of update object parameters. */
 @property (nonatomic, strong, readonly) NSMutableDictionary *updateObjectParameters;
 
+/**
+ *  Set to TRUE to have UPDATE operations only send the keys that have changed since the object was last fetched or committed, using partialUpdateHTTPMethod. When no keys have changed, the UPDATE request is skipped altogether. Default: FALSE.
+ *
+ *  @see [SCDataStore dirtyPropertyNamesForObject:]
+ */
+@property (nonatomic, readwrite) BOOL sendsOnlyChangedKeysOnUpdate;
+
+/**
+ *  The HTTP method used for partial UPDATE operations. Default: @"PATCH".
+ *
+ *  @note Only applicable when sendsOnlyChangedKeysOnUpdate is TRUE.
+ */
+@property (nonatomic, copy) NSString *partialUpdateHTTPMethod;
+
 /** The string containing the delete object API. */
 @property (nonatomic, copy) NSString *deleteObjectAPI;
 
@@ -208,6 +264,119 @@
 @property (nonatomic, strong, readonly) NSMutableDictionary *deleteObjectParameters;
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Server-Side Sorting and Filtering
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** The name of the fetch parameter that the sort key is sent in. When set, the fetch options' sort is performed by the web service across the whole data set instead of locally within each fetched batch. Default: nil.
+ 
+ Sample use:
+    myWebServiceDef.sortKeyParameterName = @"sort";
+    myWebServiceDef.sortOrderParameterName = @"order";
+    // fetches now include: sort=name&order=asc
+ */
+@property (nonatomic, copy) NSString *sortKeyParameterName;
+
+/** The name of the fetch parameter that the sort direction is sent in. If nil, the direction is expressed by prefixing descending sort keys with descendingSortKeyPrefix. Default: nil. */
+@property (nonatomic, copy) NSString *sortOrderParameterName;
+
+/** The value sent in sortOrderParameterName for ascending sorts. Default: @"asc". */
+@property (nonatomic, copy) NSString *sortAscendingValue;
+
+/** The value sent in sortOrderParameterName for descending sorts. Default: @"desc". */
+@property (nonatomic, copy) NSString *sortDescendingValue;
+
+/** The prefix added to the sort key of descending sorts when sortOrderParameterName is nil. Default: @"-". */
+@property (nonatomic, copy) NSString *descendingSortKeyPrefix;
+
+/** The string that separates the keys of a multi-key sort (a sort key such as @"lastName;firstName") in sortKeyParameterName. If nil, multi-key sorts are performed locally. Default: @",". */
+@property (nonatomic, copy) NSString *sortKeysSeparator;
+
+/** 
+ The dictionary of filter operators that the web service supports, each mapped to the format of its fetch parameter name. The format must contain a single %@, which gets replaced with the query parameter name of the predicate's key path. Default: empty (filters are applied locally).
+ 
+ The supported operator keys are: @"==", @"!=", @"<", @"<=", @">", @">=", @"BEGINSWITH", @"ENDSWITH", @"CONTAINS", @"LIKE" and @"IN". Append "[c]" to an operator key (e.g. @"CONTAINS[c]") to support its case and diacritic insensitive variant.
+ 
+ Sample use:
+    [myWebServiceDef.filterOperatorParameterFormats setValue:@"%@" forKey:@"=="];
+    [myWebServiceDef.filterOperatorParameterFormats setValue:@"%@_gte" forKey:@">="];
+    [myWebServiceDef.filterOperatorParameterFormats setValue:@"%@_like" forKey:@"CONTAINS[c]"];
+    // the predicate "age >= 21 AND name CONTAINS[c] 'smith'" is now sent as: age_gte=21&name_like=smith
+ 
+ @note Only comparisons between a key path and a constant value, optionally combined using AND, can be sent to the web service. If any part of the filter predicate can't be expressed, the whole predicate is applied locally instead.
+ */
+@property (nonatomic, strong, readonly) NSMutableDictionary *filterOperatorParameterFormats;
+
+/** The dictionary that maps the key paths used in sort keys and filter predicates to the names the web service expects in its fetch parameters. Key paths missing from this dictionary are sent as is. */
+@property (nonatomic, strong, readonly) NSMutableDictionary *queryParameterNames;
+
+/** The name of the fetch parameter that search strings are sent in. When set, [SCWebServiceStore asynchronousSearchObjectsForString:propertyNames:withOptions:success:failure:noConnection:] lets the web service perform the search, otherwise the fetched objects are searched locally. Default: nil.
+ 
+ Sample use:
+    myWebServiceDef.searchParameterName = @"q";
+ */
+@property (nonatomic, copy) NSString *searchParameterName;
+
+/** Adds the parameters that express the given sort to the fetch parameters. Returns FALSE if the sort can't be performed by the web service, in which case the parameters are not modified.
+ @note Override this method in a subclass to customize how sorts are sent to your web service. */
+- (BOOL)addSortParametersForKey:(NSString *)sortKey ascending:(BOOL)ascending toParameters:(NSMutableDictionary *)parameters;
+
+/** Adds the parameters that express the given filter predicate to the fetch parameters. Returns FALSE if the predicate can't be evaluated by the web service, in which case the parameters are not modified.
+ @note Override this method in a subclass to customize how filters are sent to your web service. */
+- (BOOL)addFilterParametersForPredicate:(NSPredicate *)predicate toParameters:(NSMutableDictionary *)parameters;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Change Stream
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** 
+ The string containing the API of a Server-Sent Events (text/event-stream) endpoint that pushes object changes. When set, [SCWebServiceStore startObservingChanges] subscribes to this stream and forwards every change to the sections bound to the store, so that only the affected rows get inserted, reloaded or removed.
+ 
+ Each event's data must be a JSON dictionary describing a single change. The change type is read from the event's "event" field, or from changeTypeKeyName in the data when the event field is missing.
+ 
+ @note To try out a change stream without a backend, run Tools/ChangeStreamServer/change_stream_server.py from the repository and set baseURL to @"http://127.0.0.1:8080/" and changeStreamAPI to @"changes". The server's README lists the matching settings.
+ */
+@property (nonatomic, copy) NSString *changeStreamAPI;
+
+/** The key name of the change type in a change event's data. The value must be either @"insert", @"update" or @"delete". Default: @"type". */
+@property (nonatomic, copy) NSString *changeTypeKeyName;
+
+/** The key name of the changed object in a change event's data. If nil, the event's data itself is treated as the changed object. Default: nil. */
+@property (nonatomic, copy) NSString *changeObjectKeyName;
+
+/** The number of seconds to wait before reconnecting to the change stream after the connection drops. Default: 3. */
+@property (nonatomic, readwrite) NSTimeInterval changeStreamReconnectInterval;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Object Mapping
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** 
+ The class definition of the model objects that the web service results will be decoded into. When set, fetched results are decoded directly into instances of the definition's class instead of NSMutableDictionary objects, and inserted or updated objects are encoded back to JSON using the same definition. Default: nil.
+ 
+ Sample use:
+    tweetDef.modelClassDefinition = [SCClassDefinition definitionWithClass:[Tweet class] autoGeneratePropertyDefinitions:NO];
+ 
+ @note Only the results keys that match a writable property of the model class are decoded. Values are coerced to the property's data type before being set.
+ */
+@property (nonatomic, strong) SCClassDefinition *modelClassDefinition;
+
+/** The date format used to decode and encode the NSDate properties of modelClassDefinition objects. Default: @"yyyy-MM-dd'T'HH:mm:ssZZZZZ". */
+@property (nonatomic, copy) NSString *modelDateFormat;
+
+/** Returns a new object decoded from the given results dictionary. If modelClassDefinition is nil, a mutable dictionary is returned instead.
+ @note This method is thread safe and is typically called by SCWebServiceStore on a background queue. */
+- (NSObject *)objectWithJSONDictionary:(NSDictionary *)dictionary;
+
+/** Returns a dictionary that can be serialized to JSON from the given object. */
+- (NSMutableDictionary *)JSONDictionaryWithObject:(NSObject *)object;
+
+/** Sets the given JSON value for the given key in the object, coercing the value to the key's data type when needed. */
+- (void)setJSONValue:(id)value forKey:(NSString *)key inObject:(NSObject *)object;
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 /// @name Authorization Methods
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -26,6 +26,7 @@
 #import "SCWebServiceFetchOptions.h"
 #import "SCArrayOfObjectsSection+WebServices.h"
 #import "SCWebServiceStore.h"
+#import <objc/runtime.h>
 
 
 
@@ -35,6 +36,12 @@
 @property (nonatomic, strong, readwrite) NSMutableDictionary *insertObjectParameters;
 @property (nonatomic, strong, readwrite) NSMutableDictionary *updateObjectParameters;
 @property (nonatomic, strong, readwrite) NSMutableDictionary *deleteObjectParameters;
+@property (nonatomic, strong, readwrite) NSMutableDictionary *filterOperatorParameterFormats;
+@property (nonatomic, strong, readwrite) NSMutableDictionary *queryParameterNames;
+
+// Cached map of the model class's writable property names to their SCDataType
+@property (nonatomic, strong) NSDictionary *modelPropertyDataTypes;
+@property (nonatomic, strong) NSDateFormatter *modelDateFormatter;
 
 @end
 
@@ -64,10 +71,39 @@
         _httpHeaders = [[NSMutableDictionary alloc] init];
         _insertHTTPMethod = @"POST";
         _updateHTTPMethod = @"PUT";
+        _sendsOnlyChangedKeysOnUpdate = FALSE;
+        _partialUpdateHTTPMethod = @"PATCH";
         _fetchObjectsParameters = [[NSMutableDictionary alloc] init];
         _insertObjectParameters = [[NSMutableDictionary alloc] init];
         _updateObjectParameters = [[NSMutableDictionary alloc] init];
         _deleteObjectParameters = [[NSMutableDictionary alloc] init];
+        
+        _sortKeyParameterName = nil;
+        _sortOrderParameterName = nil;
+        _sortAscendingValue = @"asc";
+        _sortDescendingValue = @"desc";
+        _descendingSortKeyPrefix = @"-";
+        _sortKeysSeparator = @",";
+        _parametersArePercentEncoded = FALSE;
+        _filterOperatorParameterFormats = [[NSMutableDictionary alloc] init];
+        _queryParameterNames = [[NSMutableDictionary alloc] init];
+        _searchParameterName = nil;
+        
+        _countObjectsAPI = nil;
+        _countKeyName = @"count";
+        
+        _fetchGroupsAPI = nil;
+        _groupByParameterName = @"group_by";
+        _groupValueKeyName = @"value";
+        _groupCountKeyName = @"count";
+        
+        _changeStreamAPI = nil;
+        _changeTypeKeyName = @"type";
+        _changeObjectKeyName = nil;
+        _changeStreamReconnectInterval = 3;
+        
+        _modelClassDefinition = nil;
+        _modelDateFormat = @"yyyy-MM-dd'T'HH:mm:ssZZZZZ";
 	}
 	return self;
 }
@@ -129,6 +165,30 @@
     return [NSURL URLWithString:self.deleteObjectAPI relativeToURL:self.baseURL];
 }
 
+- (NSURL *)changeStreamURL
+{
+    if(!self.baseURL || !self.changeStreamAPI)
+        return nil;
+    
+    return [NSURL URLWithString:self.changeStreamAPI relativeToURL:self.baseURL];
+}
+
+- (NSURL *)countURL
+{
+    if(!self.baseURL || !self.countObjectsAPI)
+        return nil;
+    
+    return [NSURL URLWithString:self.countObjectsAPI relativeToURL:self.baseURL];
+}
+
+- (NSURL *)groupsURL
+{
+    if(!self.baseURL || !self.fetchGroupsAPI)
+        return nil;
+    
+    return [NSURL URLWithString:self.fetchGroupsAPI relativeToURL:self.baseURL];
+}
+
 - (void)setHttpHeaders:(NSMutableDictionary *)httpHeaders
 {
     // Ensure any httpHeaders inserted by our plugin is an NSMutableDictionary instance (not NSDictionary)
@@ -153,6 +213,18 @@
     _deleteObjectParameters = [NSMutableDictionary dictionaryWithDictionary:deleteObjectParameters];
 }
 
+- (void)setFilterOperatorParameterFormats:(NSMutableDictionary *)filterOperatorParameterFormats
+{
+    // Ensure any filterOperatorParameterFormats inserted by our plugin is an NSMutableDictionary instance (not NSDictionary)
+    _filterOperatorParameterFormats = [NSMutableDictionary dictionaryWithDictionary:filterOperatorParameterFormats];
+}
+
+- (void)setQueryParameterNames:(NSMutableDictionary *)queryParameterNames
+{
+    // Ensure any queryParameterNames inserted by our plugin is an NSMutableDictionary instance (not NSDictionary)
+    _queryParameterNames = [NSMutableDictionary dictionaryWithDictionary:queryParameterNames];
+}
+
 - (void)setAuthorizationHeaderWithUsername:(NSString *)username password:(NSString *)password
 {
 	NSString *credentials = [NSString stringWithFormat:@"%@:%@", username, password];
@@ -171,6 +243,313 @@
 }
 
 
+#pragma mark - Server-side sorting and filtering
+
+- (NSString *)queryParameterNameForKeyPath:(NSString *)keyPath
+{
+    NSString *parameterName = [self.queryParameterNames valueForKey:keyPath];
+    if(!parameterName)
+        parameterName = keyPath;
+    
+    return parameterName;
+}
+
+- (BOOL)addSortParametersForKey:(NSString *)sortKey ascending:(BOOL)ascending toParameters:(NSMutableDictionary *)parameters
+{
+    if(!self.sortKeyParameterName || !sortKey)
+        return FALSE;
+    
+    NSArray *sortKeys = [sortKey componentsSeparatedByString:@";"];
+    if(sortKeys.count>1 && !self.sortKeysSeparator)
+        return FALSE;
+    if(!ascending && !self.sortOrderParameterName && !self.descendingSortKeyPrefix)
+        return FALSE;
+    
+    NSMutableArray *parameterSortKeys = [NSMutableArray arrayWithCapacity:sortKeys.count];
+    for(NSString *key in sortKeys)
+    {
+        NSString *parameterSortKey = [self queryParameterNameForKeyPath:key];
+        if(!ascending && !self.sortOrderParameterName)
+            parameterSortKey = [self.descendingSortKeyPrefix stringByAppendingString:parameterSortKey];
+        [parameterSortKeys addObject:parameterSortKey];
+    }
+    
+    [parameters setValue:[parameterSortKeys componentsJoinedByString:(self.sortKeysSeparator ? self.sortKeysSeparator : @"")] forKey:self.sortKeyParameterName];
+    if(self.sortOrderParameterName)
+        [parameters setValue:(ascending ? self.sortAscendingValue : self.sortDescendingValue) forKey:self.sortOrderParameterName];
+    
+    return TRUE;
+}
+
+- (BOOL)addFilterParametersForPredicate:(NSPredicate *)predicate toParameters:(NSMutableDictionary *)parameters
+{
+    if(!predicate || !self.filterOperatorParameterFormats.count)
+        return FALSE;
+    
+    // all or nothing: only modify parameters once the whole predicate is known to be expressible
+    NSMutableDictionary *filterParameters = [NSMutableDictionary dictionary];
+    if(![self collectFilterParametersForPredicate:predicate inDictionary:filterParameters])
+        return FALSE;
+    
+    [parameters addEntriesFromDictionary:filterParameters];
+    
+    return TRUE;
+}
+
+- (BOOL)collectFilterParametersForPredicate:(NSPredicate *)predicate inDictionary:(NSMutableDictionary *)filterParameters
+{
+    if([predicate isKindOfClass:[NSCompoundPredicate class]])
+    {
+        NSCompoundPredicate *compoundPredicate = (NSCompoundPredicate *)predicate;
+        if(compoundPredicate.compoundPredicateType != NSAndPredicateType)
+            return FALSE;
+        
+        for(NSPredicate *subpredicate in compoundPredicate.subpredicates)
+        {
+            if(![self collectFilterParametersForPredicate:subpredicate inDictionary:filterParameters])
+                return FALSE;
+        }
+        
+        return TRUE;
+    }
+    
+    if(![predicate isKindOfClass:[NSComparisonPredicate class]])
+        return FALSE;
+    
+    NSComparisonPredicate *comparisonPredicate = (NSComparisonPredicate *)predicate;
+    if(comparisonPredicate.comparisonPredicateModifier != NSDirectPredicateModifier
+       || comparisonPredicate.leftExpression.expressionType != NSKeyPathExpressionType
+       || comparisonPredicate.rightExpression.expressionType != NSConstantValueExpressionType)
+        return FALSE;
+    
+    NSString *operatorKey;
+    switch (comparisonPredicate.predicateOperatorType)
+    {
+        case NSEqualToPredicateOperatorType:                operatorKey = @"=="; break;
+        case NSNotEqualToPredicateOperatorType:             operatorKey = @"!="; break;
+        case NSLessThanPredicateOperatorType:               operatorKey = @"<"; break;
+        case NSLessThanOrEqualToPredicateOperatorType:      operatorKey = @"<="; break;
+        case NSGreaterThanPredicateOperatorType:            operatorKey = @">"; break;
+        case NSGreaterThanOrEqualToPredicateOperatorType:   operatorKey = @">="; break;
+        case NSBeginsWithPredicateOperatorType:             operatorKey = @"BEGINSWITH"; break;
+        case NSEndsWithPredicateOperatorType:               operatorKey = @"ENDSWITH"; break;
+        case NSContainsPredicateOperatorType:               operatorKey = @"CONTAINS"; break;
+        case NSLikePredicateOperatorType:                   operatorKey = @"LIKE"; break;
+        case NSInPredicateOperatorType:                     operatorKey = @"IN"; break;
+        default:
+            return FALSE;
+    }
+    if(comparisonPredicate.options & (NSCaseInsensitivePredicateOption|NSDiacriticInsensitivePredicateOption))
+        operatorKey = [operatorKey stringByAppendingString:@"[c]"];
+    
+    NSString *parameterNameFormat = [self.filterOperatorParameterFormats valueForKey:operatorKey];
+    if(!parameterNameFormat)
+        return FALSE;
+    
+    NSString *parameterName = [NSString stringWithFormat:parameterNameFormat, [self queryParameterNameForKeyPath:comparisonPredicate.leftExpression.keyPath]];
+    if([filterParameters valueForKey:parameterName])
+        return FALSE;  // the same parameter can't be sent twice
+    
+    id parameterValue = [self queryParameterValueForValue:comparisonPredicate.rightExpression.constantValue];
+    if(!parameterValue)
+        return FALSE;
+    
+    [filterParameters setValue:parameterValue forKey:parameterName];
+    
+    return TRUE;
+}
+
+- (id)queryParameterValueForValue:(id)value
+{
+    if([value isKindOfClass:[NSString class]] || [value isKindOfClass:[NSNumber class]])
+        return value;
+    
+    if([value isKindOfClass:[NSDate class]])
+        return [self.modelDateFormatter stringFromDate:value];
+    
+    if([value isKindOfClass:[NSArray class]] || [value isKindOfClass:[NSSet class]])
+    {
+        NSMutableArray *components = [NSMutableArray array];
+        for(id item in value)
+        {
+            id itemValue = [self queryParameterValueForValue:item];
+            if(!itemValue)
+                return nil;
+            [components addObject:[NSString stringWithFormat:@"%@", itemValue]];
+        }
+        return [components componentsJoinedByString:@","];
+    }
+    
+    return nil;
+}
+
+
+
+#pragma mark - Object mapping
+
+- (void)setModelClassDefinition:(SCClassDefinition *)modelClassDefinition
+{
+    @synchronized(self)
+    {
+        _modelClassDefinition = modelClassDefinition;
+        _modelPropertyDataTypes = nil;
+    }
+}
+
+- (void)setModelDateFormat:(NSString *)modelDateFormat
+{
+    @synchronized(self)
+    {
+        _modelDateFormat = [modelDateFormat copy];
+        _modelDateFormatter = nil;
+    }
+}
+
+- (NSDictionary *)modelPropertyDataTypes
+{
+    @synchronized(self)
+    {
+        if(!_modelPropertyDataTypes && self.modelClassDefinition.cls)
+        {
+            NSMutableDictionary *dataTypes = [NSMutableDictionary dictionary];
+            
+            // walk up the class hierarchy since class_copyPropertyList only returns the class's own properties
+            for(Class _class = self.modelClassDefinition.cls; _class && _class != [NSObject class]; _class = class_getSuperclass(_class))
+            {
+                unsigned int count = 0;
+                objc_property_t *properties = class_copyPropertyList(_class, &count);
+                for(unsigned int i=0; i<count; i++)
+                {
+                    NSString *propertyName = [NSString stringWithUTF8String:property_getName(properties[i])];
+                    if([dataTypes valueForKey:propertyName])
+                        continue;
+                    
+                    NSArray *attributesArray = [[NSString stringWithUTF8String:property_getAttributes(properties[i])] componentsSeparatedByString:@","];
+                    if([attributesArray containsObject:@"R"])
+                        continue;
+                    
+                    SCDataType dataType = [self.modelClassDefinition propertyDataTypeForPropertyWithName:propertyName];
+                    [dataTypes setValue:[NSNumber numberWithInteger:dataType] forKey:propertyName];
+                }
+                free(properties);
+            }
+            
+            _modelPropertyDataTypes = dataTypes;
+        }
+        
+        return _modelPropertyDataTypes;
+    }
+}
+
+- (NSDateFormatter *)modelDateFormatter
+{
+    @synchronized(self)
+    {
+        if(!_modelDateFormatter)
+        {
+            _modelDateFormatter = [[NSDateFormatter alloc] init];
+            _modelDateFormatter.locale = [[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"];
+            _modelDateFormatter.dateFormat = self.modelDateFormat;
+        }
+        
+        return _modelDateFormatter;
+    }
+}
+
+- (id)modelValueForJSONValue:(id)value dataType:(SCDataType)dataType
+{
+    if(!value || [value isKindOfClass:[NSNull class]])
+        return nil;
+    
+    switch (dataType)
+    {
+        case SCDataTypeNSDate:
+            if([value isKindOfClass:[NSNumber class]])
+                return [NSDate dateWithTimeIntervalSince1970:[value doubleValue]];
+            if([SCUtilities isStringClass:[value class]])
+                return [self.modelDateFormatter dateFromString:value];
+            return [value isKindOfClass:[NSDate class]] ? value : nil;
+            
+        case SCDataTypeBOOL:
+        case SCDataTypeInt:
+        case SCDataTypeFloat:
+        case SCDataTypeDouble:
+            // scalars are set through KVC, which expects an NSNumber
+            return [SCUtilities getValueCompatibleWithDataType:SCDataTypeNSNumber fromValue:value];
+            
+        default:
+            return [SCUtilities getValueCompatibleWithDataType:dataType fromValue:value];
+    }
+}
+
+- (NSObject *)objectWithJSONDictionary:(NSDictionary *)dictionary
+{
+    NSDictionary *dataTypes = self.modelPropertyDataTypes;
+    if(!dataTypes)
+    {
+        if([dictionary isKindOfClass:[NSMutableDictionary class]])
+            return dictionary;
+        //else
+        return [NSMutableDictionary dictionaryWithDictionary:dictionary];
+    }
+    
+    NSObject *object = [[self.modelClassDefinition.cls alloc] init];
+    [dictionary enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, BOOL *stop)
+     {
+         NSNumber *dataType = [dataTypes objectForKey:key];
+         if(!dataType)
+             return;
+         
+         SCDataType type = (SCDataType)[dataType integerValue];
+         id modelValue = [self modelValueForJSONValue:value dataType:type];
+         if(!modelValue && (type==SCDataTypeBOOL || type==SCDataTypeInt || type==SCDataTypeFloat || type==SCDataTypeDouble))
+             return;  // scalars don't support nil
+         
+         [object setValue:modelValue forKey:key];
+     }];
+    
+    return object;
+}
+
+- (NSMutableDictionary *)JSONDictionaryWithObject:(NSObject *)object
+{
+    if([object isKindOfClass:[NSDictionary class]])
+        return [NSMutableDictionary dictionaryWithDictionary:(NSDictionary *)object];
+    
+    NSMutableDictionary *dictionary = [NSMutableDictionary dictionary];
+    [self.modelPropertyDataTypes enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSNumber *dataType, BOOL *stop)
+     {
+         id value = [object valueForKey:key];
+         if(!value)
+             return;
+         
+         if([value isKindOfClass:[NSDate class]])
+             value = [self.modelDateFormatter stringFromDate:value];
+         
+         if([value isKindOfClass:[NSString class]] || [value isKindOfClass:[NSNumber class]] || [NSJSONSerialization isValidJSONObject:@[value]])
+             [dictionary setValue:value forKey:key];
+     }];
+    
+    return dictionary;
+}
+
+- (void)setJSONValue:(id)value forKey:(NSString *)key inObject:(NSObject *)object
+{
+    if(!key)
+        return;
+    
+    NSNumber *dataType = [self.modelPropertyDataTypes objectForKey:key];
+    if(dataType)
+    {
+        value = [self modelValueForJSONValue:value dataType:(SCDataType)[dataType integerValue]];
+        if(!value)
+            return;
+    }
+    
+    [object setValue:value forKey:key];
+}
+
+
 // overrides superclass
 - (SCDataStore *)generateCompatibleDataStore
 {
@@ -39,6 +39,15 @@
 	return self;
 }
 
+// overrides superclass
+- (id)copyWithZone:(NSZone *)zone
+{
+    SCWebServiceFetchOptions *copy = [super copyWithZone:zone];
+    copy.nextBatchURLString = self.nextBatchURLString;
+    copy.nextBatchToken = self.nextBatchToken;
+    
+    return copy;
+}
 
 
 // overrides superclass
@@ -58,6 +58,47 @@
  */
 @property (nonatomic, strong, readonly) NSURLSessionConfiguration *sessionConfiguration;
 
+/**
+ *  The maximum number of batch requests issued concurrently by asynchronousFetchAllObjectsWithOptions:progress:success:failure:noConnection:. Default: 4.
+ */
+@property (nonatomic, readwrite) NSUInteger maximumConcurrentFetchRequests;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Fetching All Objects
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** Asynchronously fetches all the objects available from the web service, batch by batch.
+ 
+ When the web service definition sets batchSizeParameterName, batchStartIndexParameterName and totalCountKeyName, and fetchOptions has a batchSize, the first batch is used to find out the total number of objects and the remaining batches are then requested concurrently (up to maximumConcurrentFetchRequests at a time). Otherwise, the batches are fetched one after the other.
+ 
+ @param fetchOptions The fetch options used for every batch. Its batch offset is reset before fetching starts.
+ @param progress_block Called on the main thread, in order, every time a further contiguous run of batches becomes available. Receives only the newly available objects.
+ @param success_block Called once all batches have been fetched. Receives all the fetched objects, sorted according to fetchOptions and processed by postAsynchronousFetchObjectsAction.
+ @param failure_block Called if any of the batches could not be fetched. Any outstanding batch requests are cancelled.
+ @param noConnection_block Called in case no connection could be established to the web service.
+ */
+- (void)asynchronousFetchAllObjectsWithOptions:(SCDataFetchOptions *)fetchOptions progress:(SCDataStoreFetchSuccess_Block)progress_block success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Observing Changes
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** Returns TRUE if the store is currently subscribed to the web service's change stream. */
+@property (nonatomic, readonly) BOOL isObservingChanges;
+
+/** Subscribes to the change stream specified by the web service definition's changeStreamAPI.
+ 
+ Changes received from the stream are decoded, coalesced per run loop iteration, and then posted in a single SCDataStoreDidChangeObjectsNotification. Sections bound to the store use this notification to insert, reload or remove only the affected rows, without refetching. If the connection drops, the store automatically reconnects after the definition's changeStreamReconnectInterval, resuming from the last received event id.
+ 
+ @note You must call stopObservingChanges when you no longer need the updates, as the store is retained by its change stream connection until then.
+ */
+- (void)startObservingChanges;
+
+/** Unsubscribes from the web service's change stream. Any changes already received are still delivered. */
+- (void)stopObservingChanges;
+
 @end
 
 
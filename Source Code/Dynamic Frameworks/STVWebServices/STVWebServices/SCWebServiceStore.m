@@ -33,13 +33,58 @@
 #define RUN_ON_MAIN_THREAD(CODE)   dispatch_async(dispatch_get_main_queue(), ^{CODE;})
 
 
+// Change stream change types
+static NSString * const kChangeTypeInsert = @"insert";
+static NSString * const kChangeTypeUpdate = @"update";
+static NSString * const kChangeTypeDelete = @"delete";
+static NSString * const kChangeTypeKey = @"type";
+static NSString * const kChangeObjectKey = @"object";
 
-@interface SCWebServiceStore ()
+
+
+// Tracks the state of a parallel batch fetch (used internally by asynchronousFetchAllObjectsWithOptions:)
+@interface SCWebServiceBatchFetch : NSObject
+
+@property (nonatomic, strong) NSMutableArray *batches;      // NSNull until the batch arrives
+@property (nonatomic, strong) NSMutableArray *objects;      // all objects delivered so far, in order
+@property (nonatomic, strong) NSMutableArray *dataTasks;
+@property (nonatomic, readwrite) NSUInteger firstBatchStartIndex;
+@property (nonatomic, readwrite) NSUInteger nextBatchToRequest;
+@property (nonatomic, readwrite) NSUInteger nextBatchToDeliver;
+@property (nonatomic, readwrite) NSUInteger requestsInFlight;
+@property (nonatomic, readwrite) BOOL failed;
+@property (nonatomic, readwrite) BOOL sortedByServer;
+@property (nonatomic, readwrite) BOOL filteredByServer;
+
+@end
+
+@implementation SCWebServiceBatchFetch
+@end
+
+
+
+@interface SCWebServiceStore () <NSURLSessionDataDelegate>
 
 @property (nonatomic, strong, readonly) SCWebServiceDefinition *defaultWebServiceDefinition;
 
 @property (nonatomic, strong) NSURLSessionDataTask *sessionDataTask;
 
+// Change stream
+@property (nonatomic, readwrite) BOOL isObservingChanges;
+@property (nonatomic, strong) NSURLSession *changeStreamSession;
+@property (nonatomic, strong) NSURLSessionDataTask *changeStreamTask;
+@property (nonatomic, strong) NSMutableData *changeStreamBuffer;
+@property (nonatomic, copy) NSString *changeEventType;
+@property (nonatomic, strong) NSMutableString *changeEventData;
+@property (nonatomic, copy) NSString *lastChangeEventId;
+@property (nonatomic, strong) NSMutableArray *pendingChanges;
+@property (nonatomic, strong) NSMutableDictionary *pendingChangesById;
+@property (nonatomic, readwrite) BOOL pendingChangesFlushScheduled;
+
+- (void)asynchronousFetchObjectsWithOptions:(SCDataFetchOptions *)fetchOptions searchString:(NSString *)searchString success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block;
+// Same as above, but also passes success_block the number of objects returned by the web service, before they're filtered locally
+- (void)asynchronousFetchPageWithOptions:(SCDataFetchOptions *)fetchOptions searchString:(NSString *)searchString success:(void (^)(NSArray *results, NSUInteger pageCount))success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block;
+
 @end
 
 
@@ -57,6 +102,12 @@
 	if( (self = [super init]) )
 	{
         _sessionConfiguration = [NSURLSessionConfiguration defaultSessionConfiguration];
+        _maximumConcurrentFetchRequests = 4;
+        
+        _isObservingChanges = FALSE;
+        _pendingChanges = [NSMutableArray array];
+        _pendingChangesById = [NSMutableDictionary dictionary];
+        _pendingChangesFlushScheduled = FALSE;
         
         self.storeMode = SCStoreModeAsynchronous;
 	}
@@ -94,7 +145,12 @@
 {
     [self addDataDefinition:definition];
     
-    NSMutableDictionary *object = [NSMutableDictionary dictionary];
+    NSObject *object;
+    Class modelClass = self.defaultWebServiceDefinition.modelClassDefinition.cls;
+    if(modelClass)
+        object = [[modelClass alloc] init];
+    else
+        object = [NSMutableDictionary dictionary];
     [_uninsertedObjects addObject:object];
     
     return object;
@@ -113,6 +169,20 @@
     return FALSE; 
 }
 
+// overrides superclass
+- (id)objectIdForObject:(NSObject *)object
+{
+    NSString *objectIdKeyName = self.defaultWebServiceDefinition.objectIdKeyName;
+    if(!objectIdKeyName)
+        return nil;
+    
+    id objectId = [object valueForKey:objectIdKeyName];
+    if([objectId isKindOfClass:[NSNull class]])
+        objectId = nil;
+    
+    return objectId;
+}
+
 // overrides superclass
 - (void)asynchronousInsertObject:(NSObject *)object success:(SCDataStoreInsertSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
 {
@@ -147,9 +217,13 @@
         return;
     }
     
+    // only the properties sent now are clean once the insert succeeds
+    NSSet *sentPropertyNames = [self dirtyPropertyNamesForObject:object];
+    
     // serialize object
     NSError *serializeError = nil;
-    NSData *objectData = [NSJSONSerialization dataWithJSONObject:object options:0 error:&serializeError];
+    NSDictionary *objectDictionary = [self.defaultWebServiceDefinition JSONDictionaryWithObject:object];
+    NSData *objectData = [NSJSONSerialization dataWithJSONObject:objectDictionary options:0 error:&serializeError];
     if(serializeError)
     {
         if(failure_block)
@@ -177,12 +251,13 @@
             
             
             [_uninsertedObjects removeObjectIdenticalTo:object];
+            [weak_self clearDirtyPropertyNames:sentPropertyNames forObject:object];
             
             id responseObject = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
             if([responseObject isKindOfClass:[NSDictionary class]] && weak_self.defaultWebServiceDefinition.objectIdKeyName)
             {
                 NSString *objectId = [responseObject valueForKey:weak_self.defaultWebServiceDefinition.objectIdKeyName];
-                [object setValue:objectId forKey:weak_self.defaultWebServiceDefinition.objectIdKeyName];
+                [weak_self.defaultWebServiceDefinition setJSONValue:objectId forKey:weak_self.defaultWebServiceDefinition.objectIdKeyName inObject:object];
             }
             
             if(success_block)
@@ -239,7 +314,32 @@
         }
     }
     
-    NSMutableDictionary *objectDictionary = [NSMutableDictionary dictionaryWithDictionary:(NSDictionary *)object];
+    // only the properties sent now are clean once the update succeeds
+    NSSet *sentPropertyNames = [self dirtyPropertyNamesForObject:object];
+    NSMutableDictionary *objectDictionary = [self.defaultWebServiceDefinition JSONDictionaryWithObject:object];
+    NSString *httpMethod = self.defaultWebServiceDefinition.updateHTTPMethod;
+    if(self.defaultWebServiceDefinition.sendsOnlyChangedKeysOnUpdate)
+    {
+        if(!sentPropertyNames.count)
+        {
+            // nothing to send
+            if(success_block)
+                RUN_ON_MAIN_THREAD(success_block());
+            
+            return;
+        }
+        
+        NSMutableDictionary *changedDictionary = [NSMutableDictionary dictionaryWithCapacity:sentPropertyNames.count];
+        for(NSString *propertyName in sentPropertyNames)
+        {
+            // key paths send their whole top level key
+            NSString *key = [[propertyName componentsSeparatedByString:@"."] objectAtIndex:0];
+            id value = [objectDictionary valueForKey:key];
+            [changedDictionary setValue:(value ? value : [NSNull null]) forKey:key];
+        }
+        objectDictionary = changedDictionary;
+        httpMethod = self.defaultWebServiceDefinition.partialUpdateHTTPMethod;
+    }
     NSArray *readOnlyKeys = [self.defaultWebServiceDefinition.readOnlyKeyNames componentsSeparatedByString:@";"];
     for(NSString *readOnlyKey in readOnlyKeys)
         [objectDictionary removeObjectForKey:readOnlyKey];
@@ -259,8 +359,9 @@
     // Configure the network update call
     NSString *updateURLString = [NSString stringWithFormat:@"%@/%@", [self.defaultWebServiceDefinition.updateURL absoluteString], objectId];
     NSURL *updateURL = [NSURL URLWithString:updateURLString];
-    NSMutableURLRequest *request = [self requestWithURL:updateURL httpMethod:self.defaultWebServiceDefinition.updateHTTPMethod parameters:self.defaultWebServiceDefinition.updateObjectParameters objectData:objectData];
+    NSMutableURLRequest *request = [self requestWithURL:updateURL httpMethod:httpMethod parameters:self.defaultWebServiceDefinition.updateObjectParameters objectData:objectData];
     NSURLSession *session = [NSURLSession sessionWithConfiguration:self.sessionConfiguration];
+    __weak typeof(self) weak_self = self;
     self.sessionDataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error)
         {
             if(error)
@@ -272,6 +373,8 @@
                 return;
             }
             
+            [weak_self clearDirtyPropertyNames:sentPropertyNames forObject:object];
+            
             if(success_block)
                 RUN_ON_MAIN_THREAD(success_block());
         }];
@@ -352,6 +455,21 @@
 
 // overrides superclass
 - (void)asynchronousFetchObjectsWithOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    [self asynchronousFetchObjectsWithOptions:fetchOptions searchString:nil success:success_block failure:failure_block noConnection:noConnection_block];
+}
+
+- (void)asynchronousFetchObjectsWithOptions:(SCDataFetchOptions *)fetchOptions searchString:(NSString *)searchString success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    [self asynchronousFetchPageWithOptions:fetchOptions searchString:searchString success:^(NSArray *results, NSUInteger pageCount)
+     {
+         if(success_block)
+             success_block(results);
+     }
+    failure:failure_block noConnection:noConnection_block];
+}
+
+- (void)asynchronousFetchPageWithOptions:(SCDataFetchOptions *)fetchOptions searchString:(NSString *)searchString success:(void (^)(NSArray *results, NSUInteger pageCount))success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
 {
     if(![SCUtilities IsInternetConnectionAvailable])
     {
@@ -389,15 +507,25 @@
     
     NSMutableString *path = [NSMutableString stringWithString:self.defaultWebServiceDefinition.fetchObjectsAPI];
     
-    NSDictionary *parameters;
+    // let the web service sort and filter whenever it can
+    NSMutableDictionary *queryParameters = [NSMutableDictionary dictionary];
+    BOOL sortedByServer = FALSE;
+    BOOL filteredByServer = FALSE;
+    [self addQueryParametersForFetchOptions:fetchOptions toParameters:queryParameters sortedByServer:&sortedByServer filteredByServer:&filteredByServer];
+    
+    NSMutableDictionary *parameters;
     if(webFetchOptions.nextBatchURLString)
     {
+        // the next batch URL returned by the web service already carries the original query
         [path appendString:webFetchOptions.nextBatchURLString];
         parameters = nil;
     }
     else 
     {
-        parameters = self.defaultWebServiceDefinition.fetchObjectsParameters;
+        parameters = [NSMutableDictionary dictionaryWithDictionary:self.defaultWebServiceDefinition.fetchObjectsParameters];
+        [parameters addEntriesFromDictionary:queryParameters];
+        if(searchString)
+            [parameters setValue:searchString forKey:self.defaultWebServiceDefinition.searchParameterName];
         
         if(webFetchOptions.nextBatchToken)
         {
@@ -436,7 +564,7 @@
                                 }
                                 
                                 NSError *JSONError;
-                                id JSON = [NSJSONSerialization JSONObjectWithData:data options:0 error:&JSONError];
+                                id JSON = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&JSONError];
                                 
                                 if(JSONError)
                                 {
@@ -447,22 +575,8 @@
                                     return;
                                 }
                                 
-                                NSArray *resultsArray = nil;
-                                if([JSON isKindOfClass:[NSArray class]])
-                                {
-                                    resultsArray = (NSArray *)JSON;
-                                }
-                                else
+                                if([JSON isKindOfClass:[NSDictionary class]])
                                 {
-                                    if(![JSON isKindOfClass:[NSDictionary class]])
-                                    {
-                                        if(failure_block)
-                                            RUN_ON_MAIN_THREAD(failure_block(nil));
-                                        SCDebugLog(@"Error: Invalid web service response. Expecting 'NSDictionary' but got '%@' instead.", NSStringFromClass([JSON class]));
-                                        
-                                        return;
-                                    }
-                                    
                                     if(weak_self.defaultWebServiceDefinition.nextBatchURLKeyName && webFetchOptions)
                                     {
                                         webFetchOptions.nextBatchURLString = [JSON valueForSensibleKeyPath:weak_self.defaultWebServiceDefinition.nextBatchURLKeyName];
@@ -479,94 +593,543 @@
                                                 webFetchOptions.nextBatchToken = [JSON valueForSensibleKeyPath:weak_self.defaultWebServiceDefinition.nextBatchTokenKeyName];
                                                 [webFetchOptions incrementBatchOffset];
                                             }
-                                    
-                                    
-                                    if(weak_self.defaultWebServiceDefinition.atomicResultKeyName)
-                                    {
-                                        id atomicResult = [JSON valueForSensibleKeyPath:weak_self.defaultWebServiceDefinition.atomicResultKeyName];
-                                        NSArray *atomicArray;
-                                        if([atomicResult isKindOfClass:[NSArray class]])
-                                        {
-                                            atomicArray = atomicResult;
-                                        }
-                                        else
-                                        {
-                                            atomicArray = [NSArray arrayWithObject:atomicResult];
-                                        }
-                                        
-                                        if(weak_self.defaultWebServiceDefinition.resultsKeyName && atomicArray.count)
-                                        {
-                                            NSDictionary *dictionary = [atomicArray objectAtIndex:0];
-                                            resultsArray = [dictionary valueForKey:weak_self.defaultWebServiceDefinition.resultsKeyName];
-                                        }
-                                        else
-                                        {
-                                            resultsArray = atomicArray;
-                                        }
-                                    }
-                                    else
-                                    {
-                                        if(!weak_self.defaultWebServiceDefinition.resultsKeyName)
-                                        {
-                                            if(failure_block)
-                                                RUN_ON_MAIN_THREAD(failure_block(nil));
-                                            SCDebugLog(@"Error: Can't fetch results from web service dictionary since resultsKeyName is nil.");
-                                            
-                                            return;
-                                        }
-                                        
-                                        resultsArray = [JSON valueForSensibleKeyPath:weak_self.defaultWebServiceDefinition.resultsKeyName];
-                                    }
-                                    
-                                    if(!resultsArray)
-                                    {
-                                        if(failure_block)
-                                            RUN_ON_MAIN_THREAD(failure_block(nil));
-                                        SCDebugLog(@"Error: resultsKeyName:'%@' does not exist in returned response.", weak_self.defaultWebServiceDefinition.resultsKeyName);
-                                        
-                                        return;
-                                    }
-                                    
-                                    if(![resultsArray isKindOfClass:[NSArray class]])
-                                    {
-                                        if(failure_block)
-                                            RUN_ON_MAIN_THREAD(failure_block(nil));
-                                        SCDebugLog(@"Error: Invalid web service response. Expecting results array with type 'NSArray' but got '%@' instead.", NSStringFromClass([resultsArray class]));
-                                        
-                                        return;
-                                    }
                                 }
                                 
-                                NSMutableArray *array = [NSMutableArray array];
-                                for (NSDictionary *dictionary in resultsArray)
+                                NSMutableArray *array = [weak_self objectsFromJSON:JSON];
+                                if(!array)
                                 {
-                                    if(![dictionary isKindOfClass:[NSDictionary class]])
-                                    {
-                                        if(failure_block)
-                                            RUN_ON_MAIN_THREAD(failure_block(nil));
-                                        SCDebugLog(@"Error: Invalid web service response. Expecting results item of type'NSDictionary' but got '%@' instead.", NSStringFromClass([dictionary class]));
-                                        
-                                        return;
-                                    }
+                                    if(failure_block)
+                                        RUN_ON_MAIN_THREAD(failure_block(nil));
                                     
-                                    NSMutableDictionary *webObject = [NSMutableDictionary dictionaryWithDictionary:dictionary];
-                                    [array addObject:webObject];
+                                    return;
                                 }
                                 
+                                NSUInteger pageCount = array.count;
                                 if(fetchOptions)
                                 {
-                                    [fetchOptions filterMutableArray:array];
-                                    [fetchOptions sortMutableArray:array];
+                                    if(!filteredByServer)
+                                        [fetchOptions filterMutableArray:array];
+                                    if(!sortedByServer)
+                                        [fetchOptions sortMutableArray:array];
                                 }
                                 
                                 if(success_block)
-                                    RUN_ON_MAIN_THREAD(success_block(array));
+                                    RUN_ON_MAIN_THREAD(success_block(array, pageCount));
                             }];
     
     // Intiate the network update call
     [self.sessionDataTask resume];
 }
 
+- (void)asynchronousFetchAllObjectsWithOptions:(SCDataFetchOptions *)fetchOptions progress:(SCDataStoreFetchSuccess_Block)progress_block success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    [fetchOptions resetBatchOffset];
+    
+    SCWebServiceDefinition *definition = self.defaultWebServiceDefinition;
+    if(!fetchOptions.batchSize || !definition.batchSizeParameterName || !definition.batchStartIndexParameterName || !definition.totalCountKeyName || !definition.fetchObjectsAPI || ![SCUtilities IsInternetConnectionAvailable])
+    {
+        // total count can't be known upfront, fetch batches one after the other
+        [self sequentiallyFetchAllObjectsWithOptions:fetchOptions fetchedObjects:[NSMutableArray array] progress:progress_block success:success_block failure:failure_block noConnection:noConnection_block];
+        
+        return;
+    }
+    
+    SCWebServiceBatchFetch *batchFetch = [[SCWebServiceBatchFetch alloc] init];
+    batchFetch.objects = [NSMutableArray array];
+    batchFetch.dataTasks = [NSMutableArray array];
+    batchFetch.firstBatchStartIndex = fetchOptions.nextBatchStartIndex;
+    BOOL sortedByServer = FALSE;
+    BOOL filteredByServer = FALSE;
+    [self addQueryParametersForFetchOptions:fetchOptions toParameters:[NSMutableDictionary dictionary] sortedByServer:&sortedByServer filteredByServer:&filteredByServer];
+    batchFetch.sortedByServer = sortedByServer;
+    batchFetch.filteredByServer = filteredByServer;
+    
+    NSURLSession *session = [NSURLSession sessionWithConfiguration:self.sessionConfiguration];
+    __weak typeof(self) weak_self = self;
+    NSURLSessionDataTask *firstTask = [self dataTaskForBatchAtStartIndex:batchFetch.firstBatchStartIndex fetchOptions:fetchOptions session:session completion:^(NSMutableArray *objects, id JSON, NSError *error)
+        {
+            if(!objects)
+            {
+                if(failure_block)
+                    failure_block(error);
+                
+                return;
+            }
+            
+            // the first batch reveals the total number of batches
+            NSUInteger totalCount = 0;
+            if([JSON isKindOfClass:[NSDictionary class]])
+                totalCount = [[JSON valueForSensibleKeyPath:definition.totalCountKeyName] unsignedIntegerValue];
+            NSUInteger batchCount = 1;
+            if(totalCount > batchFetch.firstBatchStartIndex)
+                batchCount = MAX(1, (totalCount - batchFetch.firstBatchStartIndex + fetchOptions.batchSize - 1) / fetchOptions.batchSize);
+            
+            batchFetch.batches = [NSMutableArray arrayWithCapacity:batchCount];
+            for(NSUInteger i=0; i<batchCount; i++)
+                [batchFetch.batches addObject:[NSNull null]];
+            [batchFetch.batches replaceObjectAtIndex:0 withObject:objects];
+            batchFetch.nextBatchToRequest = 1;
+            
+            [weak_self deliverBatchesForBatchFetch:batchFetch fetchOptions:fetchOptions session:session progress:progress_block success:success_block failure:failure_block];
+        }];
+    [batchFetch.dataTasks addObject:firstTask];
+    [firstTask resume];
+}
+
+- (void)deliverBatchesForBatchFetch:(SCWebServiceBatchFetch *)batchFetch fetchOptions:(SCDataFetchOptions *)fetchOptions session:(NSURLSession *)session progress:(SCDataStoreFetchSuccess_Block)progress_block success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block
+{
+    // deliver the contiguous run of batches that has arrived so far
+    NSMutableArray *deliveredObjects = [NSMutableArray array];
+    while(batchFetch.nextBatchToDeliver < batchFetch.batches.count)
+    {
+        NSMutableArray *batch = [batchFetch.batches objectAtIndex:batchFetch.nextBatchToDeliver];
+        if(![batch isKindOfClass:[NSMutableArray class]])
+            break;
+        
+        if(!batchFetch.filteredByServer)
+            [fetchOptions filterMutableArray:batch];
+        [deliveredObjects addObjectsFromArray:batch];
+        [fetchOptions incrementBatchOffset];
+        
+        [batchFetch.batches replaceObjectAtIndex:batchFetch.nextBatchToDeliver withObject:[NSNull null]];  // release batch
+        batchFetch.nextBatchToDeliver++;
+    }
+    if(deliveredObjects.count)
+    {
+        [batchFetch.objects addObjectsFromArray:deliveredObjects];
+        if(progress_block)
+            progress_block(deliveredObjects);
+    }
+    
+    if(batchFetch.nextBatchToDeliver == batchFetch.batches.count)
+    {
+        [batchFetch.dataTasks removeAllObjects];
+        
+        if(!batchFetch.sortedByServer)
+            [fetchOptions sortMutableArray:batchFetch.objects];
+        [self fetchObjectsSuccessful:batchFetch.objects successBlock:success_block failure:failure_block];
+        
+        return;
+    }
+    
+    // keep up to maximumConcurrentFetchRequests batch requests in flight
+    NSUInteger maxRequests = MAX(1, self.maximumConcurrentFetchRequests);
+    __weak typeof(self) weak_self = self;
+    while(batchFetch.requestsInFlight < maxRequests && batchFetch.nextBatchToRequest < batchFetch.batches.count)
+    {
+        NSUInteger batchIndex = batchFetch.nextBatchToRequest;
+        NSUInteger startIndex = batchFetch.firstBatchStartIndex + batchIndex*fetchOptions.batchSize;
+        NSURLSessionDataTask *task = [self dataTaskForBatchAtStartIndex:startIndex fetchOptions:fetchOptions session:session completion:^(NSMutableArray *objects, id JSON, NSError *error)
+            {
+                if(batchFetch.failed)
+                    return;
+                
+                batchFetch.requestsInFlight--;
+                if(!objects)
+                {
+                    batchFetch.failed = TRUE;
+                    for(NSURLSessionDataTask *dataTask in batchFetch.dataTasks)
+                        [dataTask cancel];
+                    [batchFetch.dataTasks removeAllObjects];
+                    
+                    if(failure_block)
+                        failure_block(error);
+                    
+                    return;
+                }
+                
+                [batchFetch.batches replaceObjectAtIndex:batchIndex withObject:objects];
+                [weak_self deliverBatchesForBatchFetch:batchFetch fetchOptions:fetchOptions session:session progress:progress_block success:success_block failure:failure_block];
+            }];
+        [batchFetch.dataTasks addObject:task];
+        batchFetch.requestsInFlight++;
+        batchFetch.nextBatchToRequest++;
+        [task resume];
+    }
+}
+
+- (void)sequentiallyFetchAllObjectsWithOptions:(SCDataFetchOptions *)fetchOptions fetchedObjects:(NSMutableArray *)fetchedObjects progress:(SCDataStoreFetchSuccess_Block)progress_block success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    __weak typeof(self) weak_self = self;
+    [self asynchronousFetchPageWithOptions:fetchOptions searchString:nil success:^(NSArray *results, NSUInteger pageCount)
+     {
+         [fetchedObjects addObjectsFromArray:results];
+         if(results.count && progress_block)
+             progress_block(results);
+         
+         // the page size returned by the web service tells if there are more batches, since local filtering can drop any of its objects
+         BOOL moreBatches = FALSE;
+         if(fetchOptions.batchSize && pageCount)
+         {
+             SCWebServiceFetchOptions *webFetchOptions = nil;
+             if([fetchOptions isKindOfClass:[SCWebServiceFetchOptions class]])
+                 webFetchOptions = (SCWebServiceFetchOptions *)fetchOptions;
+             
+             if(weak_self.defaultWebServiceDefinition.nextBatchURLKeyName)
+                 moreBatches = webFetchOptions.nextBatchURLString.length > 0;
+             else
+                 if(weak_self.defaultWebServiceDefinition.nextBatchTokenKeyName && !weak_self.defaultWebServiceDefinition.batchStartIndexParameterName)
+                     moreBatches = webFetchOptions.nextBatchToken.length > 0;
+                 else
+                     moreBatches = pageCount >= fetchOptions.batchSize;
+         }
+         
+         if(moreBatches && weak_self)
+         {
+             [weak_self sequentiallyFetchAllObjectsWithOptions:fetchOptions fetchedObjects:fetchedObjects progress:progress_block success:success_block failure:failure_block noConnection:noConnection_block];
+         }
+         else
+         {
+             // batches sorted by the web service are already in order across the whole data set
+             BOOL sortedByServer = FALSE;
+             [weak_self addQueryParametersForFetchOptions:fetchOptions toParameters:[NSMutableDictionary dictionary] sortedByServer:&sortedByServer filteredByServer:NULL];
+             if(!sortedByServer)
+                 [fetchOptions sortMutableArray:fetchedObjects];
+             if(success_block)
+                 success_block(fetchedObjects);
+         }
+     }
+    failure:failure_block noConnection:noConnection_block];
+}
+
+// overrides superclass
+- (void)asynchronousSearchObjectsForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames withOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    SCWebServiceDefinition *definition = self.defaultWebServiceDefinition;
+    if(!definition.searchParameterName)
+    {
+        // the web service can't search, so the fetched objects are searched locally
+        NSPredicate *searchPredicate = [self searchPredicateForString:searchString propertyNames:propertyNames];
+        [self asynchronousFetchObjectsWithOptions:fetchOptions success:^(NSArray *results)
+         {
+             if(success_block)
+                 success_block([results filteredArrayUsingPredicate:searchPredicate]);
+         }
+        failure:failure_block noConnection:noConnection_block];
+        
+        return;
+    }
+    
+    [self asynchronousFetchObjectsWithOptions:fetchOptions searchString:searchString success:success_block failure:failure_block noConnection:noConnection_block];
+}
+
+// overrides superclass
+- (NSUInteger)countObjectsWithOptions:(SCDataFetchOptions *)fetchOptions
+{
+    return NSNotFound;  // web service objects can only be counted asynchronously
+}
+
+// overrides superclass
+- (void)asynchronousCountObjectsWithOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreCountSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    SCWebServiceDefinition *definition = self.defaultWebServiceDefinition;
+    
+    NSString *countKeyName;
+    NSURL *countURL;
+    NSMutableDictionary *parameters = [NSMutableDictionary dictionaryWithDictionary:definition.fetchObjectsParameters];
+    if(definition.countURL)
+    {
+        countURL = definition.countURL;
+        countKeyName = definition.countKeyName;
+    }
+    else
+        if(definition.fetchObjectsAPI && definition.totalCountKeyName && definition.batchSizeParameterName && definition.batchStartIndexParameterName)
+        {
+            // fetch a single object and read the total count that comes with it
+            countURL = [NSURL URLWithString:definition.fetchObjectsAPI relativeToURL:definition.baseURL];
+            countKeyName = definition.totalCountKeyName;
+            [parameters setValue:[NSNumber numberWithUnsignedInteger:1] forKey:definition.batchSizeParameterName];
+            [parameters setValue:[NSNumber numberWithUnsignedInteger:definition.batchInitialStartIndex] forKey:definition.batchStartIndexParameterName];
+        }
+        else
+        {
+            if(failure_block)
+                failure_block(nil);
+            
+            return;
+        }
+    
+    // the count is only meaningful if the web service evaluates the filter itself
+    BOOL filteredByServer = FALSE;
+    [self addQueryParametersForFetchOptions:fetchOptions toParameters:parameters sortedByServer:NULL filteredByServer:&filteredByServer];
+    if(fetchOptions.filterPredicate && !filteredByServer)
+    {
+        if(failure_block)
+            failure_block(nil);
+        
+        return;
+    }
+    
+    if(![SCUtilities IsInternetConnectionAvailable])
+    {
+        if(noConnection_block)
+            noConnection_block();
+        if(failure_block)
+            failure_block([NSError errorWithDomain:kNoInternetConnectionString code:0 userInfo:nil]);
+        
+        return;
+    }
+    
+    NSMutableURLRequest *request = [self requestWithURL:countURL httpMethod:@"GET" parameters:parameters objectData:nil];
+    NSURLSession *session = [NSURLSession sessionWithConfiguration:self.sessionConfiguration];
+    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error)
+        {
+            if(error)
+            {
+                SCDebugLog(@"Web Service error during GET: %@", error);
+                if(failure_block)
+                    RUN_ON_MAIN_THREAD(failure_block(error));
+                
+                return;
+            }
+            
+            NSError *JSONError;
+            id JSON = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingAllowFragments error:&JSONError];
+            
+            id countValue = nil;
+            if([JSON isKindOfClass:[NSNumber class]])
+                countValue = JSON;
+            else
+                if([JSON isKindOfClass:[NSDictionary class]])
+                    countValue = [JSON valueForSensibleKeyPath:countKeyName];
+            
+            if(JSONError || ![countValue respondsToSelector:@selector(unsignedIntegerValue)])
+            {
+                if(failure_block)
+                    RUN_ON_MAIN_THREAD(failure_block(nil));
+                SCDebugLog(@"Error: Unable to read object count from JSON data:%@", JSONError);
+                
+                return;
+            }
+            
+            if(success_block)
+                RUN_ON_MAIN_THREAD(success_block([countValue unsignedIntegerValue]));
+        }];
+    [dataTask resume];
+}
+
+// overrides superclass
+- (void)asynchronousFetchGroupsForPropertyName:(NSString *)propertyName withOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    SCWebServiceDefinition *definition = self.defaultWebServiceDefinition;
+    
+    NSMutableDictionary *parameters = [NSMutableDictionary dictionaryWithDictionary:definition.fetchObjectsParameters];
+    BOOL filteredByServer = FALSE;
+    [self addQueryParametersForFetchOptions:fetchOptions toParameters:parameters sortedByServer:NULL filteredByServer:&filteredByServer];
+    
+    // the groups are only meaningful if the web service evaluates the filter itself
+    if(!definition.groupsURL || (fetchOptions.filterPredicate && !filteredByServer))
+    {
+        [super asynchronousFetchGroupsForPropertyName:propertyName withOptions:fetchOptions success:success_block failure:failure_block noConnection:noConnection_block];
+        
+        return;
+    }
+    
+    if(![SCUtilities IsInternetConnectionAvailable])
+    {
+        if(noConnection_block)
+            noConnection_block();
+        if(failure_block)
+            failure_block([NSError errorWithDomain:kNoInternetConnectionString code:0 userInfo:nil]);
+        
+        return;
+    }
+    
+    NSString *parameterName = [definition.queryParameterNames valueForKey:propertyName];
+    [parameters setValue:(parameterName ? parameterName : propertyName) forKey:definition.groupByParameterName];
+    
+    NSMutableURLRequest *request = [self requestWithURL:definition.groupsURL httpMethod:@"GET" parameters:parameters objectData:nil];
+    NSURLSession *session = [NSURLSession sessionWithConfiguration:self.sessionConfiguration];
+    __weak typeof(self) weak_self = self;
+    NSURLSessionDataTask *dataTask = [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error)
+        {
+            if(error)
+            {
+                SCDebugLog(@"Web Service error during GET: %@", error);
+                if(failure_block)
+                    RUN_ON_MAIN_THREAD(failure_block(error));
+                
+                return;
+            }
+            
+            NSError *JSONError;
+            id JSON = [NSJSONSerialization JSONObjectWithData:data options:0 error:&JSONError];
+            if([JSON isKindOfClass:[NSDictionary class]] && definition.resultsKeyName)
+                JSON = [JSON valueForSensibleKeyPath:definition.resultsKeyName];
+            
+            if(JSONError || ![JSON isKindOfClass:[NSArray class]])
+            {
+                if(failure_block)
+                    RUN_ON_MAIN_THREAD(failure_block(nil));
+                SCDebugLog(@"Error: Unable to read object groups from JSON data:%@", JSONError);
+                
+                return;
+            }
+            
+            NSMutableArray *groups = [NSMutableArray arrayWithCapacity:[(NSArray *)JSON count]];
+            for(NSDictionary *groupDictionary in (NSArray *)JSON)
+            {
+                if(![groupDictionary isKindOfClass:[NSDictionary class]])
+                    continue;
+                
+                NSObject *value = [groupDictionary valueForKey:definition.groupValueKeyName];
+                NSNumber *count = [groupDictionary valueForKey:definition.groupCountKeyName];
+                if(!value)
+                    value = [NSNull null];
+                if(![count respondsToSelector:@selector(unsignedIntegerValue)])
+                    continue;
+                
+                [groups addObject:[NSDictionary dictionaryWithObjectsAndKeys:value, SCDataStoreGroupValueKey, [NSNumber numberWithUnsignedInteger:[count unsignedIntegerValue]], SCDataStoreGroupCountKey, nil]];
+            }
+            [weak_self sortGroups:groups];
+            
+            if(success_block)
+                RUN_ON_MAIN_THREAD(success_block(groups));
+        }];
+    [dataTask resume];
+}
+
+// Returns a data task that fetches the batch at the given start index without modifying the fetch options. The completion handler is called on the main thread with a nil objects array on failure.
+- (NSURLSessionDataTask *)dataTaskForBatchAtStartIndex:(NSUInteger)startIndex fetchOptions:(SCDataFetchOptions *)fetchOptions session:(NSURLSession *)session completion:(void(^)(NSMutableArray *objects, id JSON, NSError *error))completion
+{
+    SCWebServiceDefinition *definition = self.defaultWebServiceDefinition;
+    
+    // every concurrent request gets its own copy of the parameters
+    NSMutableDictionary *parameters = [NSMutableDictionary dictionaryWithDictionary:definition.fetchObjectsParameters];
+    [self addQueryParametersForFetchOptions:fetchOptions toParameters:parameters sortedByServer:NULL filteredByServer:NULL];
+    [parameters setValue:[NSNumber numberWithUnsignedInteger:fetchOptions.batchSize] forKey:definition.batchSizeParameterName];
+    [parameters setValue:[NSNumber numberWithUnsignedInteger:definition.batchInitialStartIndex+startIndex] forKey:definition.batchStartIndexParameterName];
+    
+    NSURL *fetchObjectsURL = [NSURL URLWithString:definition.fetchObjectsAPI relativeToURL:definition.baseURL];
+    NSMutableURLRequest *request = [self requestWithURL:fetchObjectsURL httpMethod:@"GET" parameters:parameters objectData:nil];
+    __weak typeof(self) weak_self = self;
+    return [session dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error)
+            {
+                if(error)
+                {
+                    SCDebugLog(@"Web Service error during GET: %@", error);
+                    RUN_ON_MAIN_THREAD(completion(nil, nil, error));
+                    
+                    return;
+                }
+                
+                NSError *JSONError;
+                id JSON = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&JSONError];
+                NSMutableArray *objects = nil;
+                if(JSONError)
+                    SCDebugLog(@"Error: Error while deserializing JSON data:%@", JSONError);
+                else
+                    objects = [weak_self objectsFromJSON:JSON];
+                
+                RUN_ON_MAIN_THREAD(completion(objects, JSON, nil));
+            }];
+}
+
+// Adds the sort and filter parameters of the fetch options that the web service is able to evaluate
+- (void)addQueryParametersForFetchOptions:(SCDataFetchOptions *)fetchOptions toParameters:(NSMutableDictionary *)parameters sortedByServer:(BOOL *)sortedByServer filteredByServer:(BOOL *)filteredByServer
+{
+    SCWebServiceDefinition *definition = self.defaultWebServiceDefinition;
+    
+    BOOL sorted = FALSE;
+    if(fetchOptions.sort && fetchOptions.sortKey)
+        sorted = [definition addSortParametersForKey:fetchOptions.sortKey ascending:fetchOptions.sortAscending toParameters:parameters];
+    
+    BOOL filtered = FALSE;
+    if(fetchOptions.filterPredicate)
+        filtered = [definition addFilterParametersForPredicate:fetchOptions.filterPredicate toParameters:parameters];
+    
+    if(sortedByServer)
+        *sortedByServer = sorted;
+    if(filteredByServer)
+        *filteredByServer = filtered;
+}
+
+// Extracts the results array from the returned JSON and decodes its objects. Returns nil if the JSON is not a valid results response.
+- (NSMutableArray *)objectsFromJSON:(id)JSON
+{
+    SCWebServiceDefinition *webServiceDefinition = self.defaultWebServiceDefinition;
+    
+    NSArray *resultsArray = nil;
+    if([JSON isKindOfClass:[NSArray class]])
+    {
+        resultsArray = (NSArray *)JSON;
+    }
+    else
+    {
+        if(![JSON isKindOfClass:[NSDictionary class]])
+        {
+            SCDebugLog(@"Error: Invalid web service response. Expecting 'NSDictionary' but got '%@' instead.", NSStringFromClass([JSON class]));
+            
+            return nil;
+        }
+        
+        if(webServiceDefinition.atomicResultKeyName)
+        {
+            id atomicResult = [JSON valueForSensibleKeyPath:webServiceDefinition.atomicResultKeyName];
+            NSArray *atomicArray;
+            if([atomicResult isKindOfClass:[NSArray class]])
+            {
+                atomicArray = atomicResult;
+            }
+            else
+            {
+                atomicArray = [NSArray arrayWithObject:atomicResult];
+            }
+            
+            if(webServiceDefinition.resultsKeyName && atomicArray.count)
+            {
+                NSDictionary *dictionary = [atomicArray objectAtIndex:0];
+                resultsArray = [dictionary valueForKey:webServiceDefinition.resultsKeyName];
+            }
+            else
+            {
+                resultsArray = atomicArray;
+            }
+        }
+        else
+        {
+            if(!webServiceDefinition.resultsKeyName)
+            {
+                SCDebugLog(@"Error: Can't fetch results from web service dictionary since resultsKeyName is nil.");
+                
+                return nil;
+            }
+            
+            resultsArray = [JSON valueForSensibleKeyPath:webServiceDefinition.resultsKeyName];
+        }
+        
+        if(!resultsArray)
+        {
+            SCDebugLog(@"Error: resultsKeyName:'%@' does not exist in returned response.", webServiceDefinition.resultsKeyName);
+            
+            return nil;
+        }
+        
+        if(![resultsArray isKindOfClass:[NSArray class]])
+        {
+            SCDebugLog(@"Error: Invalid web service response. Expecting results array with type 'NSArray' but got '%@' instead.", NSStringFromClass([resultsArray class]));
+            
+            return nil;
+        }
+    }
+    
+    // decode results while still on the session's background queue
+    NSMutableArray *array = [NSMutableArray arrayWithCapacity:resultsArray.count];
+    for (NSDictionary *dictionary in resultsArray)
+    {
+        if(![dictionary isKindOfClass:[NSDictionary class]])
+        {
+            SCDebugLog(@"Error: Invalid web service response. Expecting results item of type'NSDictionary' but got '%@' instead.", NSStringFromClass([dictionary class]));
+            
+            return nil;
+        }
+        
+        NSObject *webObject = [webServiceDefinition objectWithJSONDictionary:dictionary];
+        [array addObject:webObject];
+    }
+    
+    return array;
+}
 - (BOOL)validateInsertForObject:(NSObject *)object
 {
     return self.defaultWebServiceDefinition.insertObjectAPI != nil;
@@ -596,6 +1159,273 @@
 
 
 
+#pragma mark - Change stream
+
+- (void)startObservingChanges
+{
+    if(self.isObservingChanges)
+        return;
+    
+    if(!self.defaultWebServiceDefinition.changeStreamAPI)
+    {
+        SCDebugLog(@"Warning: No valid changeStreamAPI specified in SCWebServiceDefinition.");
+        
+        return;
+    }
+    
+    self.isObservingChanges = TRUE;
+    
+    // Change events are parsed and decoded on a serial background queue
+    NSOperationQueue *delegateQueue = [[NSOperationQueue alloc] init];
+    delegateQueue.maxConcurrentOperationCount = 1;
+    NSURLSessionConfiguration *configuration = [self.sessionConfiguration copy];
+    configuration.timeoutIntervalForRequest = DBL_MAX;
+    self.changeStreamSession = [NSURLSession sessionWithConfiguration:configuration delegate:self delegateQueue:delegateQueue];
+    
+    [self connectToChangeStream];
+}
+
+- (void)stopObservingChanges
+{
+    if(!self.isObservingChanges)
+        return;
+    
+    self.isObservingChanges = FALSE;
+    
+    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(connectToChangeStream) object:nil];
+    
+    // invalidating the session releases its strong reference to the store
+    [self.changeStreamSession invalidateAndCancel];
+    self.changeStreamSession = nil;
+    self.changeStreamTask = nil;
+}
+
+- (void)connectToChangeStream
+{
+    if(!self.isObservingChanges)
+        return;
+    
+    NSMutableURLRequest *request = [self requestWithURL:self.defaultWebServiceDefinition.changeStreamURL httpMethod:@"GET" parameters:nil objectData:nil];
+    [request setValue:@"text/event-stream" forHTTPHeaderField:@"Accept"];
+    [request setValue:@"no-cache" forHTTPHeaderField:@"Cache-Control"];
+    [request setCachePolicy:NSURLRequestReloadIgnoringLocalCacheData];
+    if(self.lastChangeEventId)
+        [request setValue:self.lastChangeEventId forHTTPHeaderField:@"Last-Event-ID"];
+    
+    self.changeStreamBuffer = [NSMutableData data];
+    self.changeEventType = nil;
+    self.changeEventData = [NSMutableString string];
+    
+    self.changeStreamTask = [self.changeStreamSession dataTaskWithRequest:request];
+    [self.changeStreamTask resume];
+}
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data
+{
+    if(dataTask != self.changeStreamTask)
+        return;
+    
+    [self.changeStreamBuffer appendData:data];
+    
+    // process all the complete lines received so far, keeping any partial line for later
+    const char newline = '\n';
+    NSData *newlineData = [NSData dataWithBytes:&newline length:1];
+    NSRange searchRange = NSMakeRange(0, self.changeStreamBuffer.length);
+    NSRange newlineRange = [self.changeStreamBuffer rangeOfData:newlineData options:0 range:searchRange];
+    while(newlineRange.location != NSNotFound)
+    {
+        NSData *lineData = [self.changeStreamBuffer subdataWithRange:NSMakeRange(searchRange.location, newlineRange.location-searchRange.location)];
+        NSString *line = [[NSString alloc] initWithData:lineData encoding:NSUTF8StringEncoding];
+        if(line)
+        {
+            if([line hasSuffix:@"\r"])
+                line = [line substringToIndex:line.length-1];
+            [self processChangeStreamLine:line];
+        }
+        
+        searchRange.location = NSMaxRange(newlineRange);
+        searchRange.length = self.changeStreamBuffer.length - searchRange.location;
+        newlineRange = [self.changeStreamBuffer rangeOfData:newlineData options:0 range:searchRange];
+    }
+    [self.changeStreamBuffer replaceBytesInRange:NSMakeRange(0, searchRange.location) withBytes:NULL length:0];
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error
+{
+    if(task != self.changeStreamTask)
+        return;
+    
+    if(error)
+        SCDebugLog(@"Web Service change stream error: %@", error);
+    
+    __weak typeof(self) weak_self = self;
+    RUN_ON_MAIN_THREAD(
+                       if(weak_self.isObservingChanges)
+                           [weak_self performSelector:@selector(connectToChangeStream) withObject:nil afterDelay:weak_self.defaultWebServiceDefinition.changeStreamReconnectInterval];
+                       );
+}
+
+// Parses a single text/event-stream line, dispatching the current event when a blank line is reached
+- (void)processChangeStreamLine:(NSString *)line
+{
+    if(!line.length)
+    {
+        if(self.changeEventData.length)
+        {
+            // remove the trailing newline
+            [self.changeEventData deleteCharactersInRange:NSMakeRange(self.changeEventData.length-1, 1)];
+            [self dispatchChangeEventWithType:self.changeEventType data:self.changeEventData];
+        }
+        self.changeEventType = nil;
+        self.changeEventData = [NSMutableString string];
+        
+        return;
+    }
+    
+    if([line hasPrefix:@":"])
+        return;  // comment (typically a keep-alive)
+    
+    NSString *field = line;
+    NSString *value = @"";
+    NSRange colonRange = [line rangeOfString:@":"];
+    if(colonRange.location != NSNotFound)
+    {
+        field = [line substringToIndex:colonRange.location];
+        value = [line substringFromIndex:NSMaxRange(colonRange)];
+        if([value hasPrefix:@" "])
+            value = [value substringFromIndex:1];
+    }
+    
+    if([field isEqualToString:@"event"])
+    {
+        self.changeEventType = value;
+    }
+    else if([field isEqualToString:@"data"])
+    {
+        [self.changeEventData appendString:value];
+        [self.changeEventData appendString:@"\n"];
+    }
+    else if([field isEqualToString:@"id"])
+    {
+        // read on the main thread when reconnecting, and only valid once the events before it have been dispatched there
+        __weak typeof(self) weak_self = self;
+        RUN_ON_MAIN_THREAD(weak_self.lastChangeEventId = value);
+    }
+}
+
+- (void)dispatchChangeEventWithType:(NSString *)eventType data:(NSString *)eventData
+{
+    SCWebServiceDefinition *webServiceDefinition = self.defaultWebServiceDefinition;
+    
+    NSError *error = nil;
+    id JSON = [NSJSONSerialization JSONObjectWithData:[eventData dataUsingEncoding:NSUTF8StringEncoding] options:NSJSONReadingMutableContainers error:&error];
+    if(![JSON isKindOfClass:[NSDictionary class]])
+    {
+        SCDebugLog(@"Error: Invalid change event data. Expecting 'NSDictionary' but got: %@", eventData);
+        
+        return;
+    }
+    
+    NSString *changeType = eventType;
+    if(!changeType.length || [changeType isEqualToString:@"message"])
+        changeType = [JSON valueForKey:webServiceDefinition.changeTypeKeyName];
+    if(![changeType isKindOfClass:[NSString class]])
+        changeType = nil;
+    changeType = [changeType lowercaseString];
+    if(![changeType isEqualToString:kChangeTypeInsert] && ![changeType isEqualToString:kChangeTypeUpdate] && ![changeType isEqualToString:kChangeTypeDelete])
+    {
+        SCDebugLog(@"Warning: Ignoring change event with unknown type: %@", changeType);
+        
+        return;
+    }
+    
+    NSDictionary *objectDictionary = JSON;
+    if(webServiceDefinition.changeObjectKeyName)
+        objectDictionary = [JSON valueForSensibleKeyPath:webServiceDefinition.changeObjectKeyName];
+    if(![objectDictionary isKindOfClass:[NSDictionary class]])
+    {
+        SCDebugLog(@"Error: changeObjectKeyName:'%@' does not exist in change event data.", webServiceDefinition.changeObjectKeyName);
+        
+        return;
+    }
+    
+    NSObject *object = [webServiceDefinition objectWithJSONDictionary:objectDictionary];
+    
+    __weak typeof(self) weak_self = self;
+    RUN_ON_MAIN_THREAD([weak_self queueChangeOfType:changeType forObject:object]);
+}
+
+// Coalesces the changes received for the same object until the pending changes are flushed
+- (void)queueChangeOfType:(NSString *)changeType forObject:(NSObject *)object
+{
+    id objectId = [self objectIdForObject:object];
+    NSDictionary *previousChange = objectId ? [self.pendingChangesById objectForKey:objectId] : nil;
+    if(previousChange)
+    {
+        [self.pendingChanges removeObjectIdenticalTo:previousChange];
+        [self.pendingChangesById removeObjectForKey:objectId];
+        
+        NSString *previousType = [previousChange valueForKey:kChangeTypeKey];
+        if([previousType isEqualToString:kChangeTypeInsert])
+        {
+            if([changeType isEqualToString:kChangeTypeDelete])
+                return;  // never seen by the sections
+            changeType = kChangeTypeInsert;
+        }
+        else if([previousType isEqualToString:kChangeTypeDelete] && [changeType isEqualToString:kChangeTypeInsert])
+        {
+            changeType = kChangeTypeUpdate;
+        }
+    }
+    
+    NSDictionary *change = [NSDictionary dictionaryWithObjectsAndKeys:changeType, kChangeTypeKey, object, kChangeObjectKey, nil];
+    [self.pendingChanges addObject:change];
+    if(objectId)
+        [self.pendingChangesById setObject:change forKey:objectId];
+    
+    if(!self.pendingChangesFlushScheduled)
+    {
+        self.pendingChangesFlushScheduled = TRUE;
+        [self performSelector:@selector(flushPendingChanges) withObject:nil afterDelay:0];
+    }
+}
+
+- (void)flushPendingChanges
+{
+    self.pendingChangesFlushScheduled = FALSE;
+    
+    if(!self.pendingChanges.count)
+        return;
+    
+    NSMutableArray *insertedObjects = [NSMutableArray array];
+    NSMutableArray *updatedObjects = [NSMutableArray array];
+    NSMutableArray *deletedObjects = [NSMutableArray array];
+    for(NSDictionary *change in self.pendingChanges)
+    {
+        NSString *changeType = [change valueForKey:kChangeTypeKey];
+        NSObject *object = [change valueForKey:kChangeObjectKey];
+        if([changeType isEqualToString:kChangeTypeInsert])
+            [insertedObjects addObject:object];
+        else if([changeType isEqualToString:kChangeTypeUpdate])
+            [updatedObjects addObject:object];
+        else
+            [deletedObjects addObject:object];
+    }
+    [self.pendingChanges removeAllObjects];
+    [self.pendingChangesById removeAllObjects];
+    
+    // objects received from the server are in sync
+    for(NSObject *object in insertedObjects)
+        [self clearDirtyPropertyNamesForObject:object];
+    for(NSObject *object in updatedObjects)
+        [self clearDirtyPropertyNamesForObject:object];
+    
+    NSDictionary *userInfo = [NSDictionary dictionaryWithObjectsAndKeys:insertedObjects, SCDataStoreInsertedObjectsKey, updatedObjects, SCDataStoreUpdatedObjectsKey, deletedObjects, SCDataStoreDeletedObjectsKey, nil];
+    [[NSNotificationCenter defaultCenter] postNotificationName:SCDataStoreDidChangeObjectsNotification object:self userInfo:userInfo];
+}
+
+
+
 #pragma mark - Networking helper methods
 
 - (NSMutableURLRequest *)requestWithURL:(NSURL *)url httpMethod:(NSString *)method parameters:(NSDictionary *)parameters objectData:(NSData *)data
@@ -639,12 +1469,41 @@
     for(NSString *key in parameters)
     {
         id value = [parameters valueForKey:key];
-        [queryComponents addObject:[NSString stringWithFormat:@"%@=%@", key, value]];
+        NSString *valueString = [NSString stringWithFormat:@"%@", value];
+        if([self isPercentEncodedParameterValue:value forKey:key])
+            [queryComponents addObject:[NSString stringWithFormat:@"%@=%@", key, valueString]];
+        else
+            [queryComponents addObject:[NSString stringWithFormat:@"%@=%@", [self percentEscapedQueryString:key], [self percentEscapedQueryString:valueString]]];
     }
     
    return [queryComponents componentsJoinedByString:@"&"];
 }
 
+- (BOOL)isPercentEncodedParameterValue:(id)value forKey:(NSString *)key
+{
+    SCWebServiceDefinition *definition = self.defaultWebServiceDefinition;
+    if(!definition.parametersArePercentEncoded)
+        return FALSE;
+    
+    // only values set by the user in the definition are pre-encoded, not the ones generated by the store
+    NSArray *userParameters = [NSArray arrayWithObjects:definition.fetchObjectsParameters, definition.insertObjectParameters, definition.updateObjectParameters, definition.deleteObjectParameters, nil];
+    for(NSDictionary *parameters in userParameters)
+    {
+        if([parameters valueForKey:key] == value)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+- (NSString *)percentEscapedQueryString:(NSString *)string
+{
+    // query values such as filter strings may contain reserved characters
+    NSMutableCharacterSet *allowedCharacters = [[NSCharacterSet URLQueryAllowedCharacterSet] mutableCopy];
+    [allowedCharacters removeCharactersInString:@"&=+?#"];
+    
+    return [string stringByAddingPercentEncodingWithAllowedCharacters:allowedCharacters];
+}
+
 - (NSString *)JSONStringUsingParameters:(NSDictionary *)parameters
 {
     NSError *error = nil;
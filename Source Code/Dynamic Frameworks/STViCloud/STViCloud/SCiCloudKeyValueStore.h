@@ -23,6 +23,13 @@
 
 #import <SensibleTableView/SCDataStore.h>
 
+
+@class SCiCloudKeyValueStore;
+
+typedef void(^SCiCloudKeyValueStoreWritesFlushedAction_Block)(NSSet *propertyNames, BOOL succeeded);
+typedef NSObject*(^SCiCloudKeyValueStoreResolveConflictAction_Block)(SCiCloudKeyValueStore *store, NSString *propertyName, NSObject *localValue, NSObject *iCloudValue);
+
+
 /****************************************************************************************/
 /*	class SCiCloudKeyValueStore	*/
 /****************************************************************************************/ 
@@ -31,6 +38,8 @@
  
  @note It is very rare when you'll need to create an SCiCloudKeyValueStore instance yourself, as it's typically automatically created for you when you use SCiCloudKeyValueDefinition. For example, when you use the SCTableViewModel method called [SCTableViewModel generateSectionsForiCloudKeyValueDefinition:], the model automatically sets its sections' dataStore property by calling your iCloudKeyValueDefinition's [SCDataDefinition generateCompatibleDataStore:] method.
  
+ When values are changed on another device, the store posts SCDataStoreDidChangeObjectsNotification with the names of the changed keys that have property definitions in its default definition. Sections bound to the store then reload only the cells bound to these keys (or, for keys holding arrays, insert, delete and move only the affected rows), without reloading the table.
+ 
  @note For more information on data stores, check out the SCDataStore base class documentation.
  */
 @interface SCiCloudKeyValueStore : SCDataStore
@@ -38,4 +47,62 @@
 /** The ubiquitous iCloud key-value store managed by the data store. */
 @property (nonatomic, readonly) NSUbiquitousKeyValueStore *defaultiCloudKeyValueObject;
 
+/** The time interval that must pass without any values being set through the store before the gathered values are synchronized with iCloud using a single synchronize call. Each value set restarts the interval, so a burst of rapid edits is only synchronized once it settles, which keeps the app from getting throttled by iCloud. Default: 0 (values are only synchronized when commitData is called).
+ @note Values are always readable from defaultiCloudKeyValueObject as soon as they're set. Only the synchronization is delayed.
+ */
+@property (nonatomic, readwrite) NSTimeInterval writeCoalescingInterval;
+
+/** Action gets called on the main thread each time the gathered values have been synchronized, with the names of the synchronized properties and the result of synchronize. Typically used to wait for writes in tests.
+ 
+ Example:
+ 
+    // Objective-C
+    myiCloudStore.writesFlushedAction = ^(NSSet *propertyNames, BOOL succeeded)
+    {
+        NSLog(@"Synchronized %@", propertyNames);
+    };
+ 
+    // Swift
+    myiCloudStore.writesFlushedAction =
+    {
+        (propertyNames, succeeded)->Void in
+ 
+        NSLog("Synchronized %@", propertyNames)
+    }
+ 
+ */
+@property (nonatomic, copy) SCiCloudKeyValueStoreWritesFlushedAction_Block writesFlushedAction;
+
+/** Action gets called when a value set through the store since the last change from the iCloud server has been replaced by a different iCloud value (e.g. when another device changed the same key, or when the value was written before the initial download from iCloud). The action returns the value to keep, which is written back to iCloud if it differs from iCloudValue. When not set, iCloud's value is kept.
+ 
+ Example:
+ 
+    // Objective-C
+    myiCloudStore.resolveConflictAction = ^NSObject*(SCiCloudKeyValueStore *store, NSString *propertyName, NSObject *localValue, NSObject *iCloudValue)
+    {
+        // keep the highest score
+        if([(NSNumber *)localValue compare:(NSNumber *)iCloudValue] == NSOrderedDescending)
+            return localValue;
+        return iCloudValue;
+    };
+ 
+    // Swift
+    myiCloudStore.resolveConflictAction =
+    {
+        (store, propertyName, localValue, iCloudValue)->NSObject! in
+ 
+        // keep the highest score
+        if (localValue as! NSNumber).compare(iCloudValue as! NSNumber) == .OrderedDescending
+        {
+            return localValue
+        }
+        return iCloudValue
+    }
+ 
+ */
+@property (nonatomic, copy) SCiCloudKeyValueStoreResolveConflictAction_Block resolveConflictAction;
+
+/** Synchronizes all the gathered values with iCloud in the background. Called by commitData, and automatically when the application enters the background (in which case the method waits for synchronize to return). */
+- (void)flushPendingWrites;
+
 @end
@@ -22,11 +22,60 @@
 
 
 #import "SCiCloudKeyValueStore.h"
+#import <SensibleTableView/SCKeyValueWriteBuffer.h>
+
+
+
+@interface SCiCloudKeyValueStore ()
+{
+    SCKeyValueWriteBuffer *_writeBuffer;
+    
+    NSMutableDictionary *_unconfirmedValues;
+}
+
+- (void)keyValueStoreDidChangeExternally:(NSNotification *)notification;
+
+@end
 
 
 
 @implementation SCiCloudKeyValueStore
 
+- (instancetype)init
+{
+    if( (self = [super init]) )
+    {
+        _writesFlushedAction = nil;
+        _resolveConflictAction = nil;
+        _unconfirmedValues = [[NSMutableDictionary alloc] init];
+        
+        NSUbiquitousKeyValueStore *keyValueStore = self.defaultiCloudKeyValueObject;
+        _writeBuffer = [SCKeyValueWriteBuffer bufferWithLabel:@"com.sensiblecocoa.SCiCloudKeyValueStore.write" synchronizeBlock:^BOOL
+        {
+            return [keyValueStore synchronize];
+        }];
+        __weak typeof(self) weak_self = self;
+        _writeBuffer.flushedAction = ^(NSSet *propertyNames, BOOL succeeded)
+        {
+            if(weak_self.writesFlushedAction)
+                weak_self.writesFlushedAction(propertyNames, succeeded);
+        };
+        
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(keyValueStoreDidChangeExternally:) name:NSUbiquitousKeyValueStoreDidChangeExternallyNotification object:keyValueStore];
+    }
+    return self;
+}
+
+- (NSTimeInterval)writeCoalescingInterval
+{
+    return _writeBuffer.debounceInterval;
+}
+
+- (void)setWriteCoalescingInterval:(NSTimeInterval)writeCoalescingInterval
+{
+    _writeBuffer.debounceInterval = writeCoalescingInterval;
+}
+
 - (NSUbiquitousKeyValueStore *)defaultiCloudKeyValueObject
 {
     if([[NSUbiquitousKeyValueStore class] respondsToSelector:@selector(defaultStore)])
@@ -55,10 +104,91 @@
     return objects;
 }
 
+// overrides superclass
+- (void)setValue:(NSObject *)value forPropertyName:(NSString *)propertyName inObject:(NSObject *)object
+{
+    [super setValue:value forPropertyName:propertyName inObject:object];
+    
+    if(!propertyName)
+        return;
+    
+    // kept until the next change from the server, to detect conflicting changes made on other devices
+    [_unconfirmedValues setObject:(value ? value : [NSNull null]) forKey:propertyName];
+    
+    [_writeBuffer addWriteForPropertyName:propertyName];
+}
+
+- (void)flushPendingWrites
+{
+    [_writeBuffer flush];
+}
+
+- (void)keyValueStoreDidChangeExternally:(NSNotification *)notification
+{
+    if(![NSThread isMainThread])
+    {
+        dispatch_async(dispatch_get_main_queue(), ^
+        {
+            [self keyValueStoreDidChangeExternally:notification];
+        });
+        return;
+    }
+    
+    NSInteger changeReason = [[notification.userInfo valueForKey:NSUbiquitousKeyValueStoreChangeReasonKey] integerValue];
+    if(changeReason == NSUbiquitousKeyValueStoreQuotaViolationChange)
+    {
+        SCDebugLog(@"Warning: SCiCloudKeyValueStore - iCloud key-value storage quota exceeded. Values will not be synchronized until some are removed.");
+        return;
+    }
+    
+    // only keys that have property definitions can be bound to cells
+    NSMutableSet *changedPropertyNames = [NSMutableSet set];
+    for(NSString *key in [notification.userInfo valueForKey:NSUbiquitousKeyValueStoreChangedKeysKey])
+    {
+        if([self.defaultDataDefinition propertyDefinitionWithName:key])
+            [changedPropertyNames addObject:key];
+    }
+    
+    NSDictionary *localValues = nil;
+    if(changeReason == NSUbiquitousKeyValueStoreServerChange || changeReason == NSUbiquitousKeyValueStoreInitialSyncChange)
+        localValues = [NSDictionary dictionaryWithDictionary:_unconfirmedValues];
+    // values of another account can't conflict with anything, while the unchanged keys' values are still waiting for their confirmation
+    if(changeReason == NSUbiquitousKeyValueStoreAccountChange)
+        [_unconfirmedValues removeAllObjects];
+    else
+        [_unconfirmedValues removeObjectsForKeys:[changedPropertyNames allObjects]];
+    
+    NSUbiquitousKeyValueStore *keyValueStore = self.defaultiCloudKeyValueObject;
+    for(NSString *propertyName in changedPropertyNames)
+    {
+        NSObject *localValue = [localValues objectForKey:propertyName];
+        if(!localValue)
+            continue;
+        if([localValue isKindOfClass:[NSNull class]])
+            localValue = nil;
+        
+        NSObject *iCloudValue = [keyValueStore objectForKey:propertyName];
+        if(localValue==iCloudValue || [localValue isEqual:iCloudValue])
+            continue;
+        
+        NSObject *resolvedValue = iCloudValue;
+        if(self.resolveConflictAction)
+            resolvedValue = self.resolveConflictAction(self, propertyName, localValue, iCloudValue);
+        if(resolvedValue!=iCloudValue && ![resolvedValue isEqual:iCloudValue])
+            [self setValue:resolvedValue forPropertyName:propertyName inObject:keyValueStore];
+    }
+    
+    if(!changedPropertyNames.count || !keyValueStore)
+        return;
+    
+    NSDictionary *userInfo = [NSDictionary dictionaryWithObjectsAndKeys:[NSArray array], SCDataStoreInsertedObjectsKey, [NSArray arrayWithObject:keyValueStore], SCDataStoreUpdatedObjectsKey, [NSArray array], SCDataStoreDeletedObjectsKey, changedPropertyNames, SCDataStoreUpdatedPropertyNamesKey, nil];
+    [[NSNotificationCenter defaultCenter] postNotificationName:SCDataStoreDidChangeObjectsNotification object:self userInfo:userInfo];
+}
+
 // overrides superclass
 - (void)commitData
 {
-    [self.defaultiCloudKeyValueObject synchronize];
+    [self flushPendingWrites];
 }
 
 
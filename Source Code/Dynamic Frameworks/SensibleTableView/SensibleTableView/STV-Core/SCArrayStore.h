@@ -49,6 +49,9 @@
 /** The objects array storage managed by the memory store. */
 @property (nonatomic, strong) NSMutableArray *objectsArray;
 
+/** The name of an optional integer property that the store keeps in sync with each object's position in objectsArray (e.g. to persist the order of objects saved elsewhere). Order values are assigned according to orderingStrategy. Default: nil. */
+@property (nonatomic, copy) NSString *orderPropertyName;
+
 @end
 
 
@@ -30,6 +30,17 @@
 #import <objc/runtime.h>
 
 
+@interface SCArrayStore ()
+{
+    BOOL _observesBoundObject;
+}
+
+- (void)boundObjectDidChange:(NSNotification *)notification;
+
+@end
+
+
+
 @implementation SCArrayStore
 
 
@@ -43,7 +54,7 @@
 {
 	if( (self = [super init]) )
 	{
-        // initialize here
+        _observesBoundObject = FALSE;
 	}
 	return self;
 }
@@ -70,6 +81,35 @@
     self.storedData = objectsArray;
 }
 
+// Updates the order property of the objects in the given objectsArray index range after they have changed position
+- (void)updateOrderPropertyForObjectAtIndex:(NSUInteger)index affectedRange:(NSRange)range
+{
+    if(!self.orderPropertyName)
+        return;
+    
+    if(self.orderingStrategy == SCOrderingStrategySparse)
+    {
+        NSObject *object = [self.objectsArray objectAtIndex:index];
+        if(![self assignSparseOrderToObject:object inOrderedObjects:self.objectsArray orderPropertyName:self.orderPropertyName])
+            [self rebalanceOrderOfObjects:self.objectsArray orderPropertyName:self.orderPropertyName];
+    }
+    else
+    {
+        for(NSUInteger i=range.location; i<NSMaxRange(range) && i<self.objectsArray.count; i++)
+            [self setValue:[NSNumber numberWithUnsignedInteger:i] forPropertyName:self.orderPropertyName inObject:[self.objectsArray objectAtIndex:i]];
+    }
+}
+
+// Closes the gap that removed objects leave in the order property of the objects that follow them in objectsArray, starting at the given index
+- (void)updateOrderPropertyAfterRemovingObjectsAtIndex:(NSUInteger)index
+{
+    // sparse order values stay in order when objects are removed
+    if(!self.orderPropertyName || self.orderingStrategy==SCOrderingStrategySparse || index>=self.objectsArray.count)
+        return;
+    
+    [self updateOrderPropertyForObjectAtIndex:index affectedRange:NSMakeRange(index, self.objectsArray.count-index)];
+}
+
 // overrides superclass
 - (void)setStoredData:(NSObject *)data
 {
@@ -85,6 +125,8 @@
         if(data)
             SCDebugLog(@"Warning: SCArrayStore expecting NSMutableArray but got %@ instead. (Data: %@)", NSStringFromClass([data class]) , data);
     }
+    
+    [self invalidateSharedFetchResults];
 }
 
 // overrides superclass
@@ -142,6 +184,10 @@
     
     [_uninsertedObjects removeObjectIdenticalTo:object];
     
+    [self updateOrderPropertyForObjectAtIndex:self.objectsArray.count-1 affectedRange:NSMakeRange(self.objectsArray.count-1, 1)];
+    
+    [self invalidateSharedFetchResults];
+    
     return TRUE;
 }
 
@@ -155,14 +201,49 @@
     //else
     [self.objectsArray removeObjectAtIndex:index];
     
+    [self updateOrderPropertyAfterRemovingObjectsAtIndex:index];
+    
+    [self invalidateSharedFetchResults];
+    
     return TRUE;
 }
 
+// overrides superclass
+- (BOOL)deleteObjects:(NSArray *)objects
+{
+    // an object passed more than once is still only deleted once
+    NSHashTable *uniqueObjects = [NSHashTable hashTableWithOptions:NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality];
+    for(NSObject *object in objects)
+        [uniqueObjects addObject:object];
+    
+    NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
+    for(NSObject *object in uniqueObjects)
+    {
+        NSUInteger index = [self.objectsArray indexOfObjectIdenticalTo:object];
+        if(index != NSNotFound)
+            [indexes addIndex:index];
+    }
+    
+    // a single compaction pass instead of shifting the array once per object
+    [self.objectsArray removeObjectsAtIndexes:indexes];
+    
+    if(indexes.count)
+        [self updateOrderPropertyAfterRemovingObjectsAtIndex:indexes.firstIndex];
+    
+    [self invalidateSharedFetchResults];
+    
+    return (indexes.count == uniqueObjects.count);
+}
+
 // overrides superclass
 - (BOOL)insertObject:(NSObject *)object atOrder:(NSUInteger)order
 {
     [self.objectsArray insertObject:object atIndex:order];
     
+    [self updateOrderPropertyForObjectAtIndex:order affectedRange:NSMakeRange(order, self.objectsArray.count-order)];
+    
+    [self invalidateSharedFetchResults];
+    
     return TRUE;
 }
 
@@ -183,6 +264,11 @@
     [self.objectsArray removeObjectAtIndex:index];
     [self.objectsArray insertObject:object atIndex:toOrder];
     
+    NSUInteger firstIndex = MIN(index, toOrder);
+    [self updateOrderPropertyForObjectAtIndex:toOrder affectedRange:NSMakeRange(firstIndex, MAX(index, toOrder)-firstIndex+1)];
+    
+    [self invalidateSharedFetchResults];
+    
     return TRUE;
 }
 
@@ -228,6 +314,56 @@
     return array;
 }
 
+// overrides superclass
+- (NSUInteger)countObjectsWithOptions:(SCDataFetchOptions *)fetchOptions
+{
+    if(_boundObject && _boundPropertyName)
+    {
+        id value = [self valueForPropertyName:_boundPropertyName inObject:_boundObject];
+        if([value isKindOfClass:[NSMutableArray class]])
+            self.objectsArray = value;
+    }
+    
+    if(!fetchOptions.filterPredicate)
+        return self.objectsArray.count;
+    
+    NSMutableArray *array = [NSMutableArray arrayWithArray:self.objectsArray];
+    [fetchOptions filterMutableArray:array];
+    
+    return array.count;
+}
+
+// overrides superclass
+- (NSArray *)fetchGroupsForPropertyName:(NSString *)propertyName withOptions:(SCDataFetchOptions *)fetchOptions
+{
+    if(_boundObject && _boundPropertyName)
+    {
+        id value = [self valueForPropertyName:_boundPropertyName inObject:_boundObject];
+        if([value isKindOfClass:[NSMutableArray class]])
+            self.objectsArray = value;
+    }
+    
+    if(!fetchOptions.filterPredicate)
+        return [self groupsForObjects:self.objectsArray propertyName:propertyName];
+    
+    // the groups only need the matching objects, not the sorted copy of objectsArray made by fetchObjectsWithOptions:
+    NSIndexSet *indexes = nil;
+    @try
+    {
+        indexes = [self.objectsArray indexesOfObjectsPassingTest:^BOOL(id obj, NSUInteger idx, BOOL *stop)
+                   {
+                       return [fetchOptions.filterPredicate evaluateWithObject:obj];
+                   }];
+    }
+    @catch (NSException * e)
+    {
+        SCDebugLog(@"Warning: Invalid filter predicate: %@.", fetchOptions.filterPredicate);
+        indexes = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, self.objectsArray.count)];
+    }
+    
+    return [self groupsForObjects:[self.objectsArray objectsAtIndexes:indexes] propertyName:propertyName];
+}
+
 // overrides superclass
 - (void)setValue:(NSObject *)value forPropertyName:(NSString *)propertyName inObject:(NSObject *)object
 {
@@ -238,6 +374,7 @@
         if(index != NSNotFound)
         {
             [self.objectsArray replaceObjectAtIndex:index withObject:value];
+            [self invalidateSharedFetchResults];
         }
     }
     else 
@@ -276,6 +413,51 @@
     
     if([value isKindOfClass:[NSMutableArray class]])
         self.objectsArray = value;
+    
+    // the bound object's store posts the changes made to the array outside the app (e.g. by SCiCloudKeyValueStore)
+    if(_observesBoundObject)
+    {
+        _observesBoundObject = FALSE;
+        [[NSNotificationCenter defaultCenter] removeObserver:self name:SCDataStoreDidChangeObjectsNotification object:nil];
+    }
+    if(self.boundObjectStore && self.boundObjectStore!=self)
+    {
+        _observesBoundObject = TRUE;
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(boundObjectDidChange:) name:SCDataStoreDidChangeObjectsNotification object:self.boundObjectStore];
+    }
+}
+
+- (void)boundObjectDidChange:(NSNotification *)notification
+{
+    if(!_boundObject || !_boundPropertyName)
+        return;
+    
+    NSArray *updatedObjects = [notification.userInfo valueForKey:SCDataStoreUpdatedObjectsKey];
+    if([updatedObjects indexOfObjectIdenticalTo:_boundObject] == NSNotFound)
+        return;
+    NSSet *propertyNames = [notification.userInfo valueForKey:SCDataStoreUpdatedPropertyNamesKey];
+    if(propertyNames && ![propertyNames containsObject:_boundPropertyName])
+        return;
+    
+    id value = [self valueForPropertyName:_boundPropertyName inObject:_boundObject];
+    if(value == self.objectsArray)
+        return;  // already bound to the changed array
+    NSArray *objects = [value isKindOfClass:[NSArray class]] ? value : [NSArray array];
+    
+    // sections update only the rows of the inserted, deleted and moved objects, so the array must hold the new objects before they are notified
+    __weak typeof(self) weak_self = self;
+    [self postChangesFromObjects:[NSArray arrayWithArray:self.objectsArray] toObjects:objects fetchOptions:nil beforePosting:^(NSArray *mergedObjects)
+    {
+        if(weak_self.objectsArray)
+        {
+            [weak_self.objectsArray setArray:mergedObjects];
+            [weak_self invalidateSharedFetchResults];
+        }
+        else
+        {
+            weak_self.objectsArray = [NSMutableArray arrayWithArray:mergedObjects];
+        }
+    }];
 }
 
 @end
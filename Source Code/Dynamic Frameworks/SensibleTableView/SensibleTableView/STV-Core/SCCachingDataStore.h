@@ -0,0 +1,96 @@
+/*
+ *  SCCachingDataStore.h
+ *  Sensible TableView
+ *  Version: 5.4.0
+ *
+ *
+ *	THIS SOURCE CODE AND ANY ACCOMPANYING DOCUMENTATION ARE PROTECTED BY UNITED STATES
+ *	INTELLECTUAL PROPERTY LAW AND INTERNATIONAL TREATIES. UNAUTHORIZED REPRODUCTION OR
+ *	DISTRIBUTION IS SUBJECT TO CIVIL AND CRIMINAL PENALTIES. YOU SHALL NOT DEVELOP NOR
+ *	MAKE AVAILABLE ANY WORK THAT COMPETES WITH A SENSIBLE COCOA PRODUCT DERIVED FROM THIS
+ *	SOURCE CODE. THIS SOURCE CODE MAY NOT BE RESOLD OR REDISTRIBUTED ON A STAND ALONE BASIS.
+ *
+ *	USAGE OF THIS SOURCE CODE IS BOUND BY THE LICENSE AGREEMENT PROVIDED WITH THE
+ *	DOWNLOADED PRODUCT.
+ *
+ *  Copyright 2011-2015 Sensible Cocoa. All rights reserved.
+ *
+ *
+ *	This notice may not be removed from this file.
+ *
+ */
+
+#import "SCDataStore.h"
+
+
+/****************************************************************************************/
+/*	class SCCachingDataStore	*/
+/****************************************************************************************/
+/**
+ SCCachingDataStore is an SCDataStore subclass that wraps any other data store, answering its asynchronous fetches from a memory and on-disk cache while the wrapped store is asked for fresh results.
+
+ When cached results exist for a fetch, asynchronousFetchObjectsWithOptions:success:failure:noConnection: immediately calls its success block with them, then fetches the same objects from the wrapped store in the background. Any differences between the two results are then delivered using SCDataStoreDidChangeObjectsNotification, which sections bound to the store use to update only the affected rows. All other data access is simply forwarded to the wrapped store.
+
+ Sample use:
+    SCWebServiceStore *webStore = [SCWebServiceStore storeWithDefaultWebServiceDefinition:tweetsDef];
+    SCCachingDataStore *cachingStore = [SCCachingDataStore storeWithDataStore:webStore];
+    SCArrayOfObjectsSection *tweetsSection = [SCArrayOfObjectsSection sectionWithHeaderTitle:nil dataStore:cachingStore];
+
+ @note Results are only cached on disk if all their objects conform to NSCoding (e.g. the dictionaries fetched by SCWebServiceStore). Other results (e.g. Parse objects) are only cached in memory.
+ @note Fetches from a store bound to an object's property (see bindStoreToPropertyName:forObject:withDefinition:) are never cached.
+ */
+@interface SCCachingDataStore : SCDataStore
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Creation and Initialization
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** Allocates and returns an initialized SCCachingDataStore that caches the results of the given data store. */
++ (instancetype)storeWithDataStore:(SCDataStore *)store;
+
+/** Returns an initialized SCCachingDataStore that caches the results of the given data store. */
+- (instancetype)initWithDataStore:(SCDataStore *)store;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Configuration
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** The wrapped data store that the objects are actually fetched from and written to. */
+@property (nonatomic, strong, readonly) SCDataStore *dataStore;
+
+/** The number of seconds cached results are used for after they have been fetched. Older results are discarded and the fetch waits for the wrapped store instead. Default: 3600. */
+@property (nonatomic, readwrite) NSTimeInterval cacheTimeToLive;
+
+/** The maximum number of fetch results kept in memory. Default: 20. */
+@property (nonatomic, readwrite) NSUInteger memoryCacheCountLimit;
+
+/** The maximum number of bytes the cached results can occupy on disk, with the least recently written results removed first. Set to zero to disable the disk cache. Default: 5MB. */
+@property (nonatomic, readwrite) NSUInteger diskCacheSizeLimit;
+
+/** The name of the directory (in the app's caches directory) that results are cached to on disk. Stores with the same cacheIdentifier share their disk cache. Default: the name of the wrapped store's class followed by the name of its default data definition. */
+@property (nonatomic, copy) NSString *cacheIdentifier;
+
+/** When TRUE, objects inserted, updated or deleted through the store are also applied to the cached results, otherwise all cached results are discarded on every change. Default: TRUE.
+ @note Inserted objects are only added to cached results that were not fetched in batches, and that match the objects using their fetch options' filter predicate.
+ */
+@property (nonatomic, readwrite) BOOL writesThrough;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Managing the Cache
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** Discards all the results cached in memory and on disk. */
+- (void)removeAllCachedResults;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Internal Properties & Methods (should only be used by the framework or when subclassing)
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** Returns the key that the results of the given fetch options are cached under. The default key is made of cacheIdentifier and the sort, filter and batch settings of fetchOptions.
+ @note Override this method in a subclass to add any other state that determines the wrapped store's results (e.g. a web service's fetch parameters). */
+- (NSString *)cacheKeyForFetchOptions:(SCDataFetchOptions *)fetchOptions;
+
+@end
@@ -0,0 +1,941 @@
+/*
+ *  SCCachingDataStore.m
+ *  Sensible TableView
+ *  Version: 5.4.0
+ *
+ *
+ *	THIS SOURCE CODE AND ANY ACCOMPANYING DOCUMENTATION ARE PROTECTED BY UNITED STATES
+ *	INTELLECTUAL PROPERTY LAW AND INTERNATIONAL TREATIES. UNAUTHORIZED REPRODUCTION OR
+ *	DISTRIBUTION IS SUBJECT TO CIVIL AND CRIMINAL PENALTIES. YOU SHALL NOT DEVELOP NOR
+ *	MAKE AVAILABLE ANY WORK THAT COMPETES WITH A SENSIBLE COCOA PRODUCT DERIVED FROM THIS
+ *	SOURCE CODE. THIS SOURCE CODE MAY NOT BE RESOLD OR REDISTRIBUTED ON A STAND ALONE BASIS.
+ *
+ *	USAGE OF THIS SOURCE CODE IS BOUND BY THE LICENSE AGREEMENT PROVIDED WITH THE
+ *	DOWNLOADED PRODUCT.
+ *
+ *  Copyright 2011-2015 Sensible Cocoa. All rights reserved.
+ *
+ *
+ *	This notice may not be removed from this file.
+ *
+ */
+
+#import "SCCachingDataStore.h"
+
+
+
+/****************************************************************************************/
+/*	class SCFetchResultCacheEntry (internal)	*/
+/****************************************************************************************/
+
+// The cached results of a single fetch, along with what's needed to apply later changes to them
+@interface SCFetchResultCacheEntry : NSObject <NSCoding>
+
+@property (nonatomic, copy) NSString *key;
+@property (nonatomic, strong) NSMutableArray *objects;
+@property (nonatomic, strong) NSDate *fetchDate;
+@property (nonatomic, strong) NSPredicate *filterPredicate;
+@property (nonatomic, strong) NSArray *sortDescriptors;
+@property (nonatomic, readwrite) BOOL batched;
+
+@end
+
+
+@implementation SCFetchResultCacheEntry
+
+- (instancetype)init
+{
+    if( (self=[super init]) )
+    {
+        _key = nil;
+        _objects = [NSMutableArray array];
+        _fetchDate = [NSDate date];
+        _filterPredicate = nil;
+        _sortDescriptors = nil;
+        _batched = FALSE;
+    }
+    return self;
+}
+
+- (instancetype)initWithCoder:(NSCoder *)coder
+{
+    if( (self=[self init]) )
+    {
+        _key = [coder decodeObjectForKey:@"key"];
+        _objects = [NSMutableArray arrayWithArray:[coder decodeObjectForKey:@"objects"]];
+        _fetchDate = [coder decodeObjectForKey:@"fetchDate"];
+        _filterPredicate = [coder decodeObjectForKey:@"filterPredicate"];
+        _sortDescriptors = [coder decodeObjectForKey:@"sortDescriptors"];
+        _batched = [coder decodeBoolForKey:@"batched"];
+    }
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder
+{
+    [coder encodeObject:self.key forKey:@"key"];
+    [coder encodeObject:self.objects forKey:@"objects"];
+    [coder encodeObject:self.fetchDate forKey:@"fetchDate"];
+    [coder encodeObject:self.filterPredicate forKey:@"filterPredicate"];
+    [coder encodeObject:self.sortDescriptors forKey:@"sortDescriptors"];
+    [coder encodeBool:self.batched forKey:@"batched"];
+}
+
+@end
+
+
+
+
+
+
+
+@interface SCCachingDataStore ()
+{
+    NSMutableDictionary *_memoryEntries;
+    NSMutableArray *_memoryEntryKeys;  // least recently used first
+    dispatch_queue_t _diskQueue;
+}
+
+- (SCFetchResultCacheEntry *)cachedEntryForKey:(NSString *)key;
+- (void)cacheObjects:(NSArray *)objects forEntry:(SCFetchResultCacheEntry *)entry;
+- (void)removeCachedEntryForKey:(NSString *)key;
+- (void)didRevalidateObjects:(NSArray *)cachedObjects withObjects:(NSArray *)objects entry:(SCFetchResultCacheEntry *)entry fetchOptions:(SCDataFetchOptions *)fetchOptions batchStartIndex:(NSUInteger)batchStartIndex;
+
+- (void)cachedObjectsDidChangeWithInsertedObjects:(NSArray *)insertedObjects updatedObjects:(NSArray *)updatedObjects deletedObjects:(NSArray *)deletedObjects;
+- (NSUInteger)indexOfObject:(NSObject *)object inCachedObjects:(NSArray *)cachedObjects;
+
+- (NSURL *)diskCacheDirectoryURL;
+- (NSURL *)diskCacheFileURLForKey:(NSString *)key;
+- (void)writeEntryToDisk:(SCFetchResultCacheEntry *)entry;
+- (void)trimDiskCacheToSize:(NSUInteger)sizeLimit;
+
+- (void)dataStoreDidChangeObjects:(NSNotification *)notification;
+- (void)dataStoreDidFailCommit:(NSNotification *)notification;
+- (void)didReceiveMemoryWarning;
+
+@end
+
+
+
+@implementation SCCachingDataStore
+
++ (instancetype)storeWithDataStore:(SCDataStore *)store
+{
+    return [[[self class] alloc] initWithDataStore:store];
+}
+
+- (instancetype)init
+{
+    if( (self = [super init]) )
+    {
+        _dataStore = nil;
+        _cacheTimeToLive = 3600;
+        _memoryCacheCountLimit = 20;
+        _diskCacheSizeLimit = 5*1024*1024;
+        _cacheIdentifier = nil;
+        _writesThrough = TRUE;
+        
+        _memoryEntries = [[NSMutableDictionary alloc] init];
+        _memoryEntryKeys = [[NSMutableArray alloc] init];
+        _diskQueue = dispatch_queue_create("com.sensiblecocoa.SCCachingDataStore.disk", DISPATCH_QUEUE_SERIAL);
+        
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(didReceiveMemoryWarning) name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+    }
+    return self;
+}
+
+- (instancetype)initWithDataStore:(SCDataStore *)store
+{
+    if( (self = [self initWithDefaultDataDefinition:store.defaultDataDefinition]) )
+    {
+        _dataStore = store;
+        
+        // forward the wrapped store's change notifications to the sections bound to this store
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(dataStoreDidChangeObjects:) name:SCDataStoreDidChangeObjectsNotification object:store];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(dataStoreDidFailCommit:) name:SCDataStoreDidFailCommitNotification object:store];
+    }
+    return self;
+}
+
+- (NSString *)cacheIdentifier
+{
+    if(!_cacheIdentifier)
+        return [NSString stringWithFormat:@"%@-%@", NSStringFromClass([self.dataStore class]), self.defaultDataDefinition.dataStructureName];
+    
+    return _cacheIdentifier;
+}
+
+- (void)setMemoryCacheCountLimit:(NSUInteger)limit
+{
+    _memoryCacheCountLimit = limit;
+    
+    while(_memoryEntryKeys.count > limit)
+    {
+        [_memoryEntries removeObjectForKey:[_memoryEntryKeys objectAtIndex:0]];
+        [_memoryEntryKeys removeObjectAtIndex:0];
+    }
+}
+
+- (void)removeAllCachedResults
+{
+    [_memoryEntries removeAllObjects];
+    [_memoryEntryKeys removeAllObjects];
+    
+    NSURL *directoryURL = [self diskCacheDirectoryURL];
+    dispatch_async(_diskQueue, ^
+    {
+        [[NSFileManager defaultManager] removeItemAtURL:directoryURL error:NULL];
+    });
+}
+
+- (void)didReceiveMemoryWarning
+{
+    // the disk cache still has the results that can be archived
+    [_memoryEntries removeAllObjects];
+    [_memoryEntryKeys removeAllObjects];
+}
+
+- (NSString *)cacheKeyForFetchOptions:(SCDataFetchOptions *)fetchOptions
+{
+    NSPredicate *filterPredicate = nil;
+    if(fetchOptions.filter)
+        filterPredicate = fetchOptions.filterPredicate;
+    NSString *sortKey = nil;
+    if(fetchOptions.sort)
+        sortKey = fetchOptions.sortKey;
+    
+    return [NSString stringWithFormat:@"%@|sort:%@,%i|filter:%@|batch:%lu,%lu", self.cacheIdentifier, sortKey, fetchOptions.sortAscending, filterPredicate.predicateFormat, (unsigned long)fetchOptions.batchSize, (unsigned long)(fetchOptions.batchSize ? fetchOptions.nextBatchStartIndex : 0)];
+}
+
+
+#pragma mark - Memory and disk cache
+
+- (SCFetchResultCacheEntry *)cachedEntryForKey:(NSString *)key
+{
+    SCFetchResultCacheEntry *entry = [_memoryEntries objectForKey:key];
+    if(!entry && self.diskCacheSizeLimit)
+    {
+        NSURL *fileURL = [self diskCacheFileURLForKey:key];
+        __block NSData *data = nil;
+        dispatch_sync(_diskQueue, ^
+        {
+            data = [NSData dataWithContentsOfURL:fileURL];
+        });
+        
+        if(data)
+        {
+            @try
+            {
+                entry = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+            }
+            @catch (NSException * e)
+            {
+                entry = nil;
+            }
+            // file names are hashes of the keys
+            if(![entry isKindOfClass:[SCFetchResultCacheEntry class]] || ![entry.key isEqualToString:key])
+                entry = nil;
+        }
+    }
+    
+    if(!entry)
+        return nil;
+    
+    if(-[entry.fetchDate timeIntervalSinceNow] > self.cacheTimeToLive)
+    {
+        [self removeCachedEntryForKey:key];
+        return nil;
+    }
+    
+    // mark as most recently used
+    [_memoryEntryKeys removeObject:key];
+    [_memoryEntryKeys addObject:key];
+    [_memoryEntries setObject:entry forKey:key];
+    [self setMemoryCacheCountLimit:self.memoryCacheCountLimit];
+    
+    return entry;
+}
+
+- (void)cacheObjects:(NSArray *)objects forEntry:(SCFetchResultCacheEntry *)entry
+{
+    if(!entry.key || !objects)
+        return;
+    
+    entry.objects = [NSMutableArray arrayWithArray:objects];
+    entry.fetchDate = [NSDate date];
+    
+    [_memoryEntryKeys removeObject:entry.key];
+    [_memoryEntryKeys addObject:entry.key];
+    [_memoryEntries setObject:entry forKey:entry.key];
+    [self setMemoryCacheCountLimit:self.memoryCacheCountLimit];
+    
+    [self writeEntryToDisk:entry];
+}
+
+- (void)removeCachedEntryForKey:(NSString *)key
+{
+    [_memoryEntries removeObjectForKey:key];
+    [_memoryEntryKeys removeObject:key];
+    
+    NSURL *fileURL = [self diskCacheFileURLForKey:key];
+    dispatch_async(_diskQueue, ^
+    {
+        [[NSFileManager defaultManager] removeItemAtURL:fileURL error:NULL];
+    });
+}
+
+- (NSURL *)diskCacheDirectoryURL
+{
+    NSURL *cachesURL = [[[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask] lastObject];
+    NSString *directoryName = [self.cacheIdentifier stringByReplacingOccurrencesOfString:@"/" withString:@"_"];
+    
+    return [[cachesURL URLByAppendingPathComponent:@"SCCachingDataStore" isDirectory:YES] URLByAppendingPathComponent:directoryName isDirectory:YES];
+}
+
+- (NSURL *)diskCacheFileURLForKey:(NSString *)key
+{
+    // FNV-1a, which unlike -[NSString hash] is guaranteed to be stable across launches
+    uint64_t hash = 14695981039346656037ULL;
+    for(const char *bytes = [key UTF8String]; *bytes; bytes++)
+    {
+        hash ^= (uint8_t)*bytes;
+        hash *= 1099511628211ULL;
+    }
+    
+    return [[self diskCacheDirectoryURL] URLByAppendingPathComponent:[NSString stringWithFormat:@"%016llx", hash]];
+}
+
+- (void)writeEntryToDisk:(SCFetchResultCacheEntry *)entry
+{
+    NSUInteger sizeLimit = self.diskCacheSizeLimit;
+    if(!sizeLimit)
+        return;
+    
+    // archive a snapshot in the background, since the entry's objects array keeps changing on the main thread
+    SCFetchResultCacheEntry *snapshot = [[SCFetchResultCacheEntry alloc] init];
+    snapshot.key = entry.key;
+    snapshot.objects = [NSMutableArray arrayWithArray:entry.objects];
+    snapshot.fetchDate = entry.fetchDate;
+    snapshot.filterPredicate = entry.filterPredicate;
+    snapshot.sortDescriptors = entry.sortDescriptors;
+    snapshot.batched = entry.batched;
+    
+    NSString *cacheIdentifier = self.cacheIdentifier;
+    NSURL *fileURL = [self diskCacheFileURLForKey:entry.key];
+    NSURL *directoryURL = [self diskCacheDirectoryURL];
+    __weak typeof(self) weak_self = self;
+    dispatch_async(_diskQueue, ^
+    {
+        NSData *data = nil;
+        @try
+        {
+            data = [NSKeyedArchiver archivedDataWithRootObject:snapshot];
+        }
+        @catch (NSException * e)
+        {
+            SCDebugLog(@"Warning: Results of '%@' not cached on disk since they don't conform to NSCoding.", cacheIdentifier);
+        }
+        
+        if(!data || data.length > sizeLimit)
+        {
+            [[NSFileManager defaultManager] removeItemAtURL:fileURL error:NULL];
+            return;
+        }
+        
+        [[NSFileManager defaultManager] createDirectoryAtURL:directoryURL withIntermediateDirectories:YES attributes:nil error:NULL];
+        if(![data writeToURL:fileURL atomically:YES])
+        {
+            SCDebugLog(@"Warning: Unable to write cached results to %@.", fileURL);
+            return;
+        }
+        
+        [weak_self trimDiskCacheToSize:sizeLimit];
+    });
+}
+
+// Called on _diskQueue
+- (void)trimDiskCacheToSize:(NSUInteger)sizeLimit
+{
+    NSArray *resourceKeys = [NSArray arrayWithObjects:NSURLFileSizeKey, NSURLContentModificationDateKey, nil];
+    NSArray *fileURLs = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:[self diskCacheDirectoryURL] includingPropertiesForKeys:resourceKeys options:NSDirectoryEnumerationSkipsHiddenFiles error:NULL];
+    
+    unsigned long long totalSize = 0;
+    NSMutableArray *files = [NSMutableArray arrayWithCapacity:fileURLs.count];
+    for(NSURL *fileURL in fileURLs)
+    {
+        NSDictionary *resourceValues = [fileURL resourceValuesForKeys:resourceKeys error:NULL];
+        NSNumber *fileSize = [resourceValues objectForKey:NSURLFileSizeKey];
+        NSDate *modificationDate = [resourceValues objectForKey:NSURLContentModificationDateKey];
+        if(!fileSize || !modificationDate)
+            continue;
+        
+        totalSize += [fileSize unsignedLongLongValue];
+        [files addObject:[NSDictionary dictionaryWithObjectsAndKeys:fileURL, @"url", fileSize, NSURLFileSizeKey, modificationDate, NSURLContentModificationDateKey, nil]];
+    }
+    if(totalSize <= sizeLimit)
+        return;
+    
+    // least recently written first
+    [files sortUsingDescriptors:[NSArray arrayWithObject:[NSSortDescriptor sortDescriptorWithKey:NSURLContentModificationDateKey ascending:YES]]];
+    for(NSDictionary *file in files)
+    {
+        if(totalSize <= sizeLimit)
+            break;
+        
+        if([[NSFileManager defaultManager] removeItemAtURL:[file objectForKey:@"url"] error:NULL])
+            totalSize -= [[file objectForKey:NSURLFileSizeKey] unsignedLongLongValue];
+    }
+}
+
+
+#pragma mark - Change tracking
+
+// Returns the index of the cached object that represents the same object, matching by object id when the wrapped store has ids
+- (NSUInteger)indexOfObject:(NSObject *)object inCachedObjects:(NSArray *)cachedObjects
+{
+    id objectId = [self.dataStore objectIdForObject:object];
+    if(!objectId)
+        return [cachedObjects indexOfObjectIdenticalTo:object];
+    
+    return [cachedObjects indexOfObjectPassingTest:^BOOL(id obj, NSUInteger idx, BOOL *stop)
+            {
+                return (obj == object) || [objectId isEqual:[self.dataStore objectIdForObject:obj]];
+            }];
+}
+
+- (void)cachedObjectsDidChangeWithInsertedObjects:(NSArray *)insertedObjects updatedObjects:(NSArray *)updatedObjects deletedObjects:(NSArray *)deletedObjects
+{
+    if(!insertedObjects.count && !updatedObjects.count && !deletedObjects.count)
+        return;
+    
+    if(!self.writesThrough)
+    {
+        [self removeAllCachedResults];
+        return;
+    }
+    
+    // results that are only cached on disk can't be cheaply updated, so these are discarded
+    NSURL *directoryURL = [self diskCacheDirectoryURL];
+    NSMutableSet *memoryFileURLs = [NSMutableSet setWithCapacity:_memoryEntryKeys.count];
+    for(NSString *key in _memoryEntryKeys)
+        [memoryFileURLs addObject:[[self diskCacheFileURLForKey:key] lastPathComponent]];
+    dispatch_async(_diskQueue, ^
+    {
+        NSArray *fileURLs = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:directoryURL includingPropertiesForKeys:nil options:NSDirectoryEnumerationSkipsHiddenFiles error:NULL];
+        for(NSURL *fileURL in fileURLs)
+        {
+            if(![memoryFileURLs containsObject:[fileURL lastPathComponent]])
+                [[NSFileManager defaultManager] removeItemAtURL:fileURL error:NULL];
+        }
+    });
+    
+    for(SCFetchResultCacheEntry *entry in [_memoryEntries allValues])
+    {
+        BOOL changed = FALSE;
+        
+        for(NSObject *object in deletedObjects)
+        {
+            NSUInteger index = [self indexOfObject:object inCachedObjects:entry.objects];
+            if(index != NSNotFound)
+            {
+                [entry.objects removeObjectAtIndex:index];
+                changed = TRUE;
+            }
+        }
+        
+        NSMutableArray *matchingObjects = [NSMutableArray arrayWithArray:insertedObjects];
+        [matchingObjects addObjectsFromArray:updatedObjects];
+        for(NSObject *object in matchingObjects)
+        {
+            BOOL matches = TRUE;
+            if(entry.filterPredicate)
+            {
+                @try
+                {
+                    matches = [entry.filterPredicate evaluateWithObject:object];
+                }
+                @catch (NSException * e)
+                {
+                    matches = FALSE;
+                }
+            }
+            
+            NSUInteger index = [self indexOfObject:object inCachedObjects:entry.objects];
+            if(index != NSNotFound)
+            {
+                if(matches)
+                    [entry.objects replaceObjectAtIndex:index withObject:object];
+                else
+                    [entry.objects removeObjectAtIndex:index];
+                changed = TRUE;
+            }
+            else
+                if(matches && !entry.batched)
+                {
+                    // batched results can't tell which batch the object belongs to
+                    [entry.objects addObject:object];
+                    changed = TRUE;
+                }
+        }
+        
+        if(!changed)
+            continue;
+        
+        if(entry.sortDescriptors.count)
+        {
+            @try
+            {
+                [entry.objects sortUsingDescriptors:entry.sortDescriptors];
+            }
+            @catch (NSException * e)
+            {
+                SCDebugLog(@"Warning: Invalid sort descriptors: %@.", entry.sortDescriptors);
+            }
+        }
+        [self writeEntryToDisk:entry];
+    }
+}
+
+- (void)didRevalidateObjects:(NSArray *)cachedObjects withObjects:(NSArray *)objects entry:(SCFetchResultCacheEntry *)entry fetchOptions:(SCDataFetchOptions *)fetchOptions batchStartIndex:(NSUInteger)batchStartIndex
+{
+    // a changed batch can't be diffed against the other results, so it's delivered again at its position instead
+    NSArray *mergedObjects;
+    if(fetchOptions.batchSize)
+        mergedObjects = [self postChangesFromBatchObjects:cachedObjects toObjects:objects batchStartIndex:batchStartIndex fetchOptions:fetchOptions];
+    else
+        mergedObjects = [self postChangesFromObjects:cachedObjects toObjects:objects fetchOptions:fetchOptions];
+    
+    [self cacheObjects:mergedObjects forEntry:entry];
+}
+
+- (void)dataStoreDidChangeObjects:(NSNotification *)notification
+{
+    [self cachedObjectsDidChangeWithInsertedObjects:[notification.userInfo valueForKey:SCDataStoreInsertedObjectsKey] updatedObjects:[notification.userInfo valueForKey:SCDataStoreUpdatedObjectsKey] deletedObjects:[notification.userInfo valueForKey:SCDataStoreDeletedObjectsKey]];
+    
+    [[NSNotificationCenter defaultCenter] postNotificationName:SCDataStoreDidChangeObjectsNotification object:self userInfo:notification.userInfo];
+}
+
+- (void)dataStoreDidFailCommit:(NSNotification *)notification
+{
+    [[NSNotificationCenter defaultCenter] postNotificationName:SCDataStoreDidFailCommitNotification object:self userInfo:notification.userInfo];
+}
+
+
+#pragma mark - SCDataStore forwarding
+
+// overrides superclass
+- (SCStoreMode)storeMode
+{
+    return self.dataStore.storeMode;
+}
+
+// overrides superclass
+- (void)setStoreMode:(SCStoreMode)storeMode
+{
+    self.dataStore.storeMode = storeMode;
+}
+
+// overrides superclass
+- (void)addDataDefinition:(SCDataDefinition *)definition
+{
+    [super addDataDefinition:definition];
+    
+    [self.dataStore addDataDefinition:definition];
+}
+
+// overrides superclass
+- (SCDataDefinition *)definitionForObject:(NSObject *)object
+{
+    return [self.dataStore definitionForObject:object];
+}
+
+// overrides superclass
+- (NSObject *)createNewObjectWithDefinition:(SCDataDefinition *)definition
+{
+    return [self.dataStore createNewObjectWithDefinition:definition];
+}
+
+// overrides superclass
+- (BOOL)discardUninsertedObject:(NSObject *)object
+{
+    return [self.dataStore discardUninsertedObject:object];
+}
+
+// overrides superclass
+- (BOOL)insertObject:(NSObject *)object
+{
+    BOOL success = [self.dataStore insertObject:object];
+    if(success)
+        [self cachedObjectsDidChangeWithInsertedObjects:[NSArray arrayWithObject:object] updatedObjects:nil deletedObjects:nil];
+    
+    return success;
+}
+
+// overrides superclass
+- (BOOL)insertObject:(NSObject *)object atOrder:(NSUInteger)order
+{
+    BOOL success = [self.dataStore insertObject:object atOrder:order];
+    if(success)
+        [self cachedObjectsDidChangeWithInsertedObjects:[NSArray arrayWithObject:object] updatedObjects:nil deletedObjects:nil];
+    
+    return success;
+}
+
+// overrides superclass
+- (BOOL)changeOrderForObject:(NSObject *)object toOrder:(NSUInteger)toOrder subsetArray:(NSArray *)subsetArray
+{
+    BOOL success = [self.dataStore changeOrderForObject:object toOrder:toOrder subsetArray:subsetArray];
+    if(success)
+        [self removeAllCachedResults];  // the new order can't be derived from the cached results
+    
+    return success;
+}
+
+// overrides superclass
+- (BOOL)updateObject:(NSObject *)object
+{
+    BOOL success = [self.dataStore updateObject:object];
+    if(success)
+        [self cachedObjectsDidChangeWithInsertedObjects:nil updatedObjects:[NSArray arrayWithObject:object] deletedObjects:nil];
+    
+    return success;
+}
+
+// overrides superclass
+- (BOOL)deleteObject:(NSObject *)object
+{
+    BOOL success = [self.dataStore deleteObject:object];
+    if(success)
+        [self cachedObjectsDidChangeWithInsertedObjects:nil updatedObjects:nil deletedObjects:[NSArray arrayWithObject:object]];
+    
+    return success;
+}
+
+// overrides superclass
+- (BOOL)updateObjects:(NSArray *)objects withPropertyValues:(NSDictionary *)propertyValues
+{
+    BOOL success = [self.dataStore updateObjects:objects withPropertyValues:propertyValues];
+    [self cachedObjectsDidChangeWithInsertedObjects:nil updatedObjects:objects deletedObjects:nil];
+    
+    return success;
+}
+
+// overrides superclass
+- (BOOL)deleteObjects:(NSArray *)objects
+{
+    BOOL success = [self.dataStore deleteObjects:objects];
+    [self cachedObjectsDidChangeWithInsertedObjects:nil updatedObjects:nil deletedObjects:objects];
+    
+    return success;
+}
+
+// overrides superclass
+- (NSArray *)fetchObjectsWithOptions:(SCDataFetchOptions *)fetchOptions
+{
+    return [self.dataStore fetchObjectsWithOptions:fetchOptions];
+}
+
+// overrides superclass
+- (NSUInteger)countObjectsWithOptions:(SCDataFetchOptions *)fetchOptions
+{
+    return [self.dataStore countObjectsWithOptions:fetchOptions];
+}
+
+// overrides superclass
+- (NSArray *)searchObjectsForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames withOptions:(SCDataFetchOptions *)fetchOptions
+{
+    return [self.dataStore searchObjectsForString:searchString propertyNames:propertyNames withOptions:fetchOptions];
+}
+
+// overrides superclass
+- (NSPredicate *)searchPredicateForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames
+{
+    return [self.dataStore searchPredicateForString:searchString propertyNames:propertyNames];
+}
+
+// overrides superclass
+- (NSArray *)fetchGroupsForPropertyName:(NSString *)propertyName withOptions:(SCDataFetchOptions *)fetchOptions
+{
+    return [self.dataStore fetchGroupsForPropertyName:propertyName withOptions:fetchOptions];
+}
+
+// overrides superclass
+- (NSPredicate *)groupPredicateForValue:(NSObject *)value propertyName:(NSString *)propertyName
+{
+    return [self.dataStore groupPredicateForValue:value propertyName:propertyName];
+}
+
+// overrides superclass
+- (NSObject *)valueForPropertyName:(NSString *)propertyName inObject:(NSObject *)object
+{
+    return [self.dataStore valueForPropertyName:propertyName inObject:object];
+}
+
+// overrides superclass
+- (NSString *)stringValueForPropertyName:(NSString *)propertyName inObject:(NSObject *)object separateValuesUsingDelimiter:(NSString *)delimiter
+{
+    return [self.dataStore stringValueForPropertyName:propertyName inObject:object separateValuesUsingDelimiter:delimiter];
+}
+
+// overrides superclass
+- (void)setValue:(NSObject *)value forPropertyName:(NSString *)propertyName inObject:(NSObject *)object
+{
+    [self.dataStore setValue:value forPropertyName:propertyName inObject:object];
+}
+
+// overrides superclass
+- (void)asynchronousInsertObject:(NSObject *)object success:(SCDataStoreInsertSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    __weak typeof(self) weak_self = self;
+    [self.dataStore asynchronousInsertObject:object
+    success:^()
+     {
+         [weak_self cachedObjectsDidChangeWithInsertedObjects:[NSArray arrayWithObject:object] updatedObjects:nil deletedObjects:nil];
+         if(success_block)
+             success_block();
+     }
+    failure:failure_block noConnection:noConnection_block];
+}
+
+// overrides superclass
+- (void)asynchronousUpdateObject:(NSObject *)object success:(SCDataStoreUpdateSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    __weak typeof(self) weak_self = self;
+    [self.dataStore asynchronousUpdateObject:object
+    success:^()
+     {
+         [weak_self cachedObjectsDidChangeWithInsertedObjects:nil updatedObjects:[NSArray arrayWithObject:object] deletedObjects:nil];
+         if(success_block)
+             success_block();
+     }
+    failure:failure_block noConnection:noConnection_block];
+}
+
+// overrides superclass
+- (void)asynchronousDeleteObject:(NSObject *)object success:(SCDataStoreDeleteSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    __weak typeof(self) weak_self = self;
+    [self.dataStore asynchronousDeleteObject:object
+    success:^()
+     {
+         [weak_self cachedObjectsDidChangeWithInsertedObjects:nil updatedObjects:nil deletedObjects:[NSArray arrayWithObject:object]];
+         if(success_block)
+             success_block();
+     }
+    failure:failure_block noConnection:noConnection_block];
+}
+
+// overrides superclass
+- (void)asynchronousUpdateObjects:(NSArray *)objects withPropertyValues:(NSDictionary *)propertyValues success:(SCDataStoreUpdateSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    __weak typeof(self) weak_self = self;
+    [self.dataStore asynchronousUpdateObjects:objects withPropertyValues:propertyValues
+    success:^()
+     {
+         [weak_self cachedObjectsDidChangeWithInsertedObjects:nil updatedObjects:objects deletedObjects:nil];
+         if(success_block)
+             success_block();
+     }
+    failure:failure_block noConnection:noConnection_block];
+}
+
+// overrides superclass
+- (void)asynchronousDeleteObjects:(NSArray *)objects success:(SCDataStoreDeleteSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    __weak typeof(self) weak_self = self;
+    [self.dataStore asynchronousDeleteObjects:objects
+    success:^()
+     {
+         [weak_self cachedObjectsDidChangeWithInsertedObjects:nil updatedObjects:nil deletedObjects:objects];
+         if(success_block)
+             success_block();
+     }
+    failure:failure_block noConnection:noConnection_block];
+}
+
+// overrides superclass
+- (void)asynchronousFetchObjectsWithOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    __weak typeof(self) weak_self = self;
+    
+    SCFetchResultCacheEntry *entry = nil;
+    if(!_boundObject)
+    {
+        NSString *key = [self cacheKeyForFetchOptions:fetchOptions];
+        entry = [self cachedEntryForKey:key];
+        if(!entry)
+        {
+            entry = [[SCFetchResultCacheEntry alloc] init];
+            entry.key = key;
+            if(fetchOptions.filter)
+                entry.filterPredicate = fetchOptions.filterPredicate;
+            if(fetchOptions.sort)
+                entry.sortDescriptors = [fetchOptions sortDescriptors];
+            entry.batched = (fetchOptions.batchSize != 0);
+            
+            // nothing cached yet, simply cache what the wrapped store returns
+            [self.dataStore asynchronousFetchObjectsWithOptions:fetchOptions
+            success:^(NSArray *results)
+             {
+                 [weak_self fetchObjectsSuccessful:results successBlock:^(NSArray *finalResults)
+                  {
+                      [weak_self cacheObjects:finalResults forEntry:entry];
+                      if(success_block)
+                          success_block(finalResults);
+                  }
+                 failure:failure_block];
+             }
+            failure:failure_block noConnection:noConnection_block];
+            
+            return;
+        }
+    }
+    
+    if(!entry)
+    {
+        [self.dataStore asynchronousFetchObjectsWithOptions:fetchOptions
+        success:^(NSArray *results)
+         {
+             [weak_self fetchObjectsSuccessful:results successBlock:success_block failure:failure_block];
+         }
+        failure:failure_block noConnection:noConnection_block];
+        
+        return;
+    }
+    
+    // answer from the cache right away, then revalidate against the wrapped store
+    NSArray *cachedObjects = [NSArray arrayWithArray:entry.objects];
+    // a copy (including any store specific state, such as the next batch URL) so that the caller's batch offset is only advanced once
+    SCDataFetchOptions *revalidationOptions = [fetchOptions copy];
+    NSUInteger batchStartIndex = 0;
+    if(fetchOptions.batchSize)
+    {
+        // the index of the batch's first object in the items fetched using fetchOptions
+        batchStartIndex = (fetchOptions.batchCurrentOffset - fetchOptions.batchStartingOffset) * fetchOptions.batchSize;
+        [fetchOptions incrementBatchOffset];
+    }
+    
+    if(success_block)
+        success_block(cachedObjects);
+    
+    [self.dataStore asynchronousFetchObjectsWithOptions:revalidationOptions
+    success:^(NSArray *results)
+     {
+         [weak_self fetchObjectsSuccessful:results successBlock:^(NSArray *finalResults)
+          {
+              [weak_self didRevalidateObjects:cachedObjects withObjects:finalResults entry:entry fetchOptions:fetchOptions batchStartIndex:batchStartIndex];
+          }
+         failure:nil];
+     }
+    failure:^(NSError *error)
+     {
+         SCDebugLog(@"Warning: Unable to revalidate cached results of '%@': %@", entry.key, error);
+     }
+    noConnection:^BOOL()
+     {
+         return NO;  // keep showing the cached results
+     }];
+}
+
+// overrides superclass
+- (void)asynchronousCountObjectsWithOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreCountSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    [self.dataStore asynchronousCountObjectsWithOptions:fetchOptions success:success_block failure:failure_block noConnection:noConnection_block];
+}
+
+// overrides superclass
+- (void)asynchronousSearchObjectsForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames withOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    [self.dataStore asynchronousSearchObjectsForString:searchString propertyNames:propertyNames withOptions:fetchOptions success:success_block failure:failure_block noConnection:noConnection_block];
+}
+
+// overrides superclass
+- (void)asynchronousFetchGroupsForPropertyName:(NSString *)propertyName withOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    [self.dataStore asynchronousFetchGroupsForPropertyName:propertyName withOptions:fetchOptions success:success_block failure:failure_block noConnection:noConnection_block];
+}
+
+// overrides superclass
+- (void)cancelAsynchronousFetchWithOptions:(SCDataFetchOptions *)fetchOptions
+{
+    [self.dataStore cancelAsynchronousFetchWithOptions:fetchOptions];
+}
+
+// overrides superclass
+- (BOOL)validateInsertForObject:(NSObject *)object
+{
+    return [self.dataStore validateInsertForObject:object];
+}
+
+// overrides superclass
+- (BOOL)validateUpdateForObject:(NSObject *)object
+{
+    return [self.dataStore validateUpdateForObject:object];
+}
+
+// overrides superclass
+- (BOOL)validateDeleteForObject:(NSObject *)object
+{
+    return [self.dataStore validateDeleteForObject:object];
+}
+
+// overrides superclass
+- (BOOL)validateOrderChangeForObject:(NSObject *)object
+{
+    return [self.dataStore validateOrderChangeForObject:object];
+}
+
+// overrides superclass
+- (NSSet *)dirtyPropertyNamesForObject:(NSObject *)object
+{
+    return [self.dataStore dirtyPropertyNamesForObject:object];
+}
+
+// overrides superclass
+- (BOOL)objectHasDirtyProperties:(NSObject *)object
+{
+    return [self.dataStore objectHasDirtyProperties:object];
+}
+
+// overrides superclass
+- (void)clearDirtyPropertyNamesForObject:(NSObject *)object
+{
+    [self.dataStore clearDirtyPropertyNamesForObject:object];
+}
+
+// overrides superclass
+- (void)clearDirtyPropertyNames:(NSSet *)propertyNames forObject:(NSObject *)object
+{
+    [self.dataStore clearDirtyPropertyNames:propertyNames forObject:object];
+}
+
+// overrides superclass
+- (void)markPropertyName:(NSString *)propertyName dirtyInObject:(NSObject *)object
+{
+    [self.dataStore markPropertyName:propertyName dirtyInObject:object];
+}
+
+// overrides superclass
+- (void)commitData
+{
+    [self.dataStore commitData];
+}
+
+// overrides superclass
+- (void)bindStoreToPropertyName:(NSString *)propertyName forObject:(NSObject *)object withDefinition:(SCDataDefinition *)definition
+{
+    _boundObject = object;
+    _boundPropertyName = [propertyName copy];
+    _boundObjectDefinition = definition;
+    
+    self.dataStore.boundObjectStore = self.boundObjectStore;
+    [self.dataStore bindStoreToPropertyName:propertyName forObject:object withDefinition:definition];
+}
+
+// overrides superclass
+- (id)objectIdForObject:(NSObject *)object
+{
+    return [self.dataStore objectIdForObject:object];
+}
+
+@end
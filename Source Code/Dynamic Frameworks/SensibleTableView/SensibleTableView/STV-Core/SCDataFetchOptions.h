@@ -39,7 +39,7 @@
 */
 
 
-@interface SCDataFetchOptions : NSObject
+@interface SCDataFetchOptions : NSObject <NSCopying>
 {
     BOOL _sort;
     NSString *_sortKey;
@@ -126,6 +126,9 @@
  @warning Reserved for internal framework use only. */
 - (void)resetBatchOffset;
 
+/** Returns a copy of the fetch options with the same configuration and current batch offset. Subclasses that add configuration properties should override this method and copy them too. */
+- (id)copyWithZone:(NSZone *)zone;
+
 /** Returns an array of sort-descriptors based on the current sorting configuration. */
 - (NSArray *)sortDescriptors;
 
@@ -82,6 +82,22 @@
 }
 
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    SCDataFetchOptions *copy = [[[self class] allocWithZone:zone] init];
+    // ivars are copied directly, since some setters also change other settings
+    copy->_sort = _sort;
+    copy->_sortKey = [_sortKey copy];
+    copy->_sortAscending = _sortAscending;
+    copy->_filter = _filter;
+    copy->_filterPredicate = _filterPredicate;
+    copy->_batchSize = _batchSize;
+    copy->_batchStartingOffset = _batchStartingOffset;
+    copy->_batchCurrentOffset = _batchCurrentOffset;
+    
+    return copy;
+}
+
 - (void)setSortAscending:(BOOL)sortAscending
 {
     _sortAscending = sortAscending;
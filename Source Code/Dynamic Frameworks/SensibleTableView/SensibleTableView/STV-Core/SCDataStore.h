@@ -30,9 +30,36 @@
 /* Data store notifications (used internally) */
 extern NSString * const SCDataStoreWillDiscardAllUninsertedObjectsNotification;
 
+/* Posted on the main thread when the store learns about objects that were changed outside the app (e.g. by the server). The userInfo dictionary contains arrays of the changed objects under the keys below. */
+extern NSString * const SCDataStoreDidChangeObjectsNotification;
+extern NSString * const SCDataStoreInsertedObjectsKey;
+extern NSString * const SCDataStoreUpdatedObjectsKey;
+extern NSString * const SCDataStoreDeletedObjectsKey;
+/* Optional keys, set by stores that keep live fetch results (e.g. SCCoreDataStore's fetched results controllers). SCDataStoreFetchedObjectsKey contains the complete, ordered results of the fetch options in SCDataStoreFetchOptionsKey (or all of the store's objects when SCDataStoreFetchOptionsKey is missing), and SCDataStoreMovedObjectsKey the objects whose position in these results has changed. */
+extern NSString * const SCDataStoreMovedObjectsKey;
+extern NSString * const SCDataStoreFetchedObjectsKey;
+extern NSString * const SCDataStoreFetchOptionsKey;
+/* Optional key, set when SCDataStoreFetchedObjectsKey only contains one batch of the results of batched fetch options. Contains an NSNumber with the index of the batch's first object in the results, so that sections replace the items they previously fetched for the batch (at most batchSize items) instead of all of their items. */
+extern NSString * const SCDataStoreBatchStartIndexKey;
+/* Optional keys, set along with SCDataStoreFetchedObjectsKey by stores that know where their results changed (e.g. SCCoreDataStore). SCDataStoreRemovedIndexesKey contains an NSIndexSet with the previous indexes of the deleted and moved objects, and SCDataStoreAddedIndexesKey one with the new indexes of the inserted and moved objects. */
+extern NSString * const SCDataStoreRemovedIndexesKey;
+extern NSString * const SCDataStoreAddedIndexesKey;
+/* Optional key, set by stores that know which properties of the updated objects have changed (e.g. SCiCloudKeyValueStore). Contains an NSSet of the changed property names, so that sections bound to the objects only reload the affected cells. */
+extern NSString * const SCDataStoreUpdatedPropertyNamesKey;
+
+/* Posted on the main thread when commitData fails to persist the store's objects. The userInfo dictionary contains the NSError under SCDataStoreErrorKey. */
+extern NSString * const SCDataStoreDidFailCommitNotification;
+extern NSString * const SCDataStoreErrorKey;
+
+/* Keys of the group dictionaries returned by fetchGroupsForPropertyName:withOptions:. SCDataStoreGroupValueKey contains the grouped property's value (NSNull for objects with no value), and SCDataStoreGroupCountKey an NSNumber with the number of objects in the group. */
+extern NSString * const SCDataStoreGroupValueKey;
+extern NSString * const SCDataStoreGroupCountKey;
+
 
 typedef NS_ENUM(NSInteger, SCStoreMode) { SCStoreModeSynchronous, SCStoreModeAsynchronous };
+typedef NS_ENUM(NSInteger, SCOrderingStrategy) { SCOrderingStrategyContiguous, SCOrderingStrategySparse };
 typedef void(^SCDataStoreFetchSuccess_Block)(NSArray *results);
+typedef void(^SCDataStoreCountSuccess_Block)(NSUInteger count);
 typedef void(^SCDataStoreInsertSuccess_Block)();
 typedef void(^SCDataStoreUpdateSuccess_Block)();
 typedef void(^SCDataStoreDeleteSuccess_Block)();
@@ -75,6 +102,11 @@ typedef void(^SCPostFetchAsyncronousAction_Block)(NSArray *results, SCPostFetchA
     NSObject *_boundObject;
     NSString *_boundPropertyName;
     SCDataDefinition *_boundObjectDefinition;
+    NSMapTable *_dirtyPropertyNames;
+    
+    NSMutableDictionary *_sharedFetchResults;
+    NSMapTable *_sharedFetchResultKeys;
+    NSMapTable *_searchFetchOptions;
     
     NSDictionary *_defaultsDictionary;
 }
@@ -103,6 +135,24 @@ typedef void(^SCPostFetchAsyncronousAction_Block)(NSArray *results, SCPostFetchA
 /** Whether the data store supports nil values. Default: YES. */
 @property (nonatomic, readwrite) BOOL supportsNilValues;
 
+/** Specifies how the store assigns order values when objects are reordered (only applicable for stores that persist an order property).
+ 
+ SCOrderingStrategyContiguous keeps order values consecutive, which means that moving an object rewrites the order of every object between its old and new positions. SCOrderingStrategySparse spaces order values orderingGap apart and gives a moved object the midpoint of its new neighbors, so a reorder typically changes a single object. When no gap is left between two neighbors, the store rebalances all its order values.
+ 
+ Default: SCOrderingStrategyContiguous.
+ @warning When using SCOrderingStrategySparse with SCCoreDataStore, existing order values are only spaced out by the first rebalance, and the order attribute should be at least a 32 bit integer.
+ */
+@property (nonatomic, readwrite) SCOrderingStrategy orderingStrategy;
+
+/** The space left between the order values of consecutive objects when orderingStrategy is SCOrderingStrategySparse. Default: 1024. */
+@property (nonatomic, readwrite) NSInteger orderingGap;
+
+/** When TRUE, the store caches the results of the synchronous fetches made by the framework's sections, models and selection cells, sharing them between all the consumers that fetch with the same fetch options. This way, a section and an SCObjectSelectionCell bound to the same store only fetch, filter and sort the objects once. Cached results are discarded whenever objects are inserted, deleted, reordered or modified through the store, and once no consumer holds them anymore. Default: FALSE.
+ @warning The store is not aware of objects added to or removed from its storage directly (e.g. by modifying SCArrayStore's objectsArray). Call invalidateSharedFetchResults after making any such changes.
+ @see fetchSharedObjectsWithOptions:forConsumer:
+ */
+@property (nonatomic, readwrite) BOOL sharesFetchResults;
+
 /** Adds a definition to dataDefinitions. */
 - (void)addDataDefinition:(SCDataDefinition *)definition;
 
@@ -168,6 +218,19 @@ typedef void(^SCPostFetchAsyncronousAction_Block)(NSArray *results, SCPostFetchA
  @return Returns TRUE if successful.*/
 - (BOOL)deleteObject:(NSObject *)object;
 
+/** Sets the given property values in each of the given objects, then updates all the objects in the data store at once. 
+ @param objects The objects to be updated.
+ @param propertyValues A dictionary of the new values, keyed by property name.
+ @return Returns TRUE if successful.
+ @note The default implementation sets the values using setValue:forPropertyName:inObject: and calls updateObject: for each object. Subclasses override it to update all the objects in a single operation. */
+- (BOOL)updateObjects:(NSArray *)objects withPropertyValues:(NSDictionary *)propertyValues;
+
+/** Deletes all the given objects from the data store at once. 
+ @param objects The objects to be deleted.
+ @return Returns TRUE if successful.
+ @note The default implementation calls deleteObject: for each object. Subclasses override it to delete all the objects in a single operation. */
+- (BOOL)deleteObjects:(NSArray *)objects;
+
 /** Fetches objects from the data store that satisfy the given fetch options.
  @param fetchOptions The fetch options that the data store must satisfy when returning the objects.
  @return An array of the fetched objects.
@@ -175,6 +238,51 @@ typedef void(^SCPostFetchAsyncronousAction_Block)(NSArray *results, SCPostFetchA
  */
 - (NSArray *)fetchObjectsWithOptions:(SCDataFetchOptions *)fetchOptions;
 
+/** Returns the objects that satisfy the given fetch options from the results shared by the store's consumers, only calling fetchObjectsWithOptions: when no consumer holds results for the same fetch options. When sharesFetchResults is FALSE, simply returns the results of fetchObjectsWithOptions:.
+ @param fetchOptions The fetch options that the data store must satisfy when returning the objects. When batchSize is set, the batch offset is advanced exactly like fetchObjectsWithOptions: does.
+ @param consumer The object using the results (e.g. a section). The results are held for consumer until it fetches with different fetch options, calls releaseSharedFetchResultsForConsumer:, or is deallocated.
+ @return An array of the fetched objects. The array is shared between consumers and must not be modified.
+ */
+- (NSArray *)fetchSharedObjectsWithOptions:(SCDataFetchOptions *)fetchOptions forConsumer:(NSObject *)consumer;
+
+/** Stops holding the shared fetch results used by the given consumer, discarding them if no other consumer holds them. */
+- (void)releaseSharedFetchResultsForConsumer:(NSObject *)consumer;
+
+/** Discards all the shared fetch results, which are fetched again on the next call to fetchSharedObjectsWithOptions:forConsumer:. Called by the store whenever its objects change. */
+- (void)invalidateSharedFetchResults;
+
+/** Discards only the shared fetch results whose filtering or sorting depends on the given property, since the results hold the very objects being modified. Called by the store when a property of one of its objects is set. */
+- (void)invalidateSharedFetchResultsDependingOnPropertyName:(NSString *)propertyName;
+
+/** Returns the number of objects in the data store that satisfy the given fetch options, without fetching the objects themselves. The batch settings of fetchOptions are ignored.
+ @param fetchOptions The fetch options that the counted objects must satisfy.
+ @return The number of objects, or NSNotFound if the store is unable to count its objects synchronously.
+ @note The default implementation fetches all the objects and counts them. Subclasses should override it with a more efficient implementation.
+ */
+- (NSUInteger)countObjectsWithOptions:(SCDataFetchOptions *)fetchOptions;
+
+/** Fetches the objects from the data store that satisfy the given fetch options and have at least one of the given properties containing the search string. Searches are case and diacritic insensitive.
+ @param searchString The string to search for.
+ @param propertyNames The names of the properties to search.
+ @param fetchOptions The fetch options that the returned objects must also satisfy. When batchSize is set, each call with the same fetch options returns the next batch of search results.
+ @return An array of the matching objects.
+ @note The default implementation fetches with searchFetchOptionsForString:propertyNames:withOptions:, whose filter predicate is narrowed with searchPredicateForString:propertyNames:, which lets stores that evaluate predicates themselves (e.g. Core Data) search without loading all the objects. */
+- (NSArray *)searchObjectsForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames withOptions:(SCDataFetchOptions *)fetchOptions;
+
+/** Returns the predicate used to match the objects that have at least one of the given properties containing searchString. */
+- (NSPredicate *)searchPredicateForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames;
+
+/** Returns the distinct values of the given property among the objects that satisfy the given fetch options, along with the number of objects having each value. Groups are sorted ascending by value, with the group of objects that have no value coming first. The sort and batch settings of fetchOptions are ignored.
+ @param propertyName The name of the property to group the objects by.
+ @param fetchOptions The fetch options that the grouped objects must satisfy.
+ @return An array of NSDictionary objects, each containing a group's value under SCDataStoreGroupValueKey and its object count under SCDataStoreGroupCountKey. Returns nil if the store is unable to group its objects synchronously.
+ @note The default implementation fetches all the objects and groups them in memory. Subclasses should override it with a more efficient implementation.
+ */
+- (NSArray *)fetchGroupsForPropertyName:(NSString *)propertyName withOptions:(SCDataFetchOptions *)fetchOptions;
+
+/** Returns the predicate used to match the objects of the group with the given value. Combine it with the filter predicate of your fetch options to fetch the group's objects. */
+- (NSPredicate *)groupPredicateForValue:(NSObject *)value propertyName:(NSString *)propertyName;
+
 /** Returns the value for the given property name in the given object. 
  @param propertyName The name of the property.
  @param object The object containing propertyName.
@@ -288,6 +396,25 @@ typedef void(^SCPostFetchAsyncronousAction_Block)(NSArray *results, SCPostFetchA
  */
 - (void)asynchronousDeleteObject:(NSObject *)object success:(SCDataStoreDeleteSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block;
 
+/** Asynchronously sets the given property values in each of the given objects, then updates all the objects in the data store at once.
+ @param objects The objects to be updated.
+ @param propertyValues A dictionary of the new values, keyed by property name.
+ @param success_block The code block called after all the objects have been successfully updated.
+ @param failure_block The code block called in case the objects could not be updated. Only called once, with the first error that occurred.
+ @param noConnection_Block The code block called in case no connection could be established to data store.
+ @note The default implementation calls asynchronousUpdateObject:success:failure:noConnection: for each object.
+ */
+- (void)asynchronousUpdateObjects:(NSArray *)objects withPropertyValues:(NSDictionary *)propertyValues success:(SCDataStoreUpdateSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block;
+
+/** Asynchronously deletes all the given objects from the data store at once.
+ @param objects The objects to be deleted.
+ @param success_block The code block called after all the objects have been successfully deleted.
+ @param failure_block The code block called in case the objects could not be deleted. Only called once, with the first error that occurred.
+ @param noConnection_Block The code block called in case no connection could be established to data store.
+ @note The default implementation calls asynchronousDeleteObject:success:failure:noConnection: for each object.
+ */
+- (void)asynchronousDeleteObjects:(NSArray *)objects success:(SCDataStoreDeleteSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block;
+
 /** Asynchronously fetches objects from the data store that satisfy the given fetch options.
  @param fetchOptions The fetch options that the data store must satisfy when returning the objects.
  @param success_block The code block called after the data has been successfully fetched.
@@ -349,6 +476,54 @@ typedef void(^SCPostFetchAsyncronousAction_Block)(NSArray *results, SCPostFetchA
  */
 @property (nonatomic, copy) SCPostFetchAsyncronousAction_Block postAsynchronousFetchObjectsAction;
 
+/** Asynchronously counts the objects in the data store that satisfy the given fetch options, without fetching the objects themselves. The batch settings of fetchOptions are ignored.
+ 
+ @param fetchOptions The fetch options that the counted objects must satisfy.
+ @param success_block The code block called after the objects have been counted successfully.
+ 
+ SCDataStoreCountSuccess_Block syntax:
+    ^(NSUInteger count)
+    {
+        // Your code here
+    }
+ 
+ @param failure_block The code block called in case of failure, or if the store is unable to count its objects.
+ @param noConnection_Block The code block called in case no connection could be established to data store.
+ 
+ @note The default implementation calls success_block with the result of countObjectsWithOptions:.
+ */
+- (void)asynchronousCountObjectsWithOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreCountSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block;
+
+/** Asynchronously fetches the objects from the data store that satisfy the given fetch options and have at least one of the given properties containing the search string. Searches are case and diacritic insensitive.
+ 
+ @param searchString The string to search for.
+ @param propertyNames The names of the properties to search.
+ @param fetchOptions The fetch options that the returned objects must also satisfy. When batchSize is set, each call with the same fetch options returns the next batch of search results.
+ @param success_block The code block called after the search results have been successfully fetched.
+ @param failure_block The code block called in case the search results could not be fetched.
+ @param noConnection_Block The code block called in case no connection could be established to data store.
+ 
+ @note The default implementation calls success_block with the result of searchObjectsForString:propertyNames:withOptions:. Subclasses override it to have the search performed by their server.
+ */
+- (void)asynchronousSearchObjectsForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames withOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block;
+
+/** Asynchronously returns the distinct values of the given property among the objects that satisfy the given fetch options, along with the number of objects having each value. See fetchGroupsForPropertyName:withOptions: for the format of the results.
+ 
+ @param propertyName The name of the property to group the objects by.
+ @param fetchOptions The fetch options that the grouped objects must satisfy.
+ @param success_block The code block called with the groups after they have been successfully fetched.
+ @param failure_block The code block called in case of failure, or if the store is unable to group its objects.
+ @param noConnection_Block The code block called in case no connection could be established to data store.
+ 
+ @note The default implementation calls success_block with the result of fetchGroupsForPropertyName:withOptions:, or for stores in SCStoreModeAsynchronous, asynchronously fetches all the objects and groups them in memory.
+ */
+- (void)asynchronousFetchGroupsForPropertyName:(NSString *)propertyName withOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block;
+
+/** Cancels any asynchronous fetch still in progress for the given fetch options. The success and failure blocks of cancelled fetches are never called.
+ 
+ @note The framework automatically calls this method whenever a section starts a new fetch before its previous one has finished. The default implementation does nothing, subclasses that are able to cancel their fetches should override it. */
+- (void)cancelAsynchronousFetchWithOptions:(SCDataFetchOptions *)fetchOptions;
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 /// @name Data Validation
@@ -367,6 +542,23 @@ typedef void(^SCPostFetchAsyncronousAction_Block)(NSArray *results, SCPostFetchA
 - (BOOL)validateOrderChangeForObject:(NSObject *)object;
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+/// @name Change Tracking
+//////////////////////////////////////////////////////////////////////////////////////////
+
+/** Returns the names of the properties that have been set in the given object through setValue:forPropertyName:inObject: since the object was last fetched or committed. Returns an empty set if no properties have been set. */
+- (NSSet *)dirtyPropertyNamesForObject:(NSObject *)object;
+
+/** Returns TRUE if any property in the given object has been set through setValue:forPropertyName:inObject: since the object was last fetched or committed. */
+- (BOOL)objectHasDirtyProperties:(NSObject *)object;
+
+/** Clears the dirty property names of the given object. Subclasses should call this method once the object's changes have been committed to the underlying storage. */
+- (void)clearDirtyPropertyNamesForObject:(NSObject *)object;
+
+/** Clears only the given dirty property names of the object, typically the names returned by dirtyPropertyNamesForObject: when its changes were sent. Properties set again while the changes were being committed stay dirty. */
+- (void)clearDirtyPropertyNames:(NSSet *)propertyNames forObject:(NSObject *)object;
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 /// @name Data Management
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -390,15 +582,67 @@ typedef void(^SCPostFetchAsyncronousAction_Block)(NSArray *results, SCPostFetchA
  Should only be used by the framework all must be implemented by all subclasses. */
 - (void)bindStoreToPropertyName:(NSString *)propertyName forObject:(NSObject *)object withDefinition:(SCDataDefinition *)definition;
 
+/** The store of the object the store is bound to. Should be set by the framework before calling bindStoreToPropertyName:forObject:withDefinition:. Stores that track changes made to the bound property outside the app (e.g. SCArrayStore) only observe the SCDataStoreDidChangeObjectsNotification of this store. */
+@property (nonatomic, weak) SCDataStore *boundObjectStore;
+
+/** Returns the value that uniquely identifies the given object in the store, or nil if the store has no notion of object ids. Used by the framework to match objects received in SCDataStoreDidChangeObjectsNotification with the objects already fetched. Default: nil. */
+- (id)objectIdForObject:(NSObject *)object;
+
+/** Returns TRUE if object, fetched again, holds the same data as previousObject, its previously fetched instance with the same object id. Used by postChangesFromObjects:toObjects:fetchOptions: to tell updated objects from unchanged ones. Default: TRUE if the objects are identical or isEqual:.
+ @note Override this method in a subclass whose objects compare by identity but carry a modification date or version. */
+- (BOOL)object:(NSObject *)object isUnchangedFromObject:(NSObject *)previousObject;
+
+/** Returns the fetch options that a search using fetchOptions should be fetched with: a copy of fetchOptions whose filter predicate also matches searchString in propertyNames, so that fetchOptions themselves are never modified. The same copy is returned for as long as fetchOptions exist, with their current batch offset, so that the batches of the search carry over between calls. Used by subclasses that search by fetching (e.g. SCCoreDataStore). */
+- (SCDataFetchOptions *)searchFetchOptionsForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames withOptions:(SCDataFetchOptions *)fetchOptions;
+
+/** Returns the key that the shared fetch results of the given fetch options are held under. The default key is made of the sort, filter and batch settings of fetchOptions and the object and property name the store is bound to.
+ @note Override this method in a subclass to add any other state that determines the store's fetch results. */
+- (NSString *)sharedFetchResultsKeyForOptions:(SCDataFetchOptions *)fetchOptions;
+
+/** Returns TRUE if the shared fetch results of the given fetch options could change when the given property of an object changes, which by default is when the property is one of their sort keys or used by their filter predicate.
+ @note Override this method in a subclass whose fetches filter or sort by anything other than the sort and filter settings of fetchOptions. */
+- (BOOL)sharedFetchResultsOfOptions:(SCDataFetchOptions *)fetchOptions dependOnPropertyName:(NSString *)propertyName;
+
+/** Marks the given property name as dirty in the given object. Called by setValue:forPropertyName:inObject:, and should also be called by subclasses that override it without calling super. */
+- (void)markPropertyName:(NSString *)propertyName dirtyInObject:(NSObject *)object;
+
 /** This method is typically called internally by the framework when all unadded objects must be discarded. The method will issue the 'SCDataStoreWillDiscardAllUnaddedObjectsNotification' notification to inform all classes using the store that this will happen. */
 - (void)forceDiscardAllUnaddedObjects;
 
 /** Method called when the application is about to leave the background state. Subclasses should override this method when any initialization is needed at this point. */
 - (void)applicationWillEnterForeground;
 
+/** Sets the order property of the given object to the midpoint of its neighbors in orderedObjects, which must already reflect the object's new position. Used by subclasses that support SCOrderingStrategySparse.
+ @return Returns FALSE without modifying the object if there is no gap left between its neighbors, in which case rebalanceOrderOfObjects:orderPropertyName: should be called.
+ */
+- (BOOL)assignSparseOrderToObject:(NSObject *)object inOrderedObjects:(NSArray *)orderedObjects orderPropertyName:(NSString *)propertyName;
+
+/** Spaces out the order property values of orderedObjects by orderingGap, only modifying the objects whose order changes. Used by subclasses that support SCOrderingStrategySparse. */
+- (void)rebalanceOrderOfObjects:(NSArray *)orderedObjects orderPropertyName:(NSString *)propertyName;
+
+/** Groups the given objects by the values of propertyName, returning the groups in the format of fetchGroupsForPropertyName:withOptions:. Used by subclasses that group their objects in memory. */
+- (NSArray *)groupsForObjects:(NSArray *)objects propertyName:(NSString *)propertyName;
+
+/** Sorts the given mutable array of group dictionaries as described in fetchGroupsForPropertyName:withOptions:. */
+- (void)sortGroups:(NSMutableArray *)groups;
+
 // Internally checks if the 'postAsynchronousFetchObjectsAction' property has been set before calling success_block
 - (void)fetchObjectsSuccessful:(NSArray *)objects successBlock:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block;
 
+/** Posts SCDataStoreDidChangeObjectsNotification with the differences between previously delivered results of fetchOptions and their newly fetched objects, matching the objects using objectIdForObject: (or isEqual: when the store has no object ids). Used by subclasses that deliver the results of the same fetch more than once (e.g. cached results followed by fresh ones). Pass nil fetchOptions when the objects are all of the store's objects, which sections then filter and sort using their own fetch options.
+ @return The new results, reusing the previous instances of the objects that haven't changed. */
+- (NSArray *)postChangesFromObjects:(NSArray *)previousObjects toObjects:(NSArray *)objects fetchOptions:(SCDataFetchOptions *)fetchOptions;
+
+/** Same as postChangesFromObjects:toObjects:fetchOptions:, but calls before_block with the new results before the notification is posted. Used by subclasses that must store the new results first, since observers fetch from the store while handling the notification. */
+- (NSArray *)postChangesFromObjects:(NSArray *)previousObjects toObjects:(NSArray *)objects fetchOptions:(SCDataFetchOptions *)fetchOptions beforePosting:(void (^)(NSArray *mergedObjects))before_block;
+
+/** Same as postChangesFromObjects:toObjects:fetchOptions:, but for a single batch of batched fetchOptions, whose first object is at startIndex in the results. Sections that fetched the batch replace its items with the returned objects, since objects missing from the batch may have only moved to another one.
+ @return The new objects of the batch, reusing the previous instances of the objects that haven't changed. */
+- (NSArray *)postChangesFromBatchObjects:(NSArray *)previousObjects toObjects:(NSArray *)objects batchStartIndex:(NSUInteger)startIndex fetchOptions:(SCDataFetchOptions *)fetchOptions;
+
+/** Applies the SCDataStoreFetchedObjectsKey results in the userInfo of SCDataStoreDidChangeObjectsNotification to items, which hold the previously fetched results. Only the changed objects are removed and added when the userInfo has SCDataStoreRemovedIndexesKey and SCDataStoreAddedIndexesKey and the items at the removed indexes are the deleted and moved objects, so that large results (e.g. Core Data's batched results) are not copied on every change. Otherwise items are replaced with the fetched objects. */
++ (void)applyFetchedObjectsInChanges:(NSDictionary *)changes toItems:(NSMutableArray *)items;
+
 @end
 
 
@@ -23,6 +23,56 @@
 #import "SCDataStore.h"
 
 NSString * const SCDataStoreWillDiscardAllUninsertedObjectsNotification = @"SCDataStoreWillDiscardAllUninsertedObjectsNotification";
+NSString * const SCDataStoreDidChangeObjectsNotification = @"SCDataStoreDidChangeObjectsNotification";
+NSString * const SCDataStoreInsertedObjectsKey = @"SCDataStoreInsertedObjectsKey";
+NSString * const SCDataStoreUpdatedObjectsKey = @"SCDataStoreUpdatedObjectsKey";
+NSString * const SCDataStoreDeletedObjectsKey = @"SCDataStoreDeletedObjectsKey";
+NSString * const SCDataStoreMovedObjectsKey = @"SCDataStoreMovedObjectsKey";
+NSString * const SCDataStoreFetchedObjectsKey = @"SCDataStoreFetchedObjectsKey";
+NSString * const SCDataStoreFetchOptionsKey = @"SCDataStoreFetchOptionsKey";
+NSString * const SCDataStoreBatchStartIndexKey = @"SCDataStoreBatchStartIndexKey";
+NSString * const SCDataStoreRemovedIndexesKey = @"SCDataStoreRemovedIndexesKey";
+NSString * const SCDataStoreAddedIndexesKey = @"SCDataStoreAddedIndexesKey";
+NSString * const SCDataStoreUpdatedPropertyNamesKey = @"SCDataStoreUpdatedPropertyNamesKey";
+NSString * const SCDataStoreDidFailCommitNotification = @"SCDataStoreDidFailCommitNotification";
+NSString * const SCDataStoreErrorKey = @"SCDataStoreErrorKey";
+NSString * const SCDataStoreGroupValueKey = @"SCDataStoreGroupValueKey";
+NSString * const SCDataStoreGroupCountKey = @"SCDataStoreGroupCountKey";
+
+
+
+/* Internal class that holds fetch results shared by all the consumers of the same fetch options */
+@interface SCSharedFetchResult : NSObject
+
+@property (nonatomic, strong) NSArray *objects;
+@property (nonatomic, strong) NSHashTable *consumers;
+@property (nonatomic, strong) SCDataFetchOptions *fetchOptions;
+
+@end
+
+@implementation SCSharedFetchResult
+
+@end
+
+
+
+
+@interface SCDataStore ()
+
+// Returns the userInfo of SCDataStoreDidChangeObjectsNotification for the differences between the two results, or nil if they have no differences
+- (NSMutableDictionary *)changesFromObjects:(NSArray *)previousObjects toObjects:(NSArray *)objects mergedObjects:(NSArray **)mergedObjectsPtr;
+
+// Freshly fetched objects have no pending changes
+- (void)clearDirtyPropertyNamesForFetchedObjects:(NSArray *)objects;
+
+// Returns TRUE if the two key paths are the same, or one of them is part of the other (e.g. "address" and "address.city")
+- (BOOL)keyPath:(NSString *)keyPath overlapsKeyPath:(NSString *)otherKeyPath;
+
+// Returns TRUE if evaluating the predicate or expression could depend on the given property. Anything that can't be inspected (e.g. block predicates) is assumed to depend on it.
+- (BOOL)predicate:(NSPredicate *)predicate dependsOnPropertyName:(NSString *)propertyName;
+- (BOOL)expression:(NSExpression *)expression dependsOnPropertyName:(NSString *)propertyName;
+
+@end
 
 
 @implementation SCDataStore
@@ -46,6 +96,9 @@ NSString * const SCDataStoreWillDiscardAllUninsertedObjectsNotification = @"SCDa
         
         _supportsNilValues = YES;
         
+        _orderingStrategy = SCOrderingStrategyContiguous;
+        _orderingGap = 1024;
+        
         _storedData = nil;
         _defaultDataDefinition = nil;
         _dataDefinitions = [[NSMutableDictionary alloc] init];
@@ -54,6 +107,13 @@ NSString * const SCDataStoreWillDiscardAllUninsertedObjectsNotification = @"SCDa
         _boundObject = nil;
         _boundPropertyName = nil;
         _boundObjectDefinition = nil;
+        // objects are weakly held and compared by pointer, since dictionary objects change their hash when mutated
+        _dirtyPropertyNames = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsWeakMemory|NSPointerFunctionsObjectPointerPersonality valueOptions:NSPointerFunctionsStrongMemory capacity:0];
+        
+        _sharesFetchResults = FALSE;
+        _sharedFetchResults = [[NSMutableDictionary alloc] init];
+        _sharedFetchResultKeys = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsWeakMemory|NSPointerFunctionsObjectPointerPersonality valueOptions:NSPointerFunctionsStrongMemory capacity:0];
+        _searchFetchOptions = [NSMapTable weakToStrongObjectsMapTable];
         
         _defaultsDictionary = nil;
         
@@ -61,6 +121,9 @@ NSString * const SCDataStoreWillDiscardAllUninsertedObjectsNotification = @"SCDa
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(commitData) name:UIApplicationDidEnterBackgroundNotification object:nil];
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(commitData) name:UIApplicationWillTerminateNotification object:nil];
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(applicationWillEnterForeground) name:UIApplicationWillEnterForegroundNotification object:nil];
+        
+        // objects changed outside the app invalidate any shared results
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(invalidateSharedFetchResults) name:SCDataStoreDidChangeObjectsNotification object:self];
 	}
 	return self;
 }
@@ -84,6 +147,16 @@ NSString * const SCDataStoreWillDiscardAllUninsertedObjectsNotification = @"SCDa
     _defaultDataDefinition = definition;
     
     [self addDataDefinition:definition];
+    
+    [self invalidateSharedFetchResults];
+}
+
+- (void)setSharesFetchResults:(BOOL)sharesFetchResults
+{
+    _sharesFetchResults = sharesFetchResults;
+    
+    if(!sharesFetchResults)
+        [self invalidateSharedFetchResults];
 }
 
 - (NSObject *)createNewObject
@@ -133,12 +206,265 @@ NSString * const SCDataStoreWillDiscardAllUninsertedObjectsNotification = @"SCDa
     return FALSE;
 }
 
+- (BOOL)updateObjects:(NSArray *)objects withPropertyValues:(NSDictionary *)propertyValues
+{
+    // Subclasses should override with an implementation that updates all objects at once
+    for(NSObject *object in objects)
+    {
+        for(NSString *propertyName in propertyValues)
+            [self setValue:[propertyValues valueForKey:propertyName] forPropertyName:propertyName inObject:object];
+        
+        [self updateObject:object];
+    }
+    
+    return TRUE;
+}
+
+- (BOOL)deleteObjects:(NSArray *)objects
+{
+    // Subclasses should override with an implementation that deletes all objects at once
+    BOOL success = TRUE;
+    for(NSObject *object in objects)
+    {
+        if(![self deleteObject:object])
+            success = FALSE;
+    }
+    
+    return success;
+}
+
 - (NSArray *)fetchObjectsWithOptions:(SCDataFetchOptions *)fetchOptions
 {
     // Subclasses must override.
     return nil;
 }
 
+- (NSString *)sharedFetchResultsKeyForOptions:(SCDataFetchOptions *)fetchOptions
+{
+    // normalize the sort keys so that equivalent sort settings share their results
+    NSMutableString *sortKeys = [NSMutableString string];
+    if(fetchOptions.sort)
+    {
+        for(NSSortDescriptor *descriptor in [fetchOptions sortDescriptors])
+            [sortKeys appendFormat:@"%@%@;", descriptor.key, descriptor.ascending ? @"+" : @"-"];
+    }
+    NSPredicate *filterPredicate = nil;
+    if(fetchOptions.filter)
+        filterPredicate = fetchOptions.filterPredicate;
+    
+    return [NSString stringWithFormat:@"sort:%@|filter:%@|batch:%lu,%lu|bound:%p,%@", sortKeys, filterPredicate.predicateFormat, (unsigned long)fetchOptions.batchSize, (unsigned long)(fetchOptions.batchSize ? fetchOptions.nextBatchStartIndex : 0), _boundObject, _boundPropertyName];
+}
+
+- (NSArray *)fetchSharedObjectsWithOptions:(SCDataFetchOptions *)fetchOptions forConsumer:(NSObject *)consumer
+{
+    if(!self.sharesFetchResults || !consumer)
+    {
+        NSArray *objects = [self fetchObjectsWithOptions:fetchOptions];
+        [self clearDirtyPropertyNamesForFetchedObjects:objects];
+        
+        return objects;
+    }
+    
+    NSString *key = [self sharedFetchResultsKeyForOptions:fetchOptions];
+    
+    SCSharedFetchResult *sharedResult = nil;
+    @synchronized(_sharedFetchResults)
+    {
+        NSString *previousKey = [_sharedFetchResultKeys objectForKey:consumer];
+        if(previousKey && ![previousKey isEqualToString:key])
+            [self releaseSharedFetchResultsForConsumer:consumer];
+        
+        // drop the results whose consumers have all been deallocated
+        NSMutableArray *unusedKeys = [NSMutableArray array];
+        [_sharedFetchResults enumerateKeysAndObjectsUsingBlock:^(NSString *resultKey, SCSharedFetchResult *result, BOOL *stop)
+         {
+             if(![[result.consumers allObjects] count])
+                 [unusedKeys addObject:resultKey];
+         }];
+        [_sharedFetchResults removeObjectsForKeys:unusedKeys];
+        
+        sharedResult = [_sharedFetchResults objectForKey:key];
+    }
+    
+    if(sharedResult)
+    {
+        // keep the batch offset in step with what fetchObjectsWithOptions: would have done
+        if(fetchOptions.batchSize)
+            [fetchOptions incrementBatchOffset];
+    }
+    else
+    {
+        NSArray *objects = [self fetchObjectsWithOptions:fetchOptions];
+        if(!objects)
+            return nil;
+        [self clearDirtyPropertyNamesForFetchedObjects:objects];
+        
+        sharedResult = [[SCSharedFetchResult alloc] init];
+        sharedResult.objects = [NSArray arrayWithArray:objects];
+        sharedResult.consumers = [NSHashTable weakObjectsHashTable];
+        sharedResult.fetchOptions = [fetchOptions copy];
+        @synchronized(_sharedFetchResults)
+        {
+            [_sharedFetchResults setObject:sharedResult forKey:key];
+        }
+    }
+    
+    @synchronized(_sharedFetchResults)
+    {
+        [sharedResult.consumers addObject:consumer];
+        [_sharedFetchResultKeys setObject:key forKey:consumer];
+    }
+    
+    return sharedResult.objects;
+}
+
+- (void)releaseSharedFetchResultsForConsumer:(NSObject *)consumer
+{
+    if(!consumer)
+        return;
+    
+    @synchronized(_sharedFetchResults)
+    {
+        NSString *key = [_sharedFetchResultKeys objectForKey:consumer];
+        if(!key)
+            return;
+        
+        [_sharedFetchResultKeys removeObjectForKey:consumer];
+        
+        SCSharedFetchResult *sharedResult = [_sharedFetchResults objectForKey:key];
+        [sharedResult.consumers removeObject:consumer];
+        if(sharedResult && ![[sharedResult.consumers allObjects] count])
+            [_sharedFetchResults removeObjectForKey:key];
+    }
+}
+
+- (void)invalidateSharedFetchResults
+{
+    @synchronized(_sharedFetchResults)
+    {
+        // consumers keep their keys so that releasing them later is harmless
+        [_sharedFetchResults removeAllObjects];
+    }
+}
+
+- (void)invalidateSharedFetchResultsDependingOnPropertyName:(NSString *)propertyName
+{
+    @synchronized(_sharedFetchResults)
+    {
+        NSMutableArray *dependentKeys = [NSMutableArray array];
+        [_sharedFetchResults enumerateKeysAndObjectsUsingBlock:^(NSString *resultKey, SCSharedFetchResult *result, BOOL *stop)
+         {
+             if(!result.fetchOptions || [self sharedFetchResultsOfOptions:result.fetchOptions dependOnPropertyName:propertyName])
+                 [dependentKeys addObject:resultKey];
+         }];
+        [_sharedFetchResults removeObjectsForKeys:dependentKeys];
+    }
+}
+
+- (BOOL)sharedFetchResultsOfOptions:(SCDataFetchOptions *)fetchOptions dependOnPropertyName:(NSString *)propertyName
+{
+    if(!propertyName)
+        return TRUE;
+    
+    if(fetchOptions.sort)
+    {
+        for(NSSortDescriptor *descriptor in [fetchOptions sortDescriptors])
+        {
+            if([self keyPath:descriptor.key overlapsKeyPath:propertyName])
+                return TRUE;
+        }
+    }
+    if(fetchOptions.filter && fetchOptions.filterPredicate)
+        return [self predicate:fetchOptions.filterPredicate dependsOnPropertyName:propertyName];
+    
+    return FALSE;
+}
+
+- (BOOL)keyPath:(NSString *)keyPath overlapsKeyPath:(NSString *)otherKeyPath
+{
+    if(!keyPath || !otherKeyPath)
+        return FALSE;
+    
+    return [keyPath isEqualToString:otherKeyPath] || [keyPath hasPrefix:[otherKeyPath stringByAppendingString:@"."]] || [otherKeyPath hasPrefix:[keyPath stringByAppendingString:@"."]];
+}
+
+- (BOOL)predicate:(NSPredicate *)predicate dependsOnPropertyName:(NSString *)propertyName
+{
+    if([predicate isKindOfClass:[NSCompoundPredicate class]])
+    {
+        for(NSPredicate *subpredicate in [(NSCompoundPredicate *)predicate subpredicates])
+        {
+            if([self predicate:subpredicate dependsOnPropertyName:propertyName])
+                return TRUE;
+        }
+        return FALSE;
+    }
+    if([predicate isKindOfClass:[NSComparisonPredicate class]])
+    {
+        NSComparisonPredicate *comparisonPredicate = (NSComparisonPredicate *)predicate;
+        return [self expression:comparisonPredicate.leftExpression dependsOnPropertyName:propertyName] || [self expression:comparisonPredicate.rightExpression dependsOnPropertyName:propertyName];
+    }
+    
+    return TRUE;
+}
+
+- (BOOL)expression:(NSExpression *)expression dependsOnPropertyName:(NSString *)propertyName
+{
+    switch(expression.expressionType)
+    {
+        case NSConstantValueExpressionType:
+        case NSEvaluatedObjectExpressionType:
+        case NSVariableExpressionType:
+            return FALSE;
+            
+        case NSKeyPathExpressionType:
+            return [self keyPath:expression.keyPath overlapsKeyPath:propertyName];
+            
+        case NSFunctionExpressionType:
+        {
+            if([self expression:expression.operand dependsOnPropertyName:propertyName])
+                return TRUE;
+            for(NSExpression *argument in expression.arguments)
+            {
+                if([self expression:argument dependsOnPropertyName:propertyName])
+                    return TRUE;
+            }
+            return FALSE;
+        }
+            
+        case NSAggregateExpressionType:
+        {
+            if(![expression.collection isKindOfClass:[NSArray class]])
+                return FALSE;
+            for(NSExpression *element in (NSArray *)expression.collection)
+            {
+                if([element isKindOfClass:[NSExpression class]] && [self expression:element dependsOnPropertyName:propertyName])
+                    return TRUE;
+            }
+            return FALSE;
+        }
+            
+        default:
+            return TRUE;
+    }
+}
+
+- (NSUInteger)countObjectsWithOptions:(SCDataFetchOptions *)fetchOptions
+{
+    // Subclasses should override with an implementation that doesn't fetch the objects
+    NSUInteger batchSize = fetchOptions.batchSize;
+    NSUInteger batchOffset = fetchOptions.batchCurrentOffset;
+    fetchOptions.batchSize = 0;
+    NSArray *objects = [self fetchObjectsWithOptions:fetchOptions];
+    fetchOptions.batchSize = batchSize;
+    [fetchOptions setBatchOffset:batchOffset];
+    
+    if(!objects)
+        return NSNotFound;
+    //else
+    return objects.count;
+}
+
 - (NSObject *)valueForPropertyName:(NSString *)propertyName inObject:(NSObject *)object
 {
     if([SCUtilities isBasicDataTypeClass:[object class]])
@@ -254,6 +580,100 @@ separateValuesUsingDelimiter:(NSString *)delimiter
         }
         [object setValue:value forKeyPath:propertyName];
     }
+    
+    [self markPropertyName:propertyName dirtyInObject:object];
+}
+
+- (id)objectIdForObject:(NSObject *)object
+{
+    // Subclasses should override when objects have unique ids.
+    return nil;
+}
+
+- (BOOL)object:(NSObject *)object isUnchangedFromObject:(NSObject *)previousObject
+{
+    return (object==previousObject || [previousObject isEqual:object]);
+}
+
+- (void)markPropertyName:(NSString *)propertyName dirtyInObject:(NSObject *)object
+{
+    if(!propertyName || !object)
+        return;
+    
+    @synchronized(_dirtyPropertyNames)
+    {
+        NSMutableSet *propertyNames = [_dirtyPropertyNames objectForKey:object];
+        if(!propertyNames)
+        {
+            propertyNames = [NSMutableSet set];
+            [_dirtyPropertyNames setObject:propertyNames forKey:object];
+        }
+        [propertyNames addObject:propertyName];
+    }
+    
+    // the shared objects already hold the new value, so only the results filtered or sorted by the property are stale
+    [self invalidateSharedFetchResultsDependingOnPropertyName:propertyName];
+}
+
+- (NSSet *)dirtyPropertyNamesForObject:(NSObject *)object
+{
+    if(!object)
+        return [NSSet set];
+    
+    @synchronized(_dirtyPropertyNames)
+    {
+        NSSet *propertyNames = [_dirtyPropertyNames objectForKey:object];
+        return propertyNames ? [NSSet setWithSet:propertyNames] : [NSSet set];
+    }
+}
+
+- (BOOL)objectHasDirtyProperties:(NSObject *)object
+{
+    if(!object)
+        return FALSE;
+    
+    @synchronized(_dirtyPropertyNames)
+    {
+        return [[_dirtyPropertyNames objectForKey:object] count] > 0;
+    }
+}
+
+- (void)clearDirtyPropertyNamesForObject:(NSObject *)object
+{
+    if(!object)
+        return;
+    
+    @synchronized(_dirtyPropertyNames)
+    {
+        [_dirtyPropertyNames removeObjectForKey:object];
+    }
+}
+
+- (void)clearDirtyPropertyNames:(NSSet *)propertyNames forObject:(NSObject *)object
+{
+    if(!propertyNames.count || !object)
+        return;
+    
+    @synchronized(_dirtyPropertyNames)
+    {
+        // properties set again while the changes were being committed stay dirty
+        NSMutableSet *dirtyPropertyNames = [_dirtyPropertyNames objectForKey:object];
+        [dirtyPropertyNames minusSet:propertyNames];
+        if(dirtyPropertyNames && !dirtyPropertyNames.count)
+            [_dirtyPropertyNames removeObjectForKey:object];
+    }
+}
+
+- (void)clearDirtyPropertyNamesForFetchedObjects:(NSArray *)objects
+{
+    @synchronized(_dirtyPropertyNames)
+    {
+        if(_dirtyPropertyNames.count)
+        {
+            for(NSObject *object in objects)
+                [_dirtyPropertyNames removeObjectForKey:object];
+        }
+    }
 }
 
 - (BOOL)validateInsertForObject:(NSObject *)object
@@ -280,6 +700,58 @@ separateValuesUsingDelimiter:(NSString *)delimiter
     return FALSE;
 }
 
+- (BOOL)assignSparseOrderToObject:(NSObject *)object inOrderedObjects:(NSArray *)orderedObjects orderPropertyName:(NSString *)propertyName
+{
+    NSUInteger index = [orderedObjects indexOfObjectIdenticalTo:object];
+    if(index == NSNotFound)
+        return FALSE;
+    
+    NSInteger gap = MAX(self.orderingGap, 2);
+    NSNumber *previousOrder = nil;
+    NSNumber *nextOrder = nil;
+    if(index > 0)
+        previousOrder = (NSNumber *)[self valueForPropertyName:propertyName inObject:[orderedObjects objectAtIndex:index-1]];
+    if(index+1 < orderedObjects.count)
+        nextOrder = (NSNumber *)[self valueForPropertyName:propertyName inObject:[orderedObjects objectAtIndex:index+1]];
+    if(previousOrder && ![previousOrder isKindOfClass:[NSNumber class]])
+        return FALSE;
+    if(nextOrder && ![nextOrder isKindOfClass:[NSNumber class]])
+        return FALSE;
+    
+    NSInteger order;
+    if(previousOrder && nextOrder)
+    {
+        order = [previousOrder integerValue] + ([nextOrder integerValue]-[previousOrder integerValue])/2;
+        if(order<=[previousOrder integerValue] || order>=[nextOrder integerValue])
+            return FALSE;  // no gap left
+    }
+    else if(previousOrder)
+        order = [previousOrder integerValue] + gap;
+    else if(nextOrder)
+        order = [nextOrder integerValue] - gap;
+    else
+        order = 0;
+    
+    [self setValue:[NSNumber numberWithInteger:order] forPropertyName:propertyName inObject:object];
+    
+    return TRUE;
+}
+
+- (void)rebalanceOrderOfObjects:(NSArray *)orderedObjects orderPropertyName:(NSString *)propertyName
+{
+    NSInteger gap = MAX(self.orderingGap, 2);
+    for(NSUInteger i=0; i<orderedObjects.count; i++)
+    {
+        NSObject *obj = [orderedObjects objectAtIndex:i];
+        NSInteger order = i * gap;
+        NSNumber *currentOrder = (NSNumber *)[self valueForPropertyName:propertyName inObject:obj];
+        if([currentOrder isKindOfClass:[NSNumber class]] && [currentOrder integerValue]==order)
+            continue;
+        
+        [self setValue:[NSNumber numberWithInteger:order] forPropertyName:propertyName inObject:obj];
+    }
+}
+
 - (void)addDataDefinition:(SCDataDefinition *)definition
 {
     if(definition && definition.dataStructureName && ![_dataDefinitions valueForKey:definition.dataStructureName])
@@ -312,6 +784,124 @@ separateValuesUsingDelimiter:(NSString *)delimiter
     }
 }
 
+- (NSArray *)searchObjectsForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames withOptions:(SCDataFetchOptions *)fetchOptions
+{
+    // let the fetch evaluate the search along with the filter
+    SCDataFetchOptions *searchFetchOptions = [self searchFetchOptionsForString:searchString propertyNames:propertyNames withOptions:fetchOptions];
+    NSArray *results = [self fetchObjectsWithOptions:searchFetchOptions];
+    
+    // keep the batch offset of fetchOptions in step with the searched batches
+    if(fetchOptions.batchSize)
+        [fetchOptions setBatchOffset:searchFetchOptions.batchCurrentOffset];
+    
+    return results;
+}
+
+- (SCDataFetchOptions *)searchFetchOptionsForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames withOptions:(SCDataFetchOptions *)fetchOptions
+{
+    if(!fetchOptions)
+        fetchOptions = [self.defaultDataDefinition generateCompatibleDataFetchOptions];
+    
+    SCDataFetchOptions *searchFetchOptions = [_searchFetchOptions objectForKey:fetchOptions];
+    if(!searchFetchOptions)
+    {
+        searchFetchOptions = [fetchOptions copy];
+        [_searchFetchOptions setObject:searchFetchOptions forKey:fetchOptions];
+    }
+    [searchFetchOptions setBatchOffset:fetchOptions.batchCurrentOffset];
+    searchFetchOptions.filterPredicate = [self searchPredicateForString:searchString propertyNames:propertyNames filterPredicate:(fetchOptions.filter ? fetchOptions.filterPredicate : nil)];
+    searchFetchOptions.filter = TRUE;
+    
+    return searchFetchOptions;
+}
+
+- (NSPredicate *)searchPredicateForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames
+{
+    NSMutableArray *subpredicates = [NSMutableArray arrayWithCapacity:propertyNames.count];
+    for(NSString *propertyName in propertyNames)
+        [subpredicates addObject:[NSPredicate predicateWithFormat:@"%K contains[cd] %@", propertyName, searchString]];
+    
+    return [NSCompoundPredicate orPredicateWithSubpredicates:subpredicates];
+}
+
+// Returns the search predicate combined with the given filter predicate
+- (NSPredicate *)searchPredicateForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames filterPredicate:(NSPredicate *)filterPredicate
+{
+    NSPredicate *searchPredicate = [self searchPredicateForString:searchString propertyNames:propertyNames];
+    if(!filterPredicate)
+        return searchPredicate;
+    
+    return [NSCompoundPredicate andPredicateWithSubpredicates:[NSArray arrayWithObjects:filterPredicate, searchPredicate, nil]];
+}
+
+- (NSArray *)fetchGroupsForPropertyName:(NSString *)propertyName withOptions:(SCDataFetchOptions *)fetchOptions
+{
+    // Subclasses should override with an implementation that doesn't fetch the objects
+    NSUInteger batchSize = fetchOptions.batchSize;
+    NSUInteger batchOffset = fetchOptions.batchCurrentOffset;
+    fetchOptions.batchSize = 0;
+    NSArray *objects = [self fetchObjectsWithOptions:fetchOptions];
+    fetchOptions.batchSize = batchSize;
+    [fetchOptions setBatchOffset:batchOffset];
+    
+    if(!objects)
+        return nil;
+    //else
+    return [self groupsForObjects:objects propertyName:propertyName];
+}
+
+- (NSPredicate *)groupPredicateForValue:(NSObject *)value propertyName:(NSString *)propertyName
+{
+    if(!value || [value isKindOfClass:[NSNull class]])
+        return [NSPredicate predicateWithFormat:@"%K == nil", propertyName];
+    //else
+    return [NSPredicate predicateWithFormat:@"%K == %@", propertyName, value];
+}
+
+- (NSArray *)groupsForObjects:(NSArray *)objects propertyName:(NSString *)propertyName
+{
+    // a single hashing pass, keys aren't copied so that objects (e.g. relationship values) can be grouped too
+    NSMapTable *groupCounts = [NSMapTable strongToStrongObjectsMapTable];
+    NSMutableArray *groupValues = [NSMutableArray array];
+    for(NSObject *object in objects)
+    {
+        NSObject *value = [self valueForPropertyName:propertyName inObject:object];
+        if(!value)
+            value = [NSNull null];
+        
+        NSNumber *count = [groupCounts objectForKey:value];
+        if(!count)
+            [groupValues addObject:value];
+        [groupCounts setObject:[NSNumber numberWithUnsignedInteger:count.unsignedIntegerValue+1] forKey:value];
+    }
+    
+    NSMutableArray *groups = [NSMutableArray arrayWithCapacity:groupValues.count];
+    for(NSObject *value in groupValues)
+        [groups addObject:[NSDictionary dictionaryWithObjectsAndKeys:value, SCDataStoreGroupValueKey, [groupCounts objectForKey:value], SCDataStoreGroupCountKey, nil]];
+    [self sortGroups:groups];
+    
+    return groups;
+}
+
+- (void)sortGroups:(NSMutableArray *)groups
+{
+    [groups sortWithOptions:NSSortStable usingComparator:^NSComparisonResult(NSDictionary *group1, NSDictionary *group2)
+     {
+         id value1 = [group1 valueForKey:SCDataStoreGroupValueKey];
+         id value2 = [group2 valueForKey:SCDataStoreGroupValueKey];
+         BOOL null1 = [value1 isKindOfClass:[NSNull class]];
+         BOOL null2 = [value2 isKindOfClass:[NSNull class]];
+         if(null1 || null2)
+             return (null1 == null2) ? NSOrderedSame : (null1 ? NSOrderedAscending : NSOrderedDescending);
+         if([value1 class]!=[value2 class] && !([value1 isKindOfClass:[NSString class]] && [value2 isKindOfClass:[NSString class]]) && !([value1 isKindOfClass:[NSNumber class]] && [value2 isKindOfClass:[NSNumber class]]))
+             return NSOrderedSame;
+         if(![value1 respondsToSelector:@selector(compare:)])
+             return NSOrderedSame;
+         
+         return [value1 compare:value2];
+     }];
+}
+
 - (void)applicationWillEnterForeground
 {
     // Does nothing. Should be implemented as needed by subclasses.
@@ -338,6 +928,79 @@ separateValuesUsingDelimiter:(NSString *)delimiter
         failure_block(nil);
 }
 
+- (void)asynchronousUpdateObjects:(NSArray *)objects withPropertyValues:(NSDictionary *)propertyValues success:(SCDataStoreUpdateSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    // Should be overridden by subclasses that are able to update all objects in a single request
+    if(!objects.count)
+    {
+        if(success_block)
+            success_block();
+        
+        return;
+    }
+    
+    __block NSUInteger pendingCount = objects.count;
+    __block BOOL failed = FALSE;
+    for(NSObject *object in objects)
+    {
+        for(NSString *propertyName in propertyValues)
+            [self setValue:[propertyValues valueForKey:propertyName] forPropertyName:propertyName inObject:object];
+        
+        [self asynchronousUpdateObject:object
+        success:^()
+         {
+             pendingCount--;
+             if(!pendingCount && !failed && success_block)
+                 success_block();
+         }
+        failure:^(NSError *error)
+         {
+             if(failed)
+                 return;
+             
+             failed = TRUE;
+             if(failure_block)
+                 failure_block(error);
+         }
+        noConnection:noConnection_block];
+    }
+}
+
+- (void)asynchronousDeleteObjects:(NSArray *)objects success:(SCDataStoreDeleteSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    // Should be overridden by subclasses that are able to delete all objects in a single request
+    if(!objects.count)
+    {
+        if(success_block)
+            success_block();
+        
+        return;
+    }
+    
+    __block NSUInteger pendingCount = objects.count;
+    __block BOOL failed = FALSE;
+    for(NSObject *object in objects)
+    {
+        [self asynchronousDeleteObject:object
+        success:^()
+         {
+             pendingCount--;
+             if(!pendingCount && !failed && success_block)
+                 success_block();
+         }
+        failure:^(NSError *error)
+         {
+             if(failed)
+                 return;
+             
+             failed = TRUE;
+             if(failure_block)
+                 failure_block(error);
+         }
+        noConnection:noConnection_block];
+    }
+}
+
 - (void)asynchronousFetchObjectsWithOptions:(SCDataFetchOptions *)options success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
 {
     // Must be implemented by subclasses that support SCDataStoreModeAsynchronous
@@ -345,8 +1008,73 @@ separateValuesUsingDelimiter:(NSString *)delimiter
         failure_block(nil);
 }
 
+- (void)asynchronousCountObjectsWithOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreCountSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    // Should be implemented by subclasses that support SCDataStoreModeAsynchronous
+    NSUInteger count = [self countObjectsWithOptions:fetchOptions];
+    if(count == NSNotFound)
+    {
+        if(failure_block)
+            failure_block(nil);
+    }
+    else
+    {
+        if(success_block)
+            success_block(count);
+    }
+}
+
+- (void)asynchronousSearchObjectsForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames withOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    // Should be implemented by subclasses that support SCDataStoreModeAsynchronous
+    NSArray *results = [self searchObjectsForString:searchString propertyNames:propertyNames withOptions:fetchOptions];
+    [self fetchObjectsSuccessful:results successBlock:success_block failure:failure_block];
+}
+
+- (void)asynchronousFetchGroupsForPropertyName:(NSString *)propertyName withOptions:(SCDataFetchOptions *)fetchOptions success:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block noConnection:(SCNoConnection_Block)noConnection_block
+{
+    // Should be implemented by subclasses that are able to group their objects on the server
+    if(self.storeMode == SCStoreModeAsynchronous)
+    {
+        // fetch all the matching objects with separate options, as fetchOptions may still be used to fetch batches
+        SCDataFetchOptions *groupFetchOptions = [SCDataFetchOptions optionsWithSortKey:nil sortAscending:YES filterPredicate:nil];
+        groupFetchOptions.filterPredicate = fetchOptions.filterPredicate;
+        groupFetchOptions.filter = fetchOptions.filter;
+        
+        __weak typeof(self) weak_self = self;
+        [self asynchronousFetchObjectsWithOptions:groupFetchOptions
+        success:^(NSArray *results)
+         {
+             if(success_block)
+                 success_block([weak_self groupsForObjects:results propertyName:propertyName]);
+         }
+        failure:failure_block noConnection:noConnection_block];
+        
+        return;
+    }
+    
+    NSArray *groups = [self fetchGroupsForPropertyName:propertyName withOptions:fetchOptions];
+    if(!groups)
+    {
+        if(failure_block)
+            failure_block(nil);
+    }
+    else
+    {
+        if(success_block)
+            success_block(groups);
+    }
+}
+
+- (void)cancelAsynchronousFetchWithOptions:(SCDataFetchOptions *)fetchOptions
+{
+    // Should be implemented by subclasses that are able to cancel their fetches
+}
+
 - (void)fetchObjectsSuccessful:(NSArray *)objects successBlock:(SCDataStoreFetchSuccess_Block)success_block failure:(SCDataStoreFailure_Block)failure_block
 {
+    [self clearDirtyPropertyNamesForFetchedObjects:objects];
+    
     if(self.postAsynchronousFetchObjectsAction)
     {
         self.postAsynchronousFetchObjectsAction(objects, ^(NSArray *updatedObjects, NSError *error)
@@ -371,6 +1099,211 @@ separateValuesUsingDelimiter:(NSString *)delimiter
     }
 }
 
+- (NSMutableDictionary *)changesFromObjects:(NSArray *)previousObjects toObjects:(NSArray *)objects mergedObjects:(NSArray **)mergedObjectsPtr
+{
+    // key the previous objects by id (or by value when the store has no object ids), so each object is matched in constant time
+    NSMutableDictionary *previousObjectsById = [NSMutableDictionary dictionaryWithCapacity:previousObjects.count];
+    NSCountedSet *previousObjectsWithoutId = [NSCountedSet set];
+    for(NSObject *object in previousObjects)
+    {
+        id objectId = [self objectIdForObject:object];
+        if(objectId)
+            [previousObjectsById setObject:object forKey:objectId];
+        else
+            [previousObjectsWithoutId addObject:object];
+    }
+    
+    // keep the previous instances of the objects that haven't changed, so that their rows aren't reloaded
+    NSMutableArray *mergedObjects = [NSMutableArray arrayWithCapacity:objects.count];
+    NSMutableArray *insertedObjects = [NSMutableArray array];
+    NSMutableArray *updatedObjects = [NSMutableArray array];
+    for(NSObject *object in objects)
+    {
+        NSObject *previousObject;
+        id objectId = [self objectIdForObject:object];
+        if(objectId)
+        {
+            previousObject = [previousObjectsById objectForKey:objectId];
+            if(previousObject)
+                [previousObjectsById removeObjectForKey:objectId];
+        }
+        else
+        {
+            previousObject = [previousObjectsWithoutId member:object];
+            if(previousObject)
+                [previousObjectsWithoutId removeObject:previousObject];
+        }
+        
+        if(!previousObject)
+        {
+            [insertedObjects addObject:object];
+            [mergedObjects addObject:object];
+        }
+        else
+            if([self object:object isUnchangedFromObject:previousObject])
+            {
+                [mergedObjects addObject:previousObject];
+            }
+            else
+            {
+                [updatedObjects addObject:object];
+                [mergedObjects addObject:object];
+            }
+    }
+    
+    NSHashTable *mergedObjectsSet = [NSHashTable hashTableWithOptions:NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality];
+    for(NSObject *object in mergedObjects)
+        [mergedObjectsSet addObject:object];
+    NSMutableArray *deletedObjects = [NSMutableArray array];
+    NSMapTable *keptObjectIndexes = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality valueOptions:NSPointerFunctionsStrongMemory];
+    for(NSObject *object in previousObjects)
+    {
+        if([mergedObjectsSet containsObject:object])
+            [keptObjectIndexes setObject:[NSNumber numberWithUnsignedInteger:keptObjectIndexes.count] forKey:object];
+        else
+            [deletedObjects addObject:object];
+    }
+    
+    // the kept objects in their new order
+    NSMutableArray *keptObjects = [NSMutableArray arrayWithCapacity:keptObjectIndexes.count];
+    for(NSObject *object in mergedObjects)
+    {
+        if([keptObjectIndexes objectForKey:object])
+            [keptObjects addObject:object];
+    }
+    
+    // the longest run of kept objects that are still in their previous relative order stays in place, so only the others are moved
+    NSUInteger keptCount = keptObjects.count;
+    NSMutableArray *movedObjects = [NSMutableArray array];
+    if(keptCount)
+    {
+        NSUInteger *previousIndexes = malloc(keptCount * sizeof(NSUInteger));
+        NSUInteger *tailPositions = malloc(keptCount * sizeof(NSUInteger));    // position of the smallest tail of each subsequence length
+        NSUInteger *predecessors = malloc(keptCount * sizeof(NSUInteger));
+        NSUInteger length = 0;
+        for(NSUInteger i=0; i<keptCount; i++)
+        {
+            previousIndexes[i] = [[keptObjectIndexes objectForKey:[keptObjects objectAtIndex:i]] unsignedIntegerValue];
+            
+            NSUInteger low = 0, high = length;
+            while(low < high)
+            {
+                NSUInteger middle = (low+high)/2;
+                if(previousIndexes[tailPositions[middle]] < previousIndexes[i])
+                    low = middle+1;
+                else
+                    high = middle;
+            }
+            predecessors[i] = low ? tailPositions[low-1] : NSNotFound;
+            tailPositions[low] = i;
+            if(low == length)
+                length++;
+        }
+        
+        BOOL *staysInPlace = calloc(keptCount, sizeof(BOOL));
+        for(NSUInteger i=tailPositions[length-1]; i!=NSNotFound; i=predecessors[i])
+            staysInPlace[i] = TRUE;
+        for(NSUInteger i=0; i<keptCount; i++)
+        {
+            if(!staysInPlace[i])
+                [movedObjects addObject:[keptObjects objectAtIndex:i]];
+        }
+        
+        free(staysInPlace);
+        free(predecessors);
+        free(tailPositions);
+        free(previousIndexes);
+    }
+    
+    if(mergedObjectsPtr)
+        *mergedObjectsPtr = mergedObjects;
+    if(!insertedObjects.count && !updatedObjects.count && !deletedObjects.count && !movedObjects.count)
+        return nil;
+    
+    return [NSMutableDictionary dictionaryWithObjectsAndKeys:insertedObjects, SCDataStoreInsertedObjectsKey, updatedObjects, SCDataStoreUpdatedObjectsKey, deletedObjects, SCDataStoreDeletedObjectsKey, movedObjects, SCDataStoreMovedObjectsKey, mergedObjects, SCDataStoreFetchedObjectsKey, nil];
+}
+
+- (NSArray *)postChangesFromObjects:(NSArray *)previousObjects toObjects:(NSArray *)objects fetchOptions:(SCDataFetchOptions *)fetchOptions
+{
+    return [self postChangesFromObjects:previousObjects toObjects:objects fetchOptions:fetchOptions beforePosting:nil];
+}
+
+- (NSArray *)postChangesFromObjects:(NSArray *)previousObjects toObjects:(NSArray *)objects fetchOptions:(SCDataFetchOptions *)fetchOptions beforePosting:(void (^)(NSArray *mergedObjects))before_block
+{
+    NSArray *mergedObjects = nil;
+    NSMutableDictionary *userInfo = [self changesFromObjects:previousObjects toObjects:objects mergedObjects:&mergedObjects];
+    if(before_block)
+        before_block(mergedObjects);
+    if(!userInfo)
+        return mergedObjects;
+    
+    if(fetchOptions.batchSize)
+    {
+        // without the position of the batch, sections can only apply the changes to their items
+        [userInfo removeObjectForKey:SCDataStoreFetchedObjectsKey];
+        [userInfo removeObjectForKey:SCDataStoreMovedObjectsKey];
+    }
+    else
+        if(fetchOptions)
+        {
+            // the complete results are known, so sections can also apply their new order
+            [userInfo setObject:fetchOptions forKey:SCDataStoreFetchOptionsKey];
+        }
+    [[NSNotificationCenter defaultCenter] postNotificationName:SCDataStoreDidChangeObjectsNotification object:self userInfo:userInfo];
+    
+    return mergedObjects;
+}
+
+- (NSArray *)postChangesFromBatchObjects:(NSArray *)previousObjects toObjects:(NSArray *)objects batchStartIndex:(NSUInteger)startIndex fetchOptions:(SCDataFetchOptions *)fetchOptions
+{
+    NSArray *mergedObjects = nil;
+    NSMutableDictionary *userInfo = [self changesFromObjects:previousObjects toObjects:objects mergedObjects:&mergedObjects];
+    if(!userInfo || !fetchOptions)
+        return mergedObjects;
+    
+    // objects missing from the batch may have only moved to another batch, so sections replace the whole batch rather than deleting them
+    [userInfo setObject:fetchOptions forKey:SCDataStoreFetchOptionsKey];
+    [userInfo setObject:[NSNumber numberWithUnsignedInteger:startIndex] forKey:SCDataStoreBatchStartIndexKey];
+    [[NSNotificationCenter defaultCenter] postNotificationName:SCDataStoreDidChangeObjectsNotification object:self userInfo:userInfo];
+    
+    return mergedObjects;
+}
+
++ (void)applyFetchedObjectsInChanges:(NSDictionary *)changes toItems:(NSMutableArray *)items
+{
+    NSArray *fetchedObjects = [changes valueForKey:SCDataStoreFetchedObjectsKey];
+    NSIndexSet *removedIndexes = [changes valueForKey:SCDataStoreRemovedIndexesKey];
+    NSIndexSet *addedIndexes = [changes valueForKey:SCDataStoreAddedIndexesKey];
+    
+    // the indexes only apply if items are exactly the previous results
+    BOOL itemsArePreviousResults = (removedIndexes && addedIndexes && (!removedIndexes.count || removedIndexes.lastIndex<items.count) && items.count-removedIndexes.count+addedIndexes.count==fetchedObjects.count);
+    if(itemsArePreviousResults && removedIndexes.count)
+    {
+        // the removed items must be the very deleted and moved objects, which checks items without going through (and faulting in) all of the fetched objects
+        NSHashTable *removedObjects = [NSHashTable hashTableWithOptions:NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality];
+        for(NSObject *object in [changes valueForKey:SCDataStoreDeletedObjectsKey])
+            [removedObjects addObject:object];
+        for(NSObject *object in [changes valueForKey:SCDataStoreMovedObjectsKey])
+            [removedObjects addObject:object];
+        
+        itemsArePreviousResults = (removedObjects.count == removedIndexes.count);
+        NSUInteger index = removedIndexes.firstIndex;
+        while(itemsArePreviousResults && index!=NSNotFound)
+        {
+            itemsArePreviousResults = [removedObjects containsObject:[items objectAtIndex:index]];
+            index = [removedIndexes indexGreaterThanIndex:index];
+        }
+    }
+    if(itemsArePreviousResults)
+    {
+        [items removeObjectsAtIndexes:removedIndexes];
+        [items insertObjects:[fetchedObjects objectsAtIndexes:addedIndexes] atIndexes:addedIndexes];
+        return;
+    }
+    
+    [items setArray:fetchedObjects];
+}
+
 - (void)commitData
 {
     // Does nothing. Should be overridden by subclasses where applicable.
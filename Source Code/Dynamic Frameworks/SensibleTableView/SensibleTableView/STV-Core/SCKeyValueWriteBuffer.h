@@ -0,0 +1,67 @@
+/*
+ *  SCKeyValueWriteBuffer.h
+ *  Sensible TableView
+ *  Version: 5.4.0
+ *
+ *
+ *	THIS SOURCE CODE AND ANY ACCOMPANYING DOCUMENTATION ARE PROTECTED BY UNITED STATES
+ *	INTELLECTUAL PROPERTY LAW AND INTERNATIONAL TREATIES. UNAUTHORIZED REPRODUCTION OR
+ *	DISTRIBUTION IS SUBJECT TO CIVIL AND CRIMINAL PENALTIES. YOU SHALL NOT DEVELOP NOR
+ *	MAKE AVAILABLE ANY WORK THAT COMPETES WITH A SENSIBLE COCOA PRODUCT DERIVED FROM THIS
+ *	SOURCE CODE. THIS SOURCE CODE MAY NOT BE RESOLD OR REDISTRIBUTED ON A STAND ALONE BASIS.
+ *
+ *	USAGE OF THIS SOURCE CODE IS BOUND BY THE LICENSE AGREEMENT PROVIDED WITH THE
+ *	DOWNLOADED PRODUCT.
+ *
+ *  Copyright 2011-2015 Sensible Cocoa. All rights reserved.
+ *
+ *
+ *	This notice may not be removed from this file.
+ *
+ */
+
+
+#import "SCGlobals.h"
+
+
+typedef BOOL(^SCKeyValueWriteBufferSynchronize_Block)(void);
+typedef void(^SCKeyValueWriteBufferFlushedAction_Block)(NSSet *propertyNames, BOOL succeeded);
+
+
+/****************************************************************************************/
+/*	class SCKeyValueWriteBuffer	*/
+/****************************************************************************************/
+/**
+ SCKeyValueWriteBuffer gathers the names of the properties written to a key-value storage (e.g. NSUserDefaults or NSUbiquitousKeyValueStore), then synchronizes the storage once for all of them on a serial background queue. Used by SCUserDefaultsStore and SCiCloudKeyValueStore.
+ 
+ Each write reschedules the synchronization, so it only happens after no property has been written for debounceInterval. When the application enters the background or terminates, the pending properties are synchronized and the buffer waits for synchronize to return.
+ 
+ @note The buffer only delays the synchronize call. The values themselves should be set on the storage as soon as they're written.
+ */
+@interface SCKeyValueWriteBuffer : NSObject
+
+/** Allocates and returns an initialized SCKeyValueWriteBuffer.
+ @param label The label of the buffer's background queue.
+ @param synchronizeBlock Called on the background queue to synchronize the storage. Returns the result of synchronize.
+ */
++ (instancetype)bufferWithLabel:(NSString *)label synchronizeBlock:(SCKeyValueWriteBufferSynchronize_Block)synchronizeBlock;
+
+/** Returns an initialized SCKeyValueWriteBuffer. See bufferWithLabel:synchronizeBlock: for parameter details. */
+- (instancetype)initWithLabel:(NSString *)label synchronizeBlock:(SCKeyValueWriteBufferSynchronize_Block)synchronizeBlock;
+
+/** The time interval that must pass without any writes before the pending properties are synchronized. Default: 0 (the pending properties are only synchronized when flush is called). */
+@property (nonatomic, readwrite) NSTimeInterval debounceInterval;
+
+/** Action gets called on the main thread each time the pending properties have been synchronized, with their names and the result of synchronize. */
+@property (nonatomic, copy) SCKeyValueWriteBufferFlushedAction_Block flushedAction;
+
+/** Records a write to propertyName and reschedules the synchronization. Should be called on the main thread. */
+- (void)addWriteForPropertyName:(NSString *)propertyName;
+
+/** Synchronizes all the pending properties in the background without waiting for the debounce interval. */
+- (void)flush;
+
+/** Synchronizes all the pending properties and waits for synchronize to return. */
+- (void)flushAndWait;
+
+@end
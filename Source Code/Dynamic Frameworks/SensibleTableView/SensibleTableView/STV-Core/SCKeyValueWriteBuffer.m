@@ -0,0 +1,123 @@
+/*
+ *  SCKeyValueWriteBuffer.m
+ *  Sensible TableView
+ *  Version: 5.4.0
+ *
+ *
+ *	THIS SOURCE CODE AND ANY ACCOMPANYING DOCUMENTATION ARE PROTECTED BY UNITED STATES
+ *	INTELLECTUAL PROPERTY LAW AND INTERNATIONAL TREATIES. UNAUTHORIZED REPRODUCTION OR
+ *	DISTRIBUTION IS SUBJECT TO CIVIL AND CRIMINAL PENALTIES. YOU SHALL NOT DEVELOP NOR
+ *	MAKE AVAILABLE ANY WORK THAT COMPETES WITH A SENSIBLE COCOA PRODUCT DERIVED FROM THIS
+ *	SOURCE CODE. THIS SOURCE CODE MAY NOT BE RESOLD OR REDISTRIBUTED ON A STAND ALONE BASIS.
+ *
+ *	USAGE OF THIS SOURCE CODE IS BOUND BY THE LICENSE AGREEMENT PROVIDED WITH THE
+ *	DOWNLOADED PRODUCT.
+ *
+ *  Copyright 2011-2015 Sensible Cocoa. All rights reserved.
+ *
+ *
+ *	This notice may not be removed from this file.
+ *
+ */
+
+
+#import "SCKeyValueWriteBuffer.h"
+
+
+
+@interface SCKeyValueWriteBuffer ()
+{
+    NSMutableSet *_pendingPropertyNames;
+    dispatch_queue_t _writeQueue;
+    SCKeyValueWriteBufferSynchronize_Block _synchronizeBlock;
+}
+
+- (void)flushScheduledWrites;
+
+@end
+
+
+
+@implementation SCKeyValueWriteBuffer
+
++ (instancetype)bufferWithLabel:(NSString *)label synchronizeBlock:(SCKeyValueWriteBufferSynchronize_Block)synchronizeBlock
+{
+    return [[[self class] alloc] initWithLabel:label synchronizeBlock:synchronizeBlock];
+}
+
+- (instancetype)initWithLabel:(NSString *)label synchronizeBlock:(SCKeyValueWriteBufferSynchronize_Block)synchronizeBlock
+{
+    if( (self = [super init]) )
+    {
+        _debounceInterval = 0;
+        _flushedAction = nil;
+        _pendingPropertyNames = [[NSMutableSet alloc] init];
+        _writeQueue = dispatch_queue_create([label UTF8String], DISPATCH_QUEUE_SERIAL);
+        _synchronizeBlock = [synchronizeBlock copy];
+        
+        // flush only starts synchronizing, so make sure it finishes before the app is suspended
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(flushAndWait) name:UIApplicationDidEnterBackgroundNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(flushAndWait) name:UIApplicationWillTerminateNotification object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    [NSObject cancelPreviousPerformRequestsWithTarget:self];
+}
+
+- (void)addWriteForPropertyName:(NSString *)propertyName
+{
+    if(!propertyName)
+        return;
+    
+    [_pendingPropertyNames addObject:propertyName];
+    
+    if(self.debounceInterval > 0)
+    {
+        // every write restarts the interval, so a burst of writes is synchronized once it settles
+        [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(flushScheduledWrites) object:nil];
+        [self performSelector:@selector(flushScheduledWrites) withObject:nil afterDelay:self.debounceInterval];
+    }
+}
+
+- (void)flushScheduledWrites
+{
+    [self flush];
+}
+
+- (void)flush
+{
+    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(flushScheduledWrites) object:nil];
+    
+    if(!_pendingPropertyNames.count || !_synchronizeBlock)
+        return;
+    
+    NSSet *propertyNames = [_pendingPropertyNames copy];
+    [_pendingPropertyNames removeAllObjects];
+    
+    // synchronize may do disk or network I/O, so keep it off the main thread
+    SCKeyValueWriteBufferSynchronize_Block synchronizeBlock = _synchronizeBlock;
+    __weak typeof(self) weak_self = self;
+    dispatch_async(_writeQueue, ^
+    {
+        BOOL succeeded = synchronizeBlock();
+        
+        dispatch_async(dispatch_get_main_queue(), ^
+        {
+            if(weak_self.flushedAction)
+                weak_self.flushedAction(propertyNames, succeeded);
+        });
+    });
+}
+
+- (void)flushAndWait
+{
+    [self flush];
+    
+    dispatch_sync(_writeQueue, ^{});
+}
+
+@end
@@ -39,6 +39,7 @@ typedef void(^SCDidFetchModelItemsAction_Block)(SCArrayOfItemsModel *itemsModel,
 typedef NSString*(^SCSectionHeaderTitleForItemAction_Block)(SCArrayOfItemsModel *itemsModel, NSObject *item, NSUInteger itemIndex);
 typedef NSArray*(^SCSectionHeaderTitlesAction_Block)(SCArrayOfItemsModel *itemsModel);
 typedef NSArray*(^SCDidComputeSearchResultsAction_Block)(SCArrayOfItemsModel *itemsModel, NSString *searchText, NSArray *searchResults);
+typedef void(^SCModelCommitFailedAction_Block)(SCArrayOfItemsModel *itemsModel, NSError *error);
 typedef void(^SCDidMoveCellAction_Block)(SCTableViewModel *tableModel, SCTableViewCell *cell, NSIndexPath *fromIndexPath, NSIndexPath *toIndexPath);
 
 
@@ -514,6 +515,30 @@ typedef void(^SCDidMoveCellAction_Block)(SCTableViewModel *tableModel, SCTableVi
  */
 @property (nonatomic, copy) SCDidComputeSearchResultsAction_Block didComputeSearchResults;
 
+/** Action gets called if the data store of SCArrayOfItemsModel fails to commit its data (e.g. when a Core Data save fails validation).
+ 
+ This action is typically used to inform the user and roll back the unsaved changes.
+ 
+ Example:
+ 
+    // Objective-C
+    modelActions.commitToStoreFailed = ^(SCArrayOfItemsModel *itemsModel, NSError *error)
+    {
+        NSLog(@"Failed saving model items with error: %@", error);
+        [managedObjectContext rollback];
+    };
+ 
+    // Swift
+    modelActions.commitToStoreFailed =
+    {
+        (itemsModel, error) in
+ 
+        NSLog("Failed saving model items with error: %@", error)
+        managedObjectContext.rollback()
+    }
+ */
+@property (nonatomic, copy) SCModelCommitFailedAction_Block commitToStoreFailed;
+
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
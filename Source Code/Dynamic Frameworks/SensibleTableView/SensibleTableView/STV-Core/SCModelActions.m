@@ -89,6 +89,8 @@
     
     if((override || !self.didComputeSearchResults) && actions.didComputeSearchResults)
         self.didComputeSearchResults = actions.didComputeSearchResults;
+    if((override || !self.commitToStoreFailed) && actions.commitToStoreFailed)
+        self.commitToStoreFailed = actions.commitToStoreFailed;
 }
 
 
@@ -51,6 +51,7 @@ typedef BOOL(^SCSectionItemDeleteNoConnectionAction_Block)(SCArrayOfItemsSection
 typedef void(^SCSectionItemDeleteFailedAction_Block)(SCArrayOfItemsSection *itemsSection, NSObject *item, NSError *error);
 typedef void(^SCSectionItemDidDeleteAction_Block)(SCArrayOfItemsSection *itemsSection, NSIndexPath *indexPath);
 typedef void(^SCDidAddSpecialCellsAction_Block)(SCArrayOfItemsSection *itemsSection, NSMutableArray *items);
+typedef void(^SCSectionCommitFailedAction_Block)(SCArrayOfItemsSection *itemsSection, NSError *error);
 
 typedef UIViewController*(^SCDetailViewControllerForRowAtIndexPathAction_Block)(SCTableViewSection *section, NSIndexPath *indexPath);
 typedef SCTableViewModel*(^SCDetailTableViewModelForRowAtIndexPathAction_Block)(SCTableViewSection *section, NSIndexPath *indexPath);
@@ -669,6 +670,33 @@ typedef CGFloat(^SCCustomHeightForRowAtIndexPathAction_Block)(SCArrayOfItemsSect
  */
 @property (nonatomic, copy) SCFetchSectionItemsFailedAction_Block fetchItemsFromStoreFailed;
 
+/** Action gets called if the section's data store fails to commit its data (e.g. when a Core Data save fails validation).
+ 
+ This action is typically used to inform the user and roll back the unsaved changes.
+ 
+ Example:
+ 
+    // Objective-C
+    sectionActions.commitToStoreFailed = ^(SCArrayOfItemsSection *itemsSection, NSError *error)
+    {
+        NSLog(@"Failed saving section items with error: %@", error);
+        [managedObjectContext rollback];
+    };
+ 
+    // Swift
+    sectionActions.commitToStoreFailed =
+    {
+        (itemsSection, error) in
+ 
+        NSLog("Failed saving section items with error: %@", error)
+        managedObjectContext.rollback()
+    }
+ 
+ @note This action is only applicable to SCArrayOfItemsSection subclasses, such as SCArrayOfObjectsSection. Sections generated by SCArrayOfItemsModel don't call this action, as their model calls [SCModelActions commitToStoreFailed] instead.
+ 
+ */
+@property (nonatomic, copy) SCSectionCommitFailedAction_Block commitToStoreFailed;
+
 /** Action gets called as soon as the section has created a new item to be used in its add new item detail view (which usually apprears right after the user taps the section's Add button).
  
  This action is typically used to customize the newly created item before the new item detail view is displayed.
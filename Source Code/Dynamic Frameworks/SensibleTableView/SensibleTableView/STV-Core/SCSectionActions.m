@@ -72,6 +72,8 @@
         self.didFetchItemsFromStore = actions.didFetchItemsFromStore;
     if((override || !self.fetchItemsFromStoreFailed) && actions.fetchItemsFromStoreFailed)
         self.fetchItemsFromStoreFailed = actions.fetchItemsFromStoreFailed;
+    if((override || !self.commitToStoreFailed) && actions.commitToStoreFailed)
+        self.commitToStoreFailed = actions.commitToStoreFailed;
     if((override || !self.didAddSpecialCells) && actions.didAddSpecialCells)
         self.didAddSpecialCells = actions.didAddSpecialCells;
     
@@ -5014,7 +5014,7 @@
         switch (self.selectionItemsStore.storeMode)
         {
             case SCStoreModeSynchronous:
-                items = [self.selectionItemsStore fetchObjectsWithOptions:self.selectionItemsFetchOptions];
+                items = [self.selectionItemsStore fetchSharedObjectsWithOptions:self.selectionItemsFetchOptions forConsumer:self];
                 itemsInSync = TRUE;
                 break;
                 
@@ -5076,6 +5076,7 @@
 
 - (void)setSelectionItemsStore:(SCDataStore *)store
 {
+    [selectionItemsStore releaseSharedFetchResultsForConsumer:self];
     selectionItemsStore = store;
     
     selectionItemsFetchOptions = [store.defaultDataDefinition generateCompatibleDataFetchOptions];
@@ -6274,7 +6275,10 @@
 - (void)bindDataStoreToBoundObject
 {
     if(self.boundObject && self.boundObjectStore && self.boundPropertyName && self.dataStore)
+    {
+        self.dataStore.boundObjectStore = self.boundObjectStore;
         [self.dataStore bindStoreToPropertyName:self.boundPropertyName forObject:self.boundObject withDefinition:[self.boundObjectStore definitionForObject:self.boundObject]];
+    }
 }
 
 
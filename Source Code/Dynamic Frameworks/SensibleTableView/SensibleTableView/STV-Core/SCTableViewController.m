@@ -583,6 +583,7 @@
                     
                     if(self.tableViewModel.masterBoundObject && [masterBoundPropertyName length])
                     {
+                        dataStore.boundObjectStore = self.tableViewModel.masterBoundObjectStore;
                         [dataStore bindStoreToPropertyName:masterBoundPropertyName forObject:self.tableViewModel.masterBoundObject withDefinition:[self.tableViewModel.masterBoundObjectStore definitionForObject:self.tableViewModel.masterBoundObject]];
                     }
                     else
@@ -469,6 +469,9 @@
 /** Warning: Method must only be called internally by the framework. */
 - (void)clearLastReturnedCellData;
 
+/** Warning: Method must only be called internally by the framework. Animates the rows of consecutive sections, starting at firstSectionIndex, from their old items to their new items (both arrays of item arrays, one per section), matching the items by identity. Rows of updatedObjects are reloaded, and rows of movedObjects are moved. replacedItems maps old items to the new instances that replaced them in place, whose rows are reloaded rather than deleted and inserted. */
+- (void)updateRowsFromSectionItems:(NSArray *)oldSectionItems toSectionItems:(NSArray *)newSectionItems firstSectionIndex:(NSUInteger)firstSectionIndex updatedObjects:(NSArray *)updatedObjects movedObjects:(NSArray *)movedObjects replacedItems:(NSMapTable *)replacedItems;
+
 /** Warning: Method must only be called internally by the framework. */
 - (void)configureDetailModel:(SCTableViewModel *)detailModel;
 
@@ -604,6 +607,16 @@
 /** Set to FALSE to disable the section from automatically fetching its items from dataStore. Default: TRUE. */
 @property (nonatomic, readwrite) BOOL autoFetchItems;
 
+/** 
+ The name of the property that the model's items are grouped by. When set, the model only asks dataStore for the distinct values of the property along with their number of items, and generates a section for each group. Each section then fetches its own items using dataFetchOptions narrowed down to its group, only once it gets displayed (see collapsesGroupSections). Default: nil.
+ 
+ @note When set, groupByPropertyName takes precedence over the sectionHeaderTitleForItem model action.
+ */
+@property (nonatomic, copy) NSString *groupByPropertyName;
+
+/** When TRUE, the sections generated for groupByPropertyName are initially collapsed using an SCExpandCollapseCell, so that no group's items are fetched before the user expands its section. Default: TRUE. */
+@property (nonatomic, readwrite) BOOL collapsesGroupSections;
+
 /** The accessory type of the generated cells. */
 @property (nonatomic, readwrite) UITableViewCellAccessoryType itemsAccessoryType;
 
@@ -754,7 +767,12 @@
  */
 @interface SCArrayOfObjectsModel : SCArrayOfItemsModel
 {
+    //internal
+    SCDataFetchOptions *_searchFetchOptions;
+    NSString *_searchString;
+    
 	NSString *searchPropertyName;
+    BOOL searchesDataStore;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -798,6 +816,16 @@
  */
 @property (nonatomic, copy) NSString *searchPropertyName;
 
+/** 
+ Set to TRUE to have the search terms typed in the model's search bar searched by the data store, instead of filtering the items that are already loaded. This lets the store search without loading all of its objects (e.g. using a Core Data fetch or a Parse query), and is required to search large remote data sets. Default: FALSE.
+ 
+ @note Only the string properties among the search properties are searched by the data store. When dataFetchOptions.batchSize is set, search results are fetched in batches of the same size, call fetchNextSearchResultsBatch to fetch more results. Leave this property FALSE to filter only the items that are already loaded.
+ */
+@property (nonatomic, readwrite) BOOL searchesDataStore;
+
+/** Fetches the next batch of search results from the data store and appends it to the displayed results. Has no effect unless a data store search is active and dataFetchOptions.batchSize is set. */
+- (void)fetchNextSearchResultsBatch;
+
 @end
 
 
@@ -377,6 +377,87 @@
     }
 }
 
+- (void)updateRowsFromSectionItems:(NSArray *)oldSectionItems toSectionItems:(NSArray *)newSectionItems firstSectionIndex:(NSUInteger)firstSectionIndex updatedObjects:(NSArray *)updatedObjects movedObjects:(NSArray *)movedObjects replacedItems:(NSMapTable *)replacedItems
+{
+    NSHashTable *updatedObjectsSet = [NSHashTable hashTableWithOptions:NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality];
+    NSHashTable *movedObjectsSet = [NSHashTable hashTableWithOptions:NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality];
+    NSHashTable *replacingItemsSet = [NSHashTable hashTableWithOptions:NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality];
+    for(NSObject *object in updatedObjects)
+        [updatedObjectsSet addObject:object];
+    for(NSObject *object in movedObjects)
+        [movedObjectsSet addObject:object];
+    for(NSObject *item in [replacedItems objectEnumerator])
+        [replacingItemsSet addObject:item];
+    
+    NSMutableArray *deleteIndexPaths = [NSMutableArray array];
+    NSMutableArray *insertIndexPaths = [NSMutableArray array];
+    NSMutableArray *reloadIndexPaths = [NSMutableArray array];
+    NSMutableArray *moveFromIndexPaths = [NSMutableArray array];
+    NSMutableArray *moveToIndexPaths = [NSMutableArray array];
+    NSMutableArray *movedAndUpdatedIndexPaths = [NSMutableArray array];
+    for(NSUInteger i=0; i<oldSectionItems.count && i<newSectionItems.count; i++)
+    {
+        NSUInteger sectionIndex = firstSectionIndex + i;
+        NSArray *oldItems = [oldSectionItems objectAtIndex:i];
+        NSArray *newItems = [newSectionItems objectAtIndex:i];
+        
+        // the rows of the items, so that each item is looked up in constant time
+        NSMapTable *oldRows = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality valueOptions:NSPointerFunctionsStrongMemory];
+        NSMapTable *newRows = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality valueOptions:NSPointerFunctionsStrongMemory];
+        for(NSUInteger row=0; row<oldItems.count; row++)
+            [oldRows setObject:[NSNumber numberWithUnsignedInteger:row] forKey:[oldItems objectAtIndex:row]];
+        for(NSUInteger row=0; row<newItems.count; row++)
+            [newRows setObject:[NSNumber numberWithUnsignedInteger:row] forKey:[newItems objectAtIndex:row]];
+        
+        for(NSUInteger row=0; row<oldItems.count; row++)
+        {
+            NSObject *item = [oldItems objectAtIndex:row];
+            NSObject *replacingItem = [replacedItems objectForKey:item];
+            NSIndexPath *indexPath = [NSIndexPath indexPathForRow:row inSection:sectionIndex];
+            if(![newRows objectForKey:(replacingItem ? replacingItem : item)])
+                [deleteIndexPaths addObject:indexPath];
+            else if(replacingItem || ([updatedObjectsSet containsObject:item] && ![movedObjectsSet containsObject:item]))
+                [reloadIndexPaths addObject:indexPath];
+        }
+        for(NSUInteger row=0; row<newItems.count; row++)
+        {
+            NSObject *item = [newItems objectAtIndex:row];
+            NSIndexPath *indexPath = [NSIndexPath indexPathForRow:row inSection:sectionIndex];
+            NSNumber *oldRow = [oldRows objectForKey:item];
+            if(!oldRow)
+            {
+                if(![replacingItemsSet containsObject:item])
+                    [insertIndexPaths addObject:indexPath];
+            }
+            else if([movedObjectsSet containsObject:item])
+            {
+                [moveFromIndexPaths addObject:[NSIndexPath indexPathForRow:[oldRow unsignedIntegerValue] inSection:sectionIndex]];
+                [moveToIndexPaths addObject:indexPath];
+                // a row can't be both moved and reloaded in the same update
+                if([updatedObjectsSet containsObject:item])
+                    [movedAndUpdatedIndexPaths addObject:indexPath];
+            }
+        }
+    }
+    
+    [self clearLastReturnedCellData];
+    
+    UITableView *tableView = self.tableView;
+    [tableView beginUpdates];
+    if(deleteIndexPaths.count)
+        [tableView deleteRowsAtIndexPaths:deleteIndexPaths withRowAnimation:UITableViewRowAnimationAutomatic];
+    if(insertIndexPaths.count)
+        [tableView insertRowsAtIndexPaths:insertIndexPaths withRowAnimation:UITableViewRowAnimationAutomatic];
+    if(reloadIndexPaths.count)
+        [tableView reloadRowsAtIndexPaths:reloadIndexPaths withRowAnimation:UITableViewRowAnimationNone];
+    for(NSUInteger i=0; i<moveFromIndexPaths.count; i++)
+        [tableView moveRowAtIndexPath:[moveFromIndexPaths objectAtIndex:i] toIndexPath:[moveToIndexPaths objectAtIndex:i]];
+    [tableView endUpdates];
+    
+    if(movedAndUpdatedIndexPaths.count)
+        [tableView reloadRowsAtIndexPaths:movedAndUpdatedIndexPaths withRowAnimation:UITableViewRowAnimationNone];
+}
+
 - (void)configureDetailModel:(SCTableViewModel *)detailModel
 {
     detailModel.masterModel = self;
@@ -894,6 +975,7 @@
                 }
                 
                 SCDataDefinition *boundObjDef = [store definitionForObject:boundObj];
+                objectsStore.boundObjectStore = store;
                 [objectsStore bindStoreToPropertyName:propertyDef.name forObject:boundObj withDefinition:boundObjDef];
             }
             
@@ -2296,6 +2378,7 @@
 @interface SCArrayOfItemsModel ()
 {
     NSMutableDictionary *_sectionsCellIdentifiers;
+    NSObject *_groupsFetchToken;
 }
 
 #if __IPHONE_OS_VERSION_MIN_REQUIRED >= __IPHONE_8_0
@@ -2307,11 +2390,17 @@
 #endif
 
 - (void)generateSections;
+- (void)generateGroupSections;
+- (void)addSectionsForGroups:(NSArray *)groups;
+- (void)regenerateGroupSections;
 - (NSArray *)getSectionHeaderTitles;
 - (NSString *)getHeaderTitleForItemAtIndex:(NSUInteger)index;
 
 - (void)addNewItemToRespectiveSection:(NSObject *)newItem;
 
+- (void)dataStoreDidChangeObjects:(NSNotification *)notification;
+- (void)dataStoreDidFailCommit:(NSNotification *)notification;
+
 - (NSString *)safeSearchStringFromString:(NSString *)searchString;
 
 @end
@@ -2348,6 +2437,9 @@
         items = nil;
         autoFetchItems = TRUE;
         itemsInSync = FALSE;
+        _groupByPropertyName = nil;
+        _collapsesGroupSections = TRUE;
+        _groupsFetchToken = nil;
 		itemsAccessoryType = UITableViewCellAccessoryDisclosureIndicator;
 		allowAddingItems = TRUE;
 		allowDeletingItems = TRUE;
@@ -2380,6 +2472,11 @@
 	return self;
 }
 
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
 
 // overrides superclass
 - (UITableView *)tableView
@@ -2396,8 +2493,16 @@
 
 - (void)setDataStore:(SCDataStore *)__dataStore
 {
+    [[NSNotificationCenter defaultCenter] removeObserver:self name:SCDataStoreDidChangeObjectsNotification object:dataStore];
+    [[NSNotificationCenter defaultCenter] removeObserver:self name:SCDataStoreDidFailCommitNotification object:dataStore];
+    [dataStore releaseSharedFetchResultsForConsumer:self];
+    
     dataStore =  __dataStore;
     
+    // Register with store notifications
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(dataStoreDidChangeObjects:) name:SCDataStoreDidChangeObjectsNotification object:dataStore];
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(dataStoreDidFailCommit:) name:SCDataStoreDidFailCommitNotification object:dataStore];
+    
     if(!dataFetchOptions)
         dataFetchOptions = [__dataStore.defaultDataDefinition generateCompatibleDataFetchOptions];
     
@@ -2418,6 +2523,13 @@
     sectionsInSync = FALSE;
 }
 
+- (void)setGroupByPropertyName:(NSString *)propertyName
+{
+    _groupByPropertyName = [propertyName copy];
+    
+    sectionsInSync = FALSE;
+}
+
 - (SCDetailViewControllerOptions *)detailViewControllerOptions
 {
     // Conserve resources by lazy loading for only models that need it
@@ -2454,7 +2566,7 @@
         switch (self.dataStore.storeMode)
         {
             case SCStoreModeSynchronous:
-                items = [[NSMutableArray alloc] initWithArray:[self.dataStore fetchObjectsWithOptions:self.dataFetchOptions]];
+                items = [[NSMutableArray alloc] initWithArray:[self.dataStore fetchSharedObjectsWithOptions:self.dataFetchOptions forConsumer:self]];
                 itemsInSync = TRUE;
                 sectionsInSync = FALSE;
                 
@@ -2524,6 +2636,12 @@
 - (void)generateSections
 {
 	[self removeAllSections];
+    
+    if(self.groupByPropertyName && !filteredArray)
+    {
+        [self generateGroupSections];
+        return;
+    }
 	
 	NSArray *itemsArray;
 	if(filteredArray)
@@ -2581,6 +2699,185 @@
     sectionsInSync = TRUE;
 }
 
+// Generates a section for each group of groupByPropertyName without fetching any of the model's items
+- (void)generateGroupSections
+{
+    NSObject *groupsFetchToken = [[NSObject alloc] init];
+    _groupsFetchToken = groupsFetchToken;
+    
+    switch (self.dataStore.storeMode)
+    {
+        case SCStoreModeSynchronous:
+            [self addSectionsForGroups:[self.dataStore fetchGroupsForPropertyName:self.groupByPropertyName withOptions:self.dataFetchOptions]];
+            break;
+            
+        case SCStoreModeAsynchronous:
+        {
+            SCArrayOfItemsSection *loadingSection = [self createSectionWithHeaderTitle:nil];
+            SCFetchItemsCell *fetchItemsCell = [SCFetchItemsCell cell];
+            [fetchItemsCell startActivityIndicator];
+            [[loadingSection mutableItems] addObject:fetchItemsCell];
+            [self setPropertiesForSection:loadingSection];
+            [self addSection:loadingSection];
+            
+            _loadingContents = TRUE;
+            [self.dataStore asynchronousFetchGroupsForPropertyName:self.groupByPropertyName withOptions:self.dataFetchOptions
+            success:^(NSArray *groups)
+                 {
+                     // only the latest groups fetch gets delivered
+                     if(_groupsFetchToken != groupsFetchToken)
+                         return;
+                     
+                     _loadingContents = FALSE;
+                     
+                     [self clearLastReturnedCellData];
+                     [self removeAllSections];
+                     [self addSectionsForGroups:groups];
+                     [self.tableView reloadData];
+                 }
+            failure:^(NSError *error)
+                 {
+                     if(_groupsFetchToken == groupsFetchToken)
+                         _loadingContents = FALSE;
+                 }
+             noConnection:^BOOL()
+                {
+                    return NO;
+                }
+             ];
+        }
+            break;
+    }
+    
+    sectionsInSync = TRUE;
+}
+
+- (void)addSectionsForGroups:(NSArray *)groups
+{
+    NSPredicate *filterPredicate = nil;
+    if(self.dataFetchOptions.filter)
+        filterPredicate = self.dataFetchOptions.filterPredicate;
+    
+    for(NSUInteger i=0; i<groups.count; i++)
+    {
+        NSDictionary *group = [groups objectAtIndex:i];
+        NSObject *value = [group valueForKey:SCDataStoreGroupValueKey];
+        NSUInteger count = [[group valueForKey:SCDataStoreGroupCountKey] unsignedIntegerValue];
+        
+        NSString *headerTitle = nil;
+        if(value && ![value isKindOfClass:[NSNull class]])
+            headerTitle = [NSString stringWithFormat:@"%@", value];
+        
+        SCArrayOfItemsSection *section = [self createSectionWithHeaderTitle:headerTitle];
+        if(!section)
+            continue;
+        
+        NSString *stringIndex = [NSString stringWithFormat:@"%lu", (unsigned long)i];
+        NSString *sectionCellId = [_sectionsCellIdentifiers valueForKey:stringIndex];
+        if(!sectionCellId)
+        {
+            sectionCellId = [[[NSUUID UUID] UUIDString] copy];
+            [_sectionsCellIdentifiers setValue:sectionCellId forKey:stringIndex];
+        }
+        section.cellIdentifier = sectionCellId;
+        
+        [self setPropertiesForSection:section];
+        
+        // the section fetches (and pages) its own group's items once displayed
+        NSPredicate *groupPredicate = [self.dataStore groupPredicateForValue:value propertyName:self.groupByPropertyName];
+        if(filterPredicate)
+            groupPredicate = [NSCompoundPredicate andPredicateWithSubpredicates:[NSArray arrayWithObjects:filterPredicate, groupPredicate, nil]];
+        // copied so that store specific options (e.g. Core Data's orderAttributeName) are kept
+        SCDataFetchOptions *groupFetchOptions = self.dataFetchOptions ? [self.dataFetchOptions copy] : [self.dataStore.defaultDataDefinition generateCompatibleDataFetchOptions];
+        groupFetchOptions.filterPredicate = groupPredicate;
+        groupFetchOptions.filter = TRUE;
+        [groupFetchOptions resetBatchOffset];
+        section.dataFetchOptions = groupFetchOptions;
+        section.autoFetchItems = TRUE;
+        
+        if(self.collapsesGroupSections)
+        {
+            NSString *countText = [NSString stringWithFormat:NSLocalizedString(@"%lu items", @"Group items count text"), (unsigned long)count];
+            section.expandCollapseCell = [SCExpandCollapseCell cellWithExpandText:countText collapseText:countText ownerSectionExpanded:NO];
+        }
+        
+        [self addSection:section];
+    }
+}
+
+// Group counts and membership change with the items, so the groups are simply fetched again
+- (void)regenerateGroupSections
+{
+    [self clearLastReturnedCellData];
+    sectionsInSync = FALSE;
+    [self.tableView reloadData];
+}
+
+- (void)dataStoreDidFailCommit:(NSNotification *)notification
+{
+    if(self.modelActions.commitToStoreFailed)
+        self.modelActions.commitToStoreFailed(self, [notification.userInfo valueForKey:SCDataStoreErrorKey]);
+}
+
+- (void)dataStoreDidChangeObjects:(NSNotification *)notification
+{
+    if(!itemsInSync || !sectionsInSync || !self.autoFetchItems)
+        return;
+    
+    // only live fetch results can be applied to the whole model, as they determine the new items order
+    NSArray *fetchedObjects = [notification.userInfo valueForKey:SCDataStoreFetchedObjectsKey];
+    if(!fetchedObjects || [notification.userInfo valueForKey:SCDataStoreFetchOptionsKey]!=self.dataFetchOptions)
+        return;
+    
+    NSNumber *batchStartIndex = [notification.userInfo valueForKey:SCDataStoreBatchStartIndexKey];
+    if(batchStartIndex)
+    {
+        // only one batch of the results, which replaces the items previously fetched for it
+        NSUInteger startIndex = MIN([batchStartIndex unsignedIntegerValue], items.count);
+        NSUInteger length = MIN(self.dataFetchOptions.batchSize, items.count-startIndex);
+        [items replaceObjectsInRange:NSMakeRange(startIndex, length) withObjectsFromArray:fetchedObjects];
+    }
+    else
+    {
+        [SCDataStore applyFetchedObjectsInChanges:notification.userInfo toItems:items];
+    }
+    
+    if(filteredArray)
+    {
+        [self searchBar:self.searchBar textDidChange:self.searchBar.text];
+        return;
+    }
+    
+    NSMutableArray *oldSectionHeaderTitles = [NSMutableArray arrayWithCapacity:self.sectionCount];
+    NSMutableArray *oldSectionItems = [NSMutableArray arrayWithCapacity:self.sectionCount];
+    for(NSUInteger i=0; i<self.sectionCount; i++)
+    {
+        SCArrayOfItemsSection *section = (SCArrayOfItemsSection *)[self sectionAtIndex:i];
+        [oldSectionHeaderTitles addObject:section.headerTitle ? section.headerTitle : (NSObject *)[NSNull null]];
+        [oldSectionItems addObject:[NSArray arrayWithArray:section.items]];
+    }
+    
+    [self clearLastReturnedCellData];
+    [self generateSections];
+    
+    BOOL sectionsChanged = (self.sectionCount != oldSectionHeaderTitles.count);
+    for(NSUInteger i=0; i<self.sectionCount && !sectionsChanged; i++)
+    {
+        NSString *headerTitle = [self sectionAtIndex:i].headerTitle;
+        sectionsChanged = ![(headerTitle ? headerTitle : (NSObject *)[NSNull null]) isEqual:[oldSectionHeaderTitles objectAtIndex:i]];
+    }
+    if(sectionsChanged)
+    {
+        [self.tableView reloadData];
+        return;
+    }
+    
+    NSMutableArray *newSectionItems = [NSMutableArray arrayWithCapacity:self.sectionCount];
+    for(NSUInteger i=0; i<self.sectionCount; i++)
+        [newSectionItems addObject:[(SCArrayOfItemsSection *)[self sectionAtIndex:i] items]];
+    [self updateRowsFromSectionItems:oldSectionItems toSectionItems:newSectionItems firstSectionIndex:0 updatedObjects:[notification.userInfo valueForKey:SCDataStoreUpdatedObjectsKey] movedObjects:[notification.userInfo valueForKey:SCDataStoreMovedObjectsKey] replacedItems:nil];
+}
+
 - (NSArray *)getSectionHeaderTitles
 {
     NSArray *sectionHeaderTitles = nil;
@@ -2877,6 +3174,11 @@
         case SCStoreModeSynchronous:
             [self.dataStore insertObject:newItem];
             
+            if(self.groupByPropertyName && !filteredArray)
+            {
+                [self regenerateGroupSections];
+                break;
+            }
             [items addObject:newItem];
             [self addNewItemToRespectiveSection:newItem];
             break;
@@ -2885,6 +3187,11 @@
             [self.dataStore asynchronousInsertObject:newItem
                     success:^()
                     {
+                        if(self.groupByPropertyName && !filteredArray)
+                        {
+                            [self regenerateGroupSections];
+                            return;
+                        }
                         [items addObject:newItem];
                         [self addNewItemToRespectiveSection:newItem];
                     }
@@ -2932,6 +3239,26 @@
 {
     [self clearLastReturnedCellData];
     
+    if(self.groupByPropertyName && !filteredArray)
+    {
+        BOOL remainsInGroup = TRUE;
+        @try
+        {
+            remainsInGroup = [section.dataFetchOptions.filterPredicate evaluateWithObject:item];
+        }
+        @catch (NSException * e)
+        {
+            SCDebugLog(@"Warning: Invalid filter predicate: %@.", section.dataFetchOptions.filterPredicate);
+        }
+        
+        if(remainsInGroup)
+            [section itemModified:item];
+        else
+            [self regenerateGroupSections];
+        
+        return;
+    }
+    
 	NSUInteger oldSectionIndex = [self indexForSection:section];
 	NSUInteger newSectionIndex = [self getSectionIndexForItem:item];
 	
@@ -2986,6 +3313,10 @@
 
 - (void)itemRemoved:(NSObject *)item inSection:(SCArrayOfItemsSection *)section
 {
+    // group sections fetch their own items, which the model never loads
+    if(self.groupByPropertyName && !itemsInSync)
+        return;
+    
     [(NSMutableArray *)self.items removeObjectIdenticalTo:item];
 }
 
@@ -3116,6 +3447,7 @@
 @implementation SCArrayOfObjectsModel
 
 @synthesize searchPropertyName;
+@synthesize searchesDataStore;
 
 
 + (instancetype)modelWithTableView:(UITableView *)tableView
@@ -3131,6 +3463,10 @@
 	if( (self=[super init]) )
 	{
 		searchPropertyName = nil;
+        searchesDataStore = FALSE;
+        
+        _searchFetchOptions = nil;
+        _searchString = nil;
 	}
 	
 	return self;
@@ -3153,29 +3489,182 @@
 #pragma mark -
 #pragma mark UISearchBarDelegate methods
 
+- (NSArray *)searchPropertyNamesForDefinition:(SCDataDefinition *)objDef
+{
+    if(!self.searchPropertyName)
+        self.searchPropertyName = objDef.titlePropertyName;
+    
+    NSArray *searchProperties;
+    if([self.searchPropertyName isEqualToString:@"*"])
+    {
+        searchProperties = [NSMutableArray arrayWithCapacity:objDef.propertyDefinitionCount];
+        for(NSUInteger i=0; i<objDef.propertyDefinitionCount; i++)
+            [(NSMutableArray *)searchProperties addObject:[objDef propertyDefinitionAtIndex:i].name];
+    }
+    else
+    {
+        searchProperties = [self.searchPropertyName componentsSeparatedByString:@";"];
+    }
+    
+    return searchProperties;
+}
+
+- (NSArray *)dataStoreSearchPropertyNamesForDefinition:(SCDataDefinition *)objDef
+{
+    // stores match the search string using 'contains', which only string attributes support
+    NSArray *searchProperties = [self searchPropertyNamesForDefinition:objDef];
+    NSMutableArray *stringProperties = [NSMutableArray arrayWithCapacity:searchProperties.count];
+    for(NSString *propertyName in searchProperties)
+    {
+        SCPropertyDefinition *propertyDef = [objDef propertyDefinitionWithName:propertyName];
+        if(!propertyDef || propertyDef.dataType==SCDataTypeNSString)
+            [stringProperties addObject:propertyName];
+    }
+    
+    return stringProperties;
+}
+
+- (void)searchDataStoreForString:(NSString *)searchString
+{
+    SCDataDefinition *objDef;
+    if(self.items.count)
+        objDef = [self.dataStore definitionForObject:[self.items objectAtIndex:0]]; // any object
+    else
+        objDef = self.dataStore.defaultDataDefinition;
+    NSArray *searchProperties = [self dataStoreSearchPropertyNamesForDefinition:objDef];
+    
+    // every search string starts a new batched search with the model's sorting and filtering
+    if(_searchFetchOptions)
+        [self.dataStore cancelAsynchronousFetchWithOptions:_searchFetchOptions];
+    SCDataFetchOptions *searchFetchOptions = [self.dataStore.defaultDataDefinition generateCompatibleDataFetchOptions];
+    searchFetchOptions.sort = self.dataFetchOptions.sort;
+    searchFetchOptions.sortKey = self.dataFetchOptions.sortKey;
+    searchFetchOptions.sortAscending = self.dataFetchOptions.sortAscending;
+    searchFetchOptions.filter = self.dataFetchOptions.filter;
+    searchFetchOptions.filterPredicate = self.dataFetchOptions.filterPredicate;
+    searchFetchOptions.batchSize = self.dataFetchOptions.batchSize;
+    _searchFetchOptions = searchFetchOptions;
+    _searchString = [searchString copy];
+    
+    [self fetchSearchResultsForString:searchString propertyNames:searchProperties withOptions:searchFetchOptions appending:FALSE];
+}
+
+- (void)fetchNextSearchResultsBatch
+{
+    if(!_searchFetchOptions || !_searchFetchOptions.batchSize || !filteredArray)
+        return;
+    
+    SCDataDefinition *objDef = self.dataStore.defaultDataDefinition;
+    if(self.items.count)
+        objDef = [self.dataStore definitionForObject:[self.items objectAtIndex:0]];
+    
+    [self fetchSearchResultsForString:_searchString propertyNames:[self dataStoreSearchPropertyNamesForDefinition:objDef] withOptions:_searchFetchOptions appending:TRUE];
+}
+
+- (void)fetchSearchResultsForString:(NSString *)searchString propertyNames:(NSArray *)propertyNames withOptions:(SCDataFetchOptions *)searchFetchOptions appending:(BOOL)appending
+{
+    if(!propertyNames.count)
+    {
+        [self didFetchSearchResults:nil forString:searchString appending:appending];
+        return;
+    }
+    
+    @try
+    {
+        switch(self.dataStore.storeMode)
+        {
+            case SCStoreModeSynchronous:
+            {
+                NSArray *results = [self.dataStore searchObjectsForString:searchString propertyNames:propertyNames withOptions:searchFetchOptions];
+                [self didFetchSearchResults:results forString:searchString appending:appending];
+            }
+                break;
+                
+            case SCStoreModeAsynchronous:
+                [self.dataStore asynchronousSearchObjectsForString:searchString propertyNames:propertyNames withOptions:searchFetchOptions
+                success:^(NSArray *results)
+                 {
+                     // only the results of the latest search string get displayed
+                     if(_searchFetchOptions == searchFetchOptions)
+                         [self didFetchSearchResults:results forString:searchString appending:appending];
+                 }
+                failure:^(NSError *error)
+                 {
+                     SCDebugLog(@"Warning: Unable to search data store: %@", error);
+                 }
+                noConnection:^BOOL()
+                 {
+                     return NO;  // call failure_block
+                 }];
+                break;
+        }
+    }
+    @catch (NSException * e)
+    {
+        // handle any unexpected property-name behavior gracefully
+        SCDebugLog(@"Warning: Unable to search data store for properties: %@ (%@).", propertyNames, e);
+        
+        [self didFetchSearchResults:nil forString:searchString appending:appending];
+    }
+}
+
+- (void)didFetchSearchResults:(NSArray *)results forString:(NSString *)searchString appending:(BOOL)appending
+{
+    NSArray *resultsArray = results ? results : [NSArray array];
+    
+    // Check for custom results
+    NSArray *customResultsArray = nil;
+    if(self.modelActions.didComputeSearchResults)
+        customResultsArray = self.modelActions.didComputeSearchResults(self, searchString, resultsArray);
+    if(customResultsArray)
+        resultsArray = customResultsArray;
+    
+    if(appending && filteredArray)
+        resultsArray = [filteredArray arrayByAddingObjectsFromArray:resultsArray];
+    
+    filteredArray = resultsArray;
+    self.addButtonItem.enabled = !filteredArray;
+    
+    sectionsInSync = FALSE;
+    
+    [self.tableView reloadData];  // self.tableView automatically returns the correct tableView in case a UISearchController is action
+}
+
+// overrides superclass
+- (void)searchBarCancelButtonClicked:(UISearchBar *)sBar
+{
+    if(_searchFetchOptions)
+    {
+        [self.dataStore cancelAsynchronousFetchWithOptions:_searchFetchOptions];
+        _searchFetchOptions = nil;
+        _searchString = nil;
+    }
+    
+    [super searchBarCancelButtonClicked:sBar];
+}
+
 - (void)searchBar:(UISearchBar *)sbar textDidChange:(NSString *)searchText
 {
 	NSArray *resultsArray = nil;
     
+    if([sbar.text length] && self.searchesDataStore)
+    {
+        [self searchDataStoreForString:sbar.text];
+        return;
+    }
+    if(_searchFetchOptions)
+    {
+        [self.dataStore cancelAsynchronousFetchWithOptions:_searchFetchOptions];
+        _searchFetchOptions = nil;
+        _searchString = nil;
+    }
+    
 	if([sbar.text length] && self.items.count)
 	{
         NSString *safeSearchString = [self safeSearchStringFromString:sbar.text];
         
 		SCDataDefinition *objDef = [self.dataStore definitionForObject:[self.items objectAtIndex:0]]; // any object
-		if(!self.searchPropertyName)
-			self.searchPropertyName = objDef.titlePropertyName;
-		
-		NSArray *searchProperties;
-		if([self.searchPropertyName isEqualToString:@"*"])
-		{
-			searchProperties = [NSMutableArray arrayWithCapacity:objDef.propertyDefinitionCount];
-			for(NSUInteger i=0; i<objDef.propertyDefinitionCount; i++)
-				[(NSMutableArray *)searchProperties addObject:[objDef propertyDefinitionAtIndex:i].name];
-		}
-		else
-		{
-			searchProperties = [self.searchPropertyName componentsSeparatedByString:@";"];
-		}
+		NSArray *searchProperties = [self searchPropertyNamesForDefinition:objDef];
 
 		NSMutableString *predicateFormat = [NSMutableString string];
 		for(NSUInteger i=0; i<searchProperties.count; i++)
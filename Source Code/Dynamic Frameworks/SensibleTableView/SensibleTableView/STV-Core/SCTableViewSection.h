@@ -468,6 +468,7 @@
 {
 	//internal
     BOOL _isFetchingItems;
+    NSUInteger _totalItemCount;
     BOOL itemsInSync;
 	__weak SCTableViewModel *activeDetailModel;  // the current active detail model
 	NSMutableArray *cellReuseIdentifiers;
@@ -536,6 +537,10 @@
 /** This property is TRUE when the section is in a state of fetching its items from their dataStore. */
 @property (nonatomic, readonly) BOOL isFetchingItems;
 
+/** The total number of items in dataStore that match dataFetchOptions, regardless of how many batches have been fetched so far. The count is requested from the data store whenever the first batch is fetched, and is NSNotFound if the data store can't count its objects or the count hasn't arrived yet. Useful for displaying the total number of items in the section's header.
+ @note When available, the total count is used to decide whether fetchItemsCell should be displayed, instead of guessing from the size of the last fetched batch. */
+@property (nonatomic, readonly) NSUInteger totalItemCount;
+
 /** The accessory type of the generated cells. */
 @property (nonatomic, readwrite) UITableViewCellAccessoryType itemsAccessoryType;
 
@@ -623,6 +628,18 @@
 /** User can call this method to dispatch a RemoveRow event, the same event dispached when the end-user taps the delete button on a cell. */
 - (void)dispatchEventRemoveRowAtIndexPath:(NSIndexPath *)indexPath;
 
+/** User can call this method to remove several rows at once, typically the ones returned by indexPathsForSelectedItems. The items are deleted from dataStore in a single batch, and all the rows are removed in a single animated table update. Items rejected by the willDeleteItem action are skipped. */
+- (void)dispatchEventRemoveRowsAtIndexPaths:(NSArray *)indexPaths;
+
+/** User can call this method to set the same property values in the items of several rows at once, typically the ones returned by indexPathsForSelectedItems. The items are updated in dataStore in a single batch, and all the rows are reloaded in a single animated table update.
+ @param indexPaths The index paths of the rows to update.
+ @param propertyValues A dictionary of the new values, keyed by property name.
+ */
+- (void)dispatchEventUpdateRowsAtIndexPaths:(NSArray *)indexPaths withPropertyValues:(NSDictionary *)propertyValues;
+
+/** Returns the index paths of the section's item rows currently selected in the table view. Useful for bulk operations when the table view allows multiple selection during editing. */
+- (NSArray *)indexPathsForSelectedItems;
+
 //////////////////////////////////////////////////////////////////////////////////////////
 /// @name Internal Properties & Methods (should only be used by the framework or when subclassing)
 //////////////////////////////////////////////////////////////////////////////////////////
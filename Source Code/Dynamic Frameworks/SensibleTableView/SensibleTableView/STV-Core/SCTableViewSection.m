@@ -478,6 +478,9 @@
 
 - (void)setEditableStateForCell:(SCTableViewCell *)cell withPropertyDefinition:(SCPropertyDefinition *)propertyDefinition inEditingMode:(BOOL)editing;
 
+- (void)observeBoundObjectStore;
+- (void)boundObjectStoreDidChangeObjects:(NSNotification *)notification;
+
 @end
 
 
@@ -485,6 +488,11 @@
 
 @synthesize propertyGroup;
 
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
 + (instancetype)sectionWithHeaderTitle:(NSString *)sectionHeaderTitle boundObject:(NSObject *)object
 {
 	return [[[self class] alloc] initWithHeaderTitle:sectionHeaderTitle boundObject:object];
@@ -547,6 +555,7 @@
     {
         boundObject = object;
         boundObjectStore = store;
+        [self observeBoundObjectStore];
         
         if(!group)
         {
@@ -578,6 +587,7 @@
 - (void)setBoundObjectStore:(SCDataStore *)store
 {
     boundObjectStore = store;
+    [self observeBoundObjectStore];
     
     // Regenerate the cells
     [self generateCellsForEditingState:FALSE];
@@ -587,6 +597,7 @@
 {
     boundObject = boundObj;
     boundObjectStore = store;
+    [self observeBoundObjectStore];
     
     if(autoGenerateCells)
     {
@@ -605,6 +616,41 @@
     }
 }
 
+- (void)observeBoundObjectStore
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self name:SCDataStoreDidChangeObjectsNotification object:nil];
+    
+    if(boundObjectStore)
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(boundObjectStoreDidChangeObjects:) name:SCDataStoreDidChangeObjectsNotification object:boundObjectStore];
+}
+
+- (void)boundObjectStoreDidChangeObjects:(NSNotification *)notification
+{
+    NSArray *updatedObjects = [notification.userInfo valueForKey:SCDataStoreUpdatedObjectsKey];
+    if(!self.boundObject || [updatedObjects indexOfObjectIdenticalTo:self.boundObject]==NSNotFound)
+        return;
+    
+    // without the changed property names, any of the cells could be affected
+    NSSet *propertyNames = [notification.userInfo valueForKey:SCDataStoreUpdatedPropertyNamesKey];
+    
+    // only reload the affected cells in place, rather than the whole table
+    for(SCTableViewCell *cell in self.cells)
+    {
+        // cells being edited keep their value, which is committed later on
+        if(![cell isKindOfClass:[SCTableViewCell class]] || cell.needsCommit)
+            continue;
+        
+        BOOL affected = (propertyNames == nil);
+        if(!affected && cell.boundPropertyName)
+            affected = [propertyNames intersectsSet:[NSSet setWithArray:[cell.boundPropertyName componentsSeparatedByString:@";"]]];
+        if(!affected && [cell isKindOfClass:[SCCustomCell class]])
+            affected = [propertyNames intersectsSet:[NSSet setWithArray:[[(SCCustomCell *)cell objectBindings] allValues]]];
+        
+        if(affected)
+            [cell reloadBoundValue];
+    }
+}
+
 //overrides superclass
 - (void)setAttributesTo:(SCPropertyAttributes *)attributes
 {
@@ -1089,6 +1135,7 @@
                 }
                 
                 SCDataDefinition *boundObjDef = [boundObjStore definitionForObject:boundObj];
+                objectsStore.boundObjectStore = boundObjStore;
                 [objectsStore bindStoreToPropertyName:propertyName forObject:boundObj withDefinition:boundObjDef];
             }
             
@@ -1238,6 +1285,7 @@
 @synthesize dataFetchOptions;
 @synthesize autoFetchItems;
 @synthesize isFetchingItems = _isFetchingItems;
+@synthesize totalItemCount = _totalItemCount;
 @synthesize itemsAccessoryType;
 @synthesize allowAddingItems;
 @synthesize allowDeletingItems;
@@ -1269,6 +1317,7 @@
         dataFetchOptions = nil;  // will be re-initialized when dataStore is set
         
         _isFetchingItems = FALSE;
+        _totalItemCount = NSNotFound;
         itemsInSync = FALSE;
         autoFetchItems = TRUE;
         
@@ -1347,10 +1396,15 @@
 - (void)setDataStore:(SCDataStore *)__dataStore
 {
     [[NSNotificationCenter defaultCenter] removeObserver:self name:SCDataStoreWillDiscardAllUninsertedObjectsNotification object:dataStore];
+    [[NSNotificationCenter defaultCenter] removeObserver:self name:SCDataStoreDidChangeObjectsNotification object:dataStore];
+    [[NSNotificationCenter defaultCenter] removeObserver:self name:SCDataStoreDidFailCommitNotification object:dataStore];
+    [dataStore releaseSharedFetchResultsForConsumer:self];
     
     dataStore = __dataStore;
     // Register with store notifications
     [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(dataStoreWillDiscardUninsertedObjects) name:SCDataStoreWillDiscardAllUninsertedObjectsNotification object:dataStore];
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(dataStoreDidChangeObjects:) name:SCDataStoreDidChangeObjectsNotification object:dataStore];
+    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(dataStoreDidFailCommit:) name:SCDataStoreDidFailCommitNotification object:dataStore];
     
     if(!dataFetchOptions)
         dataFetchOptions = [__dataStore.defaultDataDefinition generateCompatibleDataFetchOptions];
@@ -1395,6 +1449,137 @@
     }
 }
 
+- (void)dataStoreDidFailCommit:(NSNotification *)notification
+{
+    // Sections generated by SCArrayOfItemsModel have their failures reported by their model
+    if(!self.autoFetchItems)
+        return;
+    
+    NSError *error = [notification.userInfo valueForKey:SCDataStoreErrorKey];
+    if(self.sectionActions.commitToStoreFailed)
+        self.sectionActions.commitToStoreFailed(self, error);
+    else
+        if(self.ownerTableViewModel.sectionActions.commitToStoreFailed)
+            self.ownerTableViewModel.sectionActions.commitToStoreFailed(self, error);
+}
+
+- (void)dataStoreDidChangeObjects:(NSNotification *)notification
+{
+    // Sections generated by SCArrayOfItemsModel don't fetch their own items and are refreshed by their model
+    if(!itemsInSync || !self.autoFetchItems)
+        return;
+    
+    NSArray *insertedObjects = [notification.userInfo valueForKey:SCDataStoreInsertedObjectsKey];
+    NSArray *updatedObjects = [notification.userInfo valueForKey:SCDataStoreUpdatedObjectsKey];
+    NSArray *deletedObjects = [notification.userInfo valueForKey:SCDataStoreDeletedObjectsKey];
+    NSArray *movedObjects = [notification.userInfo valueForKey:SCDataStoreMovedObjectsKey];
+    NSArray *fetchedObjects = [notification.userInfo valueForKey:SCDataStoreFetchedObjectsKey];
+    SCDataFetchOptions *fetchedObjectsOptions = [notification.userInfo valueForKey:SCDataStoreFetchOptionsKey];
+    if(fetchedObjects && fetchedObjectsOptions && fetchedObjectsOptions!=self.dataFetchOptions)
+        return;  // live results of another section
+    if(!insertedObjects.count && !updatedObjects.count && !deletedObjects.count && !movedObjects.count)
+        return;
+    
+    NSArray *oldItems = [NSArray arrayWithArray:self.mutableItems];
+    [self removeSpecialCellsFromItems];
+    
+    NSUInteger sectionIndex = [self.ownerTableViewModel indexForSection:self];
+    // updated objects that replaced the instances of already fetched items
+    NSMapTable *replacedItems = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality valueOptions:NSPointerFunctionsStrongMemory|NSPointerFunctionsObjectPointerPersonality];
+    
+    if(fetchedObjects)
+    {
+        NSNumber *batchStartIndex = [notification.userInfo valueForKey:SCDataStoreBatchStartIndexKey];
+        if(batchStartIndex)
+        {
+            // only one batch of the results, which replaces the items previously fetched for it
+            NSUInteger startIndex = MIN([batchStartIndex unsignedIntegerValue], self.mutableItems.count);
+            NSUInteger length = MIN(self.dataFetchOptions.batchSize, self.mutableItems.count-startIndex);
+            [self.mutableItems replaceObjectsInRange:NSMakeRange(startIndex, length) withObjectsFromArray:fetchedObjects];
+        }
+        else
+        {
+            // the store already knows the new ordered results
+            [SCDataStore applyFetchedObjectsInChanges:notification.userInfo toItems:self.mutableItems];
+            if(!fetchedObjectsOptions)
+            {
+                // all of the store's objects, so apply the section's own filter and order
+                if(self.dataFetchOptions.filter && self.dataFetchOptions.filterPredicate)
+                    [self.mutableItems filterUsingPredicate:self.dataFetchOptions.filterPredicate];
+                [self.dataFetchOptions sortMutableArray:self.mutableItems];
+            }
+            if(!self.dataFetchOptions.batchSize && _totalItemCount!=NSNotFound)
+                _totalItemCount = self.mutableItems.count;
+        }
+    }
+    else
+    {
+        // map object ids to the items already fetched
+        NSMutableDictionary *itemIndexesById = [NSMutableDictionary dictionary];
+        for(NSUInteger i=0; i<self.mutableItems.count; i++)
+        {
+            id objectId = [self.dataStore objectIdForObject:[self.mutableItems objectAtIndex:i]];
+            if(objectId)
+                [itemIndexesById setObject:[NSNumber numberWithUnsignedInteger:i] forKey:objectId];
+        }
+        NSUInteger (^indexOfObject)(NSObject *) = ^NSUInteger(NSObject *object)
+        {
+            id objectId = [self.dataStore objectIdForObject:object];
+            if(objectId)
+            {
+                NSNumber *index = [itemIndexesById objectForKey:objectId];
+                return index ? [index unsignedIntegerValue] : NSNotFound;
+            }
+            //else
+            return [self.mutableItems indexOfObjectIdenticalTo:object];
+        };
+        
+        for(NSObject *object in updatedObjects)
+        {
+            NSUInteger index = indexOfObject(object);
+            if(index == NSNotFound)
+                continue;
+            
+            NSObject *oldItem = [self.mutableItems objectAtIndex:index];
+            [self.mutableItems replaceObjectAtIndex:index withObject:object];
+            if(oldItem != object)
+                [replacedItems setObject:object forKey:oldItem];
+        }
+        NSMutableIndexSet *deletedIndexes = [NSMutableIndexSet indexSet];
+        for(NSObject *object in deletedObjects)
+        {
+            NSUInteger index = indexOfObject(object);
+            if(index != NSNotFound)
+                [deletedIndexes addIndex:index];
+        }
+        [self.mutableItems removeObjectsAtIndexes:deletedIndexes];
+        BOOL moreBatches = (self.dataFetchOptions.batchSize && [self fetchItemsCellExists]);
+        NSInteger insertedCount = 0;
+        for(NSObject *object in insertedObjects)
+        {
+            if(self.dataFetchOptions.filter && self.dataFetchOptions.filterPredicate && ![self.dataFetchOptions.filterPredicate evaluateWithObject:object])
+                continue;
+            
+            // already fetched objects are updated instead of duplicated
+            if([self.dataStore objectIdForObject:object] && indexOfObject(object)!=NSNotFound)
+                continue;
+            
+            insertedCount++;
+            
+            // inserted objects take their sorted position, unless it lies in a batch that hasn't been fetched yet
+            NSUInteger index = [self sortedInsertionIndexForItem:object];
+            if(index==self.mutableItems.count && moreBatches)
+                continue;
+            [self.mutableItems insertObject:object atIndex:index];
+        }
+        [self adjustTotalItemCountBy:insertedCount-(NSInteger)deletedIndexes.count];
+    }
+    
+    [self addSpecialCellsToItems];
+    
+    [self.ownerTableViewModel updateRowsFromSectionItems:[NSArray arrayWithObject:oldItems] toSectionItems:[NSArray arrayWithObject:self.mutableItems] firstSectionIndex:sectionIndex updatedObjects:updatedObjects movedObjects:movedObjects replacedItems:replacedItems];
+}
+
 - (void)setDataFetchOptions:(SCDataFetchOptions *)options
 {
     dataFetchOptions = options;
@@ -1496,6 +1681,8 @@
         if(self.dataFetchOptions.batchCurrentOffset == self.dataFetchOptions.batchStartingOffset)
         {
             [cells removeAllObjects];
+            
+            [self fetchTotalItemCount];
         }
     }
     
@@ -1503,7 +1690,7 @@
     {
         case SCStoreModeSynchronous:
         {
-            NSArray *array = [self.dataStore fetchObjectsWithOptions:self.dataFetchOptions];
+            NSArray *array = [self.dataStore fetchSharedObjectsWithOptions:self.dataFetchOptions forConsumer:self];
          
             [self didFetchItems:array sender:sender];
         }
@@ -1524,6 +1711,10 @@
                 }
             }
             
+            // only the latest fetch gets delivered
+            if(_isFetchingItems)
+                [self.dataStore cancelAsynchronousFetchWithOptions:self.dataFetchOptions];
+            
             _isFetchingItems = TRUE;
             [self.dataStore asynchronousFetchObjectsWithOptions:self.dataFetchOptions
             success:^(NSArray *results) 
@@ -1550,6 +1741,101 @@
     }
 }
 
+// Returns the index that keeps the items sorted according to dataFetchOptions if item is inserted at it, or the end of the items when they aren't sorted
+- (NSUInteger)sortedInsertionIndexForItem:(NSObject *)item
+{
+    if(!self.dataFetchOptions.sort || !self.dataFetchOptions.sortKey)
+        return self.mutableItems.count;
+    
+    NSArray *sortDescriptors = [self.dataFetchOptions sortDescriptors];
+    NSUInteger index;
+    @try
+    {
+        index = [self.mutableItems indexOfObject:item inSortedRange:NSMakeRange(0, self.mutableItems.count) options:NSBinarySearchingInsertionIndex|NSBinarySearchingLastEqual usingComparator:^NSComparisonResult(id obj1, id obj2)
+                 {
+                     for(NSSortDescriptor *descriptor in sortDescriptors)
+                     {
+                         NSComparisonResult result = [descriptor compareObject:obj1 toObject:obj2];
+                         if(result != NSOrderedSame)
+                             return result;
+                     }
+                     return NSOrderedSame;
+                 }];
+    }
+    @catch (NSException * e)
+    {
+        SCDebugLog(@"Warning: Invalid sort key: %@.", self.dataFetchOptions.sortKey);
+        index = self.mutableItems.count;
+    }
+    
+    return index;
+}
+
+// Keeps totalItemCount in step with the items inserted into or deleted from the data store after it was counted
+- (void)adjustTotalItemCountBy:(NSInteger)delta
+{
+    if(_totalItemCount == NSNotFound)
+        return;
+    
+    if(delta<0 && (NSUInteger)(-delta)>_totalItemCount)
+        _totalItemCount = 0;
+    else
+        _totalItemCount += delta;
+}
+
+- (void)fetchTotalItemCount
+{
+    _totalItemCount = NSNotFound;
+    
+    switch(self.dataStore.storeMode)
+    {
+        case SCStoreModeSynchronous:
+            _totalItemCount = [self.dataStore countObjectsWithOptions:self.dataFetchOptions];
+            break;
+            
+        case SCStoreModeAsynchronous:
+        {
+            SCDataFetchOptions *countedFetchOptions = self.dataFetchOptions;
+            __weak typeof(self) weak_self = self;
+            [self.dataStore asynchronousCountObjectsWithOptions:countedFetchOptions
+            success:^(NSUInteger count)
+             {
+                 if(weak_self.dataFetchOptions != countedFetchOptions)
+                     return;  // fetch options have changed since the count was requested
+                 
+                 [weak_self didFetchTotalItemCount:count];
+             }
+            failure:^(NSError *error)
+             {
+                 // batch end will be detected from the size of the fetched batches
+             }
+            noConnection:^BOOL()
+             {
+                 return NO;  // call failure_block
+             }];
+        }
+            break;
+    }
+}
+
+- (void)didFetchTotalItemCount:(NSUInteger)count
+{
+    _totalItemCount = count;
+    
+    // remove the fetchItemsCell if the items fetched so far turn out to be all the items
+    if(_isFetchingItems || !self.fetchItemsCell || [self fetchItemsCellExists])
+        return;
+    
+    NSUInteger fetchItemsCellIndex = [self.mutableItems indexOfObjectIdenticalTo:self.fetchItemsCell];
+    if(fetchItemsCellIndex == NSNotFound)
+        return;
+    
+    NSIndexPath *fetchItemsCellIndexPath = [self.ownerTableViewModel.tableView indexPathForCell:self.fetchItemsCell];
+    [self.mutableItems removeObjectAtIndex:fetchItemsCellIndex];
+    if(fetchItemsCellIndexPath)
+        [self.ownerTableViewModel.tableView deleteRowsAtIndexPaths:[NSArray arrayWithObject:fetchItemsCellIndexPath] withRowAnimation:UITableViewRowAnimationFade];
+}
+
 - (void)didFetchItems:(NSArray *)fetchedItems sender:(id)sender
 {
     NSMutableArray *mutableFetchedItems = [NSMutableArray arrayWithArray:fetchedItems];
@@ -1676,11 +1962,21 @@
     
     if(self.fetchItemsCell && self.dataFetchOptions.batchSize>0)
     {
-        if(!self.fetchItemsCell.autoHide 
-           || self.mutableItems.count==(self.dataFetchOptions.batchCurrentOffset*self.dataFetchOptions.batchSize))
+        if(!self.fetchItemsCell.autoHide)
         {
             exists = TRUE;
         }
+        else
+            if(_totalItemCount != NSNotFound)
+            {
+                // the store's count tells exactly whether more batches remain
+                exists = (self.dataFetchOptions.batchCurrentOffset*self.dataFetchOptions.batchSize < _totalItemCount);
+            }
+            else
+                if(self.mutableItems.count==(self.dataFetchOptions.batchCurrentOffset*self.dataFetchOptions.batchSize))
+                {
+                    exists = TRUE;
+                }
     }
     
     return exists;
@@ -2682,6 +2978,7 @@
             [self.dataStore asynchronousDeleteObject:object success:nil failure:nil noConnection:nil];
             break;
     }
+    [self adjustTotalItemCountBy:-1];
     
     [self.mutableItems removeObjectAtIndex:indexPath.row];
     if([self.ownerTableViewModel isKindOfClass:[SCArrayOfItemsModel class]])
@@ -2736,6 +3033,182 @@
     [self performSelector:@selector(callDelegateForDidRemoveRowAtIndexPath:) withObject:indexPath afterDelay:0.2f];
 }
 
+- (void)dispatchEventRemoveRowsAtIndexPaths:(NSArray *)indexPaths
+{
+    [self.ownerTableViewModel clearLastReturnedCellData];
+    
+    NSMutableIndexSet *itemIndexes = [NSMutableIndexSet indexSet];
+    NSMutableArray *deletedIndexPaths = [NSMutableArray array];
+    NSMutableArray *objects = [NSMutableArray array];
+    for(NSIndexPath *indexPath in [indexPaths sortedArrayUsingSelector:@selector(compare:)])
+    {
+        if(indexPath.row >= self.items.count || [itemIndexes containsIndex:indexPath.row])
+            continue;
+        
+        NSObject *object = [self.items objectAtIndex:indexPath.row];
+        if([object isKindOfClass:[SCTableViewCell class]])
+            continue;  // special cells aren't items
+        if(![self shouldDeleteItem:object atIndexPath:indexPath])
+            continue;
+        
+        [itemIndexes addIndex:indexPath.row];
+        [deletedIndexPaths addObject:indexPath];
+        [objects addObject:object];
+    }
+    if(!objects.count)
+        return;
+    
+    switch (self.dataStore.storeMode)
+    {
+        case SCStoreModeSynchronous:
+            [self.dataStore deleteObjects:objects];
+            break;
+            
+        case SCStoreModeAsynchronous:
+            [self.dataStore asynchronousDeleteObjects:objects success:nil failure:nil noConnection:nil];
+            break;
+    }
+    [self adjustTotalItemCountBy:-(NSInteger)objects.count];
+    
+    [self.mutableItems removeObjectsAtIndexes:itemIndexes];
+    if([self.ownerTableViewModel isKindOfClass:[SCArrayOfItemsModel class]])
+    {
+        // Notify the model of the item deletions
+        for(NSObject *object in objects)
+            [(SCArrayOfItemsModel *)self.ownerTableViewModel itemRemoved:object inSection:self];
+    }
+    
+    NSUInteger sectionIndex = [self.ownerTableViewModel indexForSection:self];
+    NSUInteger minCellCount = 0;
+    if([self addNewItemCellExists])
+        minCellCount = 1;
+    UITableViewRowAnimation deleteAnimation = UITableViewRowAnimationRight;
+    if(self.items.count==minCellCount && self.placeholderCell)
+        deleteAnimation = UITableViewRowAnimationNone;
+    [self.ownerTableViewModel.tableView beginUpdates];
+    [self.ownerTableViewModel.tableView deleteRowsAtIndexPaths:deletedIndexPaths withRowAnimation:deleteAnimation];
+    if(self.items.count==minCellCount && self.placeholderCell)
+    {
+        [self.mutableItems insertObject:self.placeholderCell atIndex:0];
+        
+        NSIndexPath *placeholderIndexPath = [NSIndexPath indexPathForRow:0 inSection:sectionIndex];
+        [self.ownerTableViewModel.tableView insertRowsAtIndexPaths:[NSArray arrayWithObject:placeholderIndexPath] withRowAnimation:UITableViewRowAnimationFade];
+    }
+    [self.ownerTableViewModel.tableView endUpdates];
+    
+    if(self.selectedCellIndexPath && [itemIndexes containsIndex:self.selectedCellIndexPath.row] && activeDetailModel)
+    {
+        if([activeDetailModel.viewController isKindOfClass:[SCViewController class]])
+        {
+            SCViewController *viewController = (SCViewController *)activeDetailModel.viewController;
+            if(viewController.hasFocus)
+                [viewController dismissWithCancelValue:YES doneValue:NO];
+        }
+        else
+            if([activeDetailModel.viewController isKindOfClass:[SCTableViewController class]])
+            {
+                SCTableViewController *viewController = (SCTableViewController *)activeDetailModel.viewController;
+                if(viewController.hasFocus)
+                    [viewController dismissWithCancelValue:YES doneValue:NO];
+            }
+        
+        [self setActiveDetailModel:nil];
+    }
+    self.selectedCellIndexPath = nil;
+    
+    // bottom up, so that every reported index is still valid when it gets reported
+    [itemIndexes enumerateIndexesWithOptions:NSEnumerationReverse usingBlock:^(NSUInteger index, BOOL *stop)
+     {
+         [self itemRemovedAtIndex:index];
+     }];
+    
+    // Allow some time for table view animations to finish
+    [self performSelector:@selector(callDelegateForDidRemoveRowsAtIndexPaths:) withObject:deletedIndexPaths afterDelay:0.2f];
+}
+
+- (void)dispatchEventUpdateRowsAtIndexPaths:(NSArray *)indexPaths withPropertyValues:(NSDictionary *)propertyValues
+{
+    [self.ownerTableViewModel clearLastReturnedCellData];
+    
+    NSMutableArray *updatedIndexPaths = [NSMutableArray array];
+    NSMutableArray *objects = [NSMutableArray array];
+    for(NSIndexPath *indexPath in indexPaths)
+    {
+        if(indexPath.row >= self.items.count)
+            continue;
+        
+        NSObject *object = [self.items objectAtIndex:indexPath.row];
+        if([object isKindOfClass:[SCTableViewCell class]] || [objects indexOfObjectIdenticalTo:object]!=NSNotFound)
+            continue;
+        
+        [updatedIndexPaths addObject:indexPath];
+        [objects addObject:object];
+    }
+    if(!objects.count)
+        return;
+    
+    NSUInteger sectionIndex = [self.ownerTableViewModel indexForSection:self];
+    void (^didUpdateItemsBlock)(void) = ^
+    {
+        for(NSUInteger i=0; i<objects.count; i++)
+            [self callDidUpdateItemActionWithItem:[objects objectAtIndex:i] atIndexPath:[updatedIndexPaths objectAtIndex:i]];
+        
+        [self.ownerTableViewModel.tableView beginUpdates];
+        [self.ownerTableViewModel.tableView reloadRowsAtIndexPaths:updatedIndexPaths withRowAnimation:UITableViewRowAnimationFade];
+        [self.ownerTableViewModel.tableView endUpdates];
+        
+        [self.ownerTableViewModel valueChangedForSectionAtIndex:sectionIndex];
+    };
+    
+    switch (self.dataStore.storeMode)
+    {
+        case SCStoreModeSynchronous:
+            [self.dataStore updateObjects:objects withPropertyValues:propertyValues];
+            didUpdateItemsBlock();
+            break;
+            
+        case SCStoreModeAsynchronous:
+            [self.dataStore asynchronousUpdateObjects:objects withPropertyValues:propertyValues
+            success:^()
+             {
+                 didUpdateItemsBlock();
+             }
+            failure:^(NSError *error)
+             {
+                 for(NSObject *item in objects)
+                 {
+                     if(self.sectionActions.updateItemFailed)
+                         self.sectionActions.updateItemFailed(self, item, error);
+                     else if(self.ownerTableViewModel.sectionActions.updateItemFailed)
+                         self.ownerTableViewModel.sectionActions.updateItemFailed(self, item, error);
+                 }
+             }
+            noConnection:^BOOL()
+             {
+                 return NO;  // call failure_block
+             }];
+            break;
+    }
+}
+
+- (NSArray *)indexPathsForSelectedItems
+{
+    NSUInteger sectionIndex = [self.ownerTableViewModel indexForSection:self];
+    
+    NSMutableArray *indexPaths = [NSMutableArray array];
+    for(NSIndexPath *indexPath in [self.ownerTableViewModel.tableView indexPathsForSelectedRows])
+    {
+        if(indexPath.section!=sectionIndex || indexPath.row>=self.items.count)
+            continue;
+        if([[self.items objectAtIndex:indexPath.row] isKindOfClass:[SCTableViewCell class]])
+            continue;
+        
+        [indexPaths addObject:indexPath];
+    }
+    
+    return indexPaths;
+}
+
 - (void)itemRemovedAtIndex:(NSInteger)index
 {
     // no implementation in base class
@@ -2754,6 +3227,12 @@
         }
 }
 
+- (void)callDelegateForDidRemoveRowsAtIndexPaths:(NSArray *)indexPaths
+{
+    for(NSIndexPath *indexPath in indexPaths)
+        [self callDelegateForDidRemoveRowAtIndexPath:indexPath];
+}
+
 - (NSIndexPath *)targetIndexPathForMoveFromCellAtIndexPath:(NSIndexPath *)sourceIndexPath toProposedIndexPath:(NSIndexPath *)proposedIndexPath
 {
     if(sourceIndexPath.section != proposedIndexPath.section)
@@ -2794,6 +3273,7 @@
                 [self.dataStore asynchronousDeleteObject:item success:nil failure:nil noConnection:nil];
                 break;
         }
+        [self adjustTotalItemCountBy:-1];
         
 		SCTableViewSection *toSection = [self.ownerTableViewModel sectionAtIndex:toIndexPath.section];
 		if([toSection isKindOfClass:[SCArrayOfItemsSection class]])
@@ -2908,6 +3388,7 @@
     if(![self itemPassesDataFetchFilter:newItem])
         return;
     
+    [self adjustTotalItemCountBy:1];
     
 	NSUInteger sectionIndex = [self.ownerTableViewModel indexForSection:self];
 	NSUInteger newItemIndex = [self.items indexOfObjectIdenticalTo:newItem];
@@ -24,6 +24,9 @@
 #import "SCDataStore.h"
 
 
+typedef void(^SCUserDefaultsStoreWritesFlushedAction_Block)(NSSet *propertyNames, BOOL succeeded);
+
+
 /****************************************************************************************/
 /*	class SCUserDefaultsStore	*/
 /****************************************************************************************/ 
@@ -39,4 +42,33 @@
 /** The user defaults object managed by the data store. */
 @property (nonatomic, readonly) NSUserDefaults *standardUserDefaultsObject;
 
+/** The time interval that must pass without any values being set through the store before the gathered values are written to disk using a single synchronize call. Each value set restarts the interval, so a burst of rapid edits is only written once it settles. Default: 0 (values are only written when commitData is called).
+ @note Values are always readable from standardUserDefaultsObject as soon as they're set. Only the disk write is delayed.
+ */
+@property (nonatomic, readwrite) NSTimeInterval writeCoalescingInterval;
+
+/** Action gets called on the main thread each time the gathered values have been written, with the names of the written properties and the result of synchronize. Typically used to wait for writes in tests.
+ 
+ Example:
+ 
+    // Objective-C
+    myUserDefaultsStore.writesFlushedAction = ^(NSSet *propertyNames, BOOL succeeded)
+    {
+        NSLog(@"Wrote %@", propertyNames);
+    };
+ 
+    // Swift
+    myUserDefaultsStore.writesFlushedAction =
+    {
+        (propertyNames, succeeded)->Void in
+ 
+        NSLog("Wrote %@", propertyNames)
+    }
+ 
+ */
+@property (nonatomic, copy) SCUserDefaultsStoreWritesFlushedAction_Block writesFlushedAction;
+
+/** Writes all the gathered values to disk in the background. Called by commitData, and automatically when the application enters the background (in which case the method waits for the write to finish). */
+- (void)flushPendingWrites;
+
 @end
@@ -22,9 +22,51 @@
 
 
 #import "SCUserDefaultsStore.h"
+#import "SCKeyValueWriteBuffer.h"
+
+
+@interface SCUserDefaultsStore ()
+{
+    SCKeyValueWriteBuffer *_writeBuffer;
+}
+
+@end
+
+
 
 @implementation SCUserDefaultsStore
 
+- (instancetype)init
+{
+    if( (self = [super init]) )
+    {
+        _writesFlushedAction = nil;
+        
+        NSUserDefaults *userDefaults = self.standardUserDefaultsObject;
+        _writeBuffer = [SCKeyValueWriteBuffer bufferWithLabel:@"com.sensiblecocoa.SCUserDefaultsStore.write" synchronizeBlock:^BOOL
+        {
+            return [userDefaults synchronize];
+        }];
+        __weak typeof(self) weak_self = self;
+        _writeBuffer.flushedAction = ^(NSSet *propertyNames, BOOL succeeded)
+        {
+            if(weak_self.writesFlushedAction)
+                weak_self.writesFlushedAction(propertyNames, succeeded);
+        };
+    }
+    return self;
+}
+
+- (NSTimeInterval)writeCoalescingInterval
+{
+    return _writeBuffer.debounceInterval;
+}
+
+- (void)setWriteCoalescingInterval:(NSTimeInterval)writeCoalescingInterval
+{
+    _writeBuffer.debounceInterval = writeCoalescingInterval;
+}
+
 - (NSUserDefaults *)standardUserDefaultsObject
 {
     return [NSUserDefaults standardUserDefaults];
@@ -50,10 +92,23 @@
     return [NSArray arrayWithObject:self.standardUserDefaultsObject];
 }
 
+// overrides superclass
+- (void)setValue:(NSObject *)value forPropertyName:(NSString *)propertyName inObject:(NSObject *)object
+{
+    [super setValue:value forPropertyName:propertyName inObject:object];
+    
+    [_writeBuffer addWriteForPropertyName:propertyName];
+}
+
+- (void)flushPendingWrites
+{
+    [_writeBuffer flush];
+}
+
 // overrides superclass
 - (void)commitData
 {
-    [self.standardUserDefaultsObject synchronize];
+    [self flushPendingWrites];
 }
 
 @end
@@ -34,7 +34,9 @@
 #import <SensibleTableView/SCUserDefaultsDefinition.h>
 
 #import <SensibleTableView/SCArrayStore.h>
+#import <SensibleTableView/SCCachingDataStore.h>
 #import <SensibleTableView/SCUserDefaultsStore.h>
+#import <SensibleTableView/SCKeyValueWriteBuffer.h>
 
 #import <SensibleTableView/SCTableViewModel.h>
 
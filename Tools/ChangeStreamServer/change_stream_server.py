@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Minimal Server-Sent Events fixture for SCWebServiceDefinition.changeStreamAPI.
+
+Generates a steady cycle of insert, update and delete changes to a small list
+of objects, and serves them as a text/event-stream that SCWebServiceStore's
+startObservingChanges can subscribe to. The current objects are also served as
+a JSON array, so that fetchObjectsAPI can point at the same server.
+
+Only the Python 3 standard library is required. See README.md for the matching
+SCWebServiceDefinition settings.
+"""
+
+import argparse
+import json
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+
+class ChangeLog:
+    """Generates the changes and keeps all of them, so that reconnecting clients can resume from Last-Event-ID."""
+
+    def __init__(self, max_objects):
+        self.max_objects = max_objects
+        self.condition = threading.Condition()
+        self.events = []  # (event id, change type, object)
+        self.objects = []
+        self.next_object_id = 1
+
+    def object_list(self):
+        with self.condition:
+            return [dict(obj) for obj in self.objects]
+
+    def events_after(self, event_id, timeout):
+        """Returns the events logged after event_id, waiting up to timeout seconds for one."""
+        with self.condition:
+            if len(self.events) <= event_id:
+                self.condition.wait(timeout)
+            return self.events[event_id:]
+
+    def generate_change(self):
+        with self.condition:
+            step = len(self.events) % 3
+            if step == 1 and self.objects:
+                obj = self.objects[len(self.events) % len(self.objects)]
+                obj['name'] = obj['name'].split(' (')[0] + ' (edited at %s)' % time.strftime('%H:%M:%S')
+                change = ('update', dict(obj))
+            elif step == 2 and len(self.objects) > self.max_objects:
+                change = ('delete', self.objects.pop(0))
+            else:
+                obj = {'id': self.next_object_id, 'name': 'Item %d' % self.next_object_id}
+                self.next_object_id += 1
+                self.objects.append(obj)
+                change = ('insert', dict(obj))
+
+            self.events.append((len(self.events) + 1,) + change)
+            self.condition.notify_all()
+            return self.events[-1]
+
+
+class ChangeStreamHandler(BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+
+    def do_GET(self):
+        path = self.path.split('?')[0]
+        if path == self.server.stream_path:
+            self.send_stream()
+        elif path == self.server.objects_path:
+            self.send_json(self.server.change_log.object_list())
+        else:
+            self.send_error(404)
+
+    def send_json(self, value):
+        body = json.dumps(value).encode('utf-8')
+        self.send_response(200)
+        self.send_header('Content-Type', 'application/json')
+        self.send_header('Content-Length', str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def send_stream(self):
+        try:
+            last_event_id = int(self.headers.get('Last-Event-ID', '0'))
+        except ValueError:
+            last_event_id = 0
+
+        self.send_response(200)
+        self.send_header('Content-Type', 'text/event-stream')
+        self.send_header('Cache-Control', 'no-cache')
+        self.send_header('Connection', 'close')
+        self.end_headers()
+        self.close_connection = True
+
+        options = self.server.options
+        try:
+            while True:
+                events = self.server.change_log.events_after(last_event_id, options.keep_alive)
+                if not events:
+                    # comment lines keep idle connections (and proxies) from timing out
+                    self.wfile.write(b': keep-alive\n\n')
+                for event_id, change_type, obj in events:
+                    data = {options.object_key: obj} if options.object_key else dict(obj)
+                    lines = ['id: %d' % event_id]
+                    if options.type_in_data:
+                        data[options.type_key] = change_type
+                    else:
+                        lines.append('event: %s' % change_type)
+                    lines.append('data: %s' % json.dumps(data))
+                    self.wfile.write(('\n'.join(lines) + '\n\n').encode('utf-8'))
+                    last_event_id = event_id
+                self.wfile.flush()
+        except (BrokenPipeError, ConnectionResetError):
+            pass
+
+    def log_message(self, format, *args):
+        if not self.server.options.quiet:
+            BaseHTTPRequestHandler.log_message(self, format, *args)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--host', default='127.0.0.1', help='address to listen on (default: %(default)s)')
+    parser.add_argument('--port', type=int, default=8080, help='port to listen on (default: %(default)s)')
+    parser.add_argument('--stream-path', default='/changes', help='path of the event stream (default: %(default)s)')
+    parser.add_argument('--objects-path', default='/objects', help='path of the JSON array of current objects (default: %(default)s)')
+    parser.add_argument('--interval', type=float, default=2.0, help='seconds between changes (default: %(default)s)')
+    parser.add_argument('--keep-alive', type=float, default=15.0, help='seconds between keep-alive comments on an idle stream (default: %(default)s)')
+    parser.add_argument('--max-objects', type=int, default=5, help='number of objects kept before deleting the oldest (default: %(default)s)')
+    parser.add_argument('--type-in-data', action='store_true', help="put the change type in the data under --type-key instead of the event's 'event' field")
+    parser.add_argument('--type-key', default='type', help='key of the change type for --type-in-data (changeTypeKeyName, default: %(default)s)')
+    parser.add_argument('--object-key', default=None, help='wrap the object in the data under this key (changeObjectKeyName, default: none)')
+    parser.add_argument('--quiet', action='store_true', help='do not log requests and changes')
+    options = parser.parse_args()
+
+    change_log = ChangeLog(options.max_objects)
+
+    def generate_changes():
+        while True:
+            time.sleep(options.interval)
+            event_id, change_type, obj = change_log.generate_change()
+            if not options.quiet:
+                print('event %d: %s %s' % (event_id, change_type, json.dumps(obj)), flush=True)
+
+    server = ThreadingHTTPServer((options.host, options.port), ChangeStreamHandler)
+    server.daemon_threads = True
+    server.options = options
+    server.change_log = change_log
+    server.stream_path = options.stream_path
+    server.objects_path = options.objects_path
+    threading.Thread(target=generate_changes, daemon=True).start()
+
+    print('Serving changes at http://%s:%d%s and objects at http://%s:%d%s' % (options.host, options.port, options.stream_path, options.host, options.port, options.objects_path), flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()